@@ -0,0 +1,196 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * GPU-side expansion of the chord diagram curves. Each instance is one entry of the draw list, i.e., an edge that was
+ * not culled and its alpha, in the order of the NanoVG backend. Its B-spline curve is evaluated per vertex with de
+ * Boor's algorithm on a clamped uniform knot vector (matching BSpline.cpp) and extruded to a triangle strip with a
+ * screen-space width. Only read-only storage buffers in the vertex stage are used, so no optional device
+ * features are required (e.g., for lavapipe).
+ */
+
+-- Vertex.Curve
+
+#version 450 core
+
+#define MAX_ORDER 8
+
+layout(std430, binding = 0) readonly buffer ControlPointBuffer {
+    vec2 controlPoints[]; //< Bundled (beta = 1) control polygons of all curves.
+};
+
+layout(std430, binding = 1) readonly buffer CurveBuffer {
+    uvec2 curves[]; //< (Index of first control point, number of control points) per curve.
+};
+
+struct CurveDraw {
+    uint curveIdx;
+    float alpha; //< Opacity times the edge weight, quantized like in the NanoVG backend.
+};
+
+layout(std430, binding = 2) readonly buffer CurveDrawBuffer {
+    CurveDraw curveDraws[]; //< Curves in drawing order; the selected curve comes last.
+};
+
+layout(push_constant) uniform PushConstants {
+    vec4 color; //< The alpha is multiplied with the alpha of the curve.
+    vec4 selectedColor;
+    vec2 center; //< In pixels.
+    vec2 viewportSize;
+    float radius; //< Chart radius in pixels.
+    float halfWidth; //< Half line width in pixels.
+    float beta;
+    int numSamples;
+    int maxOrder;
+    int selectedCurveIdx;
+};
+
+layout(location = 0) out float fragLineCoord;
+layout(location = 1) flat out float fragHalfWidth;
+layout(location = 2) flat out vec4 fragColor;
+
+float getKnot(int i, int k, int n) {
+    if (i <= k - 1) {
+        return 0.0;
+    }
+    if (i >= n) {
+        return 1.0;
+    }
+    return float(i - k + 1) / float(n - k + 1);
+}
+
+// Same straightening as HEBTree::getControlPoints.
+vec2 getControlPoint(uint first, int n, int i) {
+    vec2 p0 = controlPoints[first];
+    vec2 p1 = controlPoints[first + uint(n - 1)];
+    float t = float(i) / float(n - 1);
+    return beta * controlPoints[first + uint(i)] + (1.0 - beta) * mix(p0, p1, t);
+}
+
+void main() {
+    CurveDraw curveDraw = curveDraws[gl_InstanceIndex];
+    uvec2 curve = curves[curveDraw.curveIdx];
+    int n = int(curve.y);
+    if (n < 2) {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0); // Outside of the view volume.
+        return;
+    }
+    int k = min(n, min(maxOrder, MAX_ORDER));
+    int sampleIdx = gl_VertexIndex / 2;
+    float side = gl_VertexIndex % 2 == 0 ? -1.0 : 1.0;
+    float t = float(sampleIdx) / float(numSamples - 1);
+    int span = t >= 1.0 ? n - 1 : clamp(k - 1 + int(t * float(n - k + 1)), k - 1, n - 1);
+
+    // De Boor's algorithm; the tangent follows from the two points of the second to last level.
+    vec2 d[MAX_ORDER];
+    for (int j = 0; j < k; j++) {
+        d[j] = getControlPoint(curve.x, n, span - k + 1 + j);
+    }
+    vec2 tangent = vec2(1.0, 0.0);
+    for (int r = 1; r < k; r++) {
+        if (r == k - 1) {
+            tangent = d[k - 1] - d[k - 2];
+        }
+        for (int j = k - 1; j >= r; j--) {
+            int i = span - k + 1 + j;
+            float knotLower = getKnot(i, k, n);
+            float denominator = getKnot(i + k - r, k, n) - knotLower;
+            float alpha = denominator > 0.0 ? (t - knotLower) / denominator : 0.0;
+            d[j] = mix(d[j - 1], d[j], alpha);
+        }
+    }
+    vec2 normal = length(tangent) > 1e-12 ? normalize(vec2(-tangent.y, tangent.x)) : vec2(0.0, 1.0);
+
+    bool isSelected = int(curveDraw.curveIdx) == selectedCurveIdx;
+    fragHalfWidth = isSelected ? 2.0 * halfWidth : halfWidth;
+    fragColor = isSelected ? selectedColor : vec4(color.rgb, color.a * curveDraw.alpha);
+    // Extrude by one additional pixel for the anti-aliased fringe.
+    fragLineCoord = side * (fragHalfWidth + 1.0);
+    vec2 position = center + radius * d[k - 1] + fragLineCoord * normal;
+    gl_Position = vec4(position / viewportSize * 2.0 - vec2(1.0), 0.0, 1.0);
+}
+
+-- Fragment.Curve
+
+#version 450 core
+
+layout(location = 0) in float fragLineCoord;
+layout(location = 1) flat in float fragHalfWidth;
+layout(location = 2) flat in vec4 fragColor;
+layout(location = 0) out vec4 outputColor;
+
+void main() {
+    float coverage = clamp(fragHalfWidth + 0.5 - abs(fragLineCoord), 0.0, 1.0);
+    outputColor = vec4(fragColor.rgb, fragColor.a * coverage);
+}
+
+
+-- Vertex.Node
+
+#version 450 core
+
+layout(std430, binding = 0) readonly buffer NodePositionBuffer {
+    vec2 nodePositions[]; //< Normalized positions of the leaves.
+};
+
+layout(push_constant) uniform PushConstants {
+    vec4 color;
+    vec2 center;
+    vec2 viewportSize;
+    float radius;
+    float pointRadius;
+};
+
+layout(location = 0) out vec2 fragQuadCoord; //< In pixels relative to the node center.
+
+void main() {
+    vec2 corner = vec2(float(gl_VertexIndex % 2), float(gl_VertexIndex / 2)) * 2.0 - vec2(1.0);
+    fragQuadCoord = corner * (pointRadius + 1.0);
+    vec2 position = center + radius * nodePositions[gl_InstanceIndex] + fragQuadCoord;
+    gl_Position = vec4(position / viewportSize * 2.0 - vec2(1.0), 0.0, 1.0);
+}
+
+-- Fragment.Node
+
+#version 450 core
+
+layout(location = 0) in vec2 fragQuadCoord;
+layout(location = 0) out vec4 outputColor;
+
+layout(push_constant) uniform PushConstants {
+    vec4 color;
+    vec2 center;
+    vec2 viewportSize;
+    float radius;
+    float pointRadius;
+};
+
+void main() {
+    float coverage = clamp(pointRadius + 0.5 - length(fragQuadCoord), 0.0, 1.0);
+    outputColor = vec4(color.rgb, color.a * coverage);
+}
@@ -0,0 +1,349 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Headless benchmark of the CPU-side chord diagram pipeline (no window, no GPU). Each stage is timed over a matrix of
+ * node counts, subdivision counts and spline orders, and the results are written as JSON or CSV.
+ *
+ * Usage: DiagramBenchmark [--nodes 100,500,1000] [--subdivisions 16,50] [--orders 3,4] [--repetitions 3]
+ *                         [--branching-factor 4] [--format json|csv] [--output file]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ChordDiagramModel.hpp"
+#include "ChordDiagramLod.hpp"
+#include "DiagramSpatialIndex.hpp"
+#include "GraphFile.hpp"
+#include "ParallelFor.hpp"
+#include "RasterizerCpu.hpp"
+
+struct BenchmarkConfig {
+    std::vector<int> nodeCounts = { 100, 500, 1000 };
+    std::vector<int> subdivisionCounts = { 16, 50 };
+    std::vector<int> orders = { 3, 4 };
+    int repetitions = 3;
+    int branchingFactor = 4;
+    bool useCsv = false;
+    std::string outputPath;
+};
+
+struct BenchmarkResult {
+    std::string stage;
+    int numNodes = 0;
+    size_t numEdges = 0;
+    int numSubdivisions = 0;
+    int order = 0;
+    std::string simdLevel;
+    int numThreads = 0;
+    int repetitions = 0;
+    double minMs = 0.0, meanMs = 0.0, maxMs = 0.0;
+};
+
+static std::vector<int> parseIntList(const char* str) {
+    std::vector<int> values;
+    std::stringstream stream(str);
+    std::string token;
+    while (std::getline(stream, token, ',')) {
+        if (!token.empty()) {
+            values.push_back(std::stoi(token));
+        }
+    }
+    return values;
+}
+
+static bool parseArguments(int argc, char* argv[], BenchmarkConfig& config) {
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--nodes") == 0 && hasValue) {
+            config.nodeCounts = parseIntList(argv[++i]);
+        } else if (strcmp(argv[i], "--subdivisions") == 0 && hasValue) {
+            config.subdivisionCounts = parseIntList(argv[++i]);
+        } else if (strcmp(argv[i], "--orders") == 0 && hasValue) {
+            config.orders = parseIntList(argv[++i]);
+        } else if (strcmp(argv[i], "--repetitions") == 0 && hasValue) {
+            config.repetitions = std::max(std::stoi(argv[++i]), 1);
+        } else if (strcmp(argv[i], "--branching-factor") == 0 && hasValue) {
+            config.branchingFactor = std::max(std::stoi(argv[++i]), 2);
+        } else if (strcmp(argv[i], "--format") == 0 && hasValue) {
+            config.useCsv = strcmp(argv[++i], "csv") == 0;
+        } else if (strcmp(argv[i], "--output") == 0 && hasValue) {
+            config.outputPath = argv[++i];
+        } else {
+            std::cerr << "Unknown or incomplete argument: " << argv[i] << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Brute-force nearest curve search within a pixel radius; the baseline for @see DiagramSpatialIndex.
+static int hitTestBruteForce(const ChordDiagramModel& model, glm::vec2 queryPx, float radiusPx, float maxDistPx) {
+    const std::vector<glm::vec2>& curvePoints = model.getCurvePoints();
+    const std::vector<uint32_t>& curveOffsets = model.getCurveOffsets();
+    int closestLineIdx = -1;
+    float closestDist = maxDistPx;
+    for (int lineIdx = 0; lineIdx < model.getNumLines(); lineIdx++) {
+        for (uint32_t ptIdx = curveOffsets[lineIdx] + 1; ptIdx < curveOffsets[lineIdx + 1]; ptIdx++) {
+            glm::vec2 p0 = curvePoints[ptIdx - 1] * radiusPx;
+            glm::vec2 p1 = curvePoints[ptIdx] * radiusPx;
+            glm::vec2 d = p1 - p0;
+            float lengthSq = d.x * d.x + d.y * d.y;
+            float t = lengthSq > 0.0f ? std::clamp(
+                    ((queryPx.x - p0.x) * d.x + (queryPx.y - p0.y) * d.y) / lengthSq, 0.0f, 1.0f) : 0.0f;
+            glm::vec2 diff = queryPx - (p0 + t * d);
+            float dist = std::sqrt(diff.x * diff.x + diff.y * diff.y);
+            if (dist < closestDist) {
+                closestDist = dist;
+                closestLineIdx = lineIdx;
+            }
+        }
+    }
+    return closestLineIdx;
+}
+
+template<class Func>
+static BenchmarkResult timeStage(const std::string& stage, int repetitions, const Func& func) {
+    BenchmarkResult result;
+    result.stage = stage;
+    result.repetitions = repetitions;
+    result.minMs = std::numeric_limits<double>::max();
+    double sumMs = 0.0;
+    for (int rep = 0; rep < repetitions; rep++) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        result.minMs = std::min(result.minMs, ms);
+        result.maxMs = std::max(result.maxMs, ms);
+        sumMs += ms;
+    }
+    result.meanMs = sumMs / double(repetitions);
+    return result;
+}
+
+static void writeResults(std::ostream& out, const std::vector<BenchmarkResult>& results, bool useCsv) {
+    if (useCsv) {
+        out << "stage,nodes,edges,subdivisions,order,simd,threads,repetitions,min_ms,mean_ms,max_ms\n";
+        for (const auto& r : results) {
+            out << r.stage << "," << r.numNodes << "," << r.numEdges << "," << r.numSubdivisions << ","
+                << r.order << "," << r.simdLevel << "," << r.numThreads << "," << r.repetitions << ","
+                << r.minMs << "," << r.meanMs << "," << r.maxMs << "\n";
+        }
+    } else {
+        out << "[\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const auto& r = results[i];
+            out << "  { \"stage\": \"" << r.stage << "\", \"nodes\": " << r.numNodes << ", \"edges\": " << r.numEdges
+                << ", \"subdivisions\": " << r.numSubdivisions << ", \"order\": " << r.order
+                << ", \"simd\": \"" << r.simdLevel << "\", \"threads\": " << r.numThreads
+                << ", \"repetitions\": " << r.repetitions << ", \"min_ms\": " << r.minMs
+                << ", \"mean_ms\": " << r.meanMs << ", \"max_ms\": " << r.maxMs << " }"
+                << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "]\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkConfig config;
+    if (!parseArguments(argc, argv, config)) {
+        return 1;
+    }
+
+    const float beta = 0.75f;
+    const float radiusPx = 500.0f;
+    const int numHitTestQueries = 16;
+    const int numThreads = getMaxNumParallelThreads();
+    const SimdLevel bestSimdLevel = getBestSupportedSimdLevel();
+    std::vector<BenchmarkResult> results;
+    double checksum = 0.0;
+
+    for (int numNodes : config.nodeCounts) {
+        ChordDiagramModel model;
+        model.setBeta(beta);
+        auto addResult = [&](BenchmarkResult result, int numSubdivisions, int order, SimdLevel simdLevel) {
+            result.numNodes = numNodes;
+            result.numEdges = model.getEdges().size();
+            result.numSubdivisions = numSubdivisions;
+            result.order = order;
+            result.simdLevel = SIMD_LEVEL_NAMES[int(simdLevel)];
+            result.numThreads = numThreads;
+            results.push_back(result);
+            std::cerr << result.stage << " nodes=" << numNodes << " subdivisions=" << numSubdivisions
+                      << " order=" << order << ": " << result.meanMs << " ms" << std::endl;
+        };
+
+        addResult(timeStage("hierarchy", config.repetitions, [&] {
+            model.buildRadialHierarchy(numNodes, config.branchingFactor);
+        }), 0, 0, SimdLevel::SCALAR);
+        std::vector<std::pair<uint32_t, uint32_t>> edgeList;
+        edgeList.reserve(size_t(numNodes) * size_t(numNodes - 1) / 2);
+        for (int i = 0; i < numNodes; i++) {
+            for (int j = i + 1; j < numNodes; j++) {
+                edgeList.emplace_back(uint32_t(i), uint32_t(j));
+            }
+        }
+        addResult(timeStage("edges", config.repetitions, [&] {
+            model.setEdges(edgeList);
+        }), 0, 0, SimdLevel::SCALAR);
+        // Same edges streamed from packed records, like the graph file loader does; the resulting model is identical.
+        std::vector<GraphFileEdge> edgeRecords(edgeList.size());
+        for (size_t edgeIdx = 0; edgeIdx < edgeList.size(); edgeIdx++) {
+            edgeRecords[edgeIdx] = { edgeList[edgeIdx].first, edgeList[edgeIdx].second, 1.0f };
+        }
+        addResult(timeStage("edges_records", config.repetitions, [&] {
+            model.setEdgesFromRecords(
+                    reinterpret_cast<const uint8_t*>(edgeRecords.data()), edgeRecords.size(), sizeof(GraphFileEdge));
+        }), 0, 0, SimdLevel::SCALAR);
+        ChordDiagramLod lod;
+        addResult(timeStage("lod_build", config.repetitions, [&] {
+            lod.build(model, 64);
+            lod.getModel().tessellate(radiusPx);
+        }), 0, 0, SimdLevel::SCALAR);
+        checksum += double(lod.getNumSuperEdges());
+
+        for (int order : config.orders) {
+            model.setSplineOrder(order);
+
+            // Adaptive flattening with the beta blend cache, i.e., the default configuration of the diagram.
+            model.setUseAdaptiveSubdivision(true);
+            model.setUseBetaBlendCache(true);
+            model.setSimdLevel(bestSimdLevel);
+            addResult(timeStage("tessellation_adaptive", config.repetitions, [&] {
+                model.tessellate(radiusPx);
+            }), 0, order, bestSimdLevel);
+            checksum += double(model.getCurvePoints().size());
+
+            // Software rasterization of all curves into an image just containing the chart.
+            const std::vector<glm::vec2>& adaptiveCurvePoints = model.getCurvePoints();
+            const std::vector<uint32_t>& curveOffsets = model.getCurveOffsets();
+            const int imageSize = int(2.0f * radiusPx) + 16;
+            const glm::vec2 center(0.5f * float(imageSize));
+            std::vector<glm::vec2> screenPoints(adaptiveCurvePoints.size());
+            for (size_t ptIdx = 0; ptIdx < adaptiveCurvePoints.size(); ptIdx++) {
+                screenPoints[ptIdx] = center + adaptiveCurvePoints[ptIdx] * radiusPx;
+            }
+            std::vector<uint8_t> image(size_t(imageSize) * size_t(imageSize) * 4);
+            RasterizerCpu rasterizer;
+            for (SimdLevel simdLevel : { SimdLevel::SCALAR, bestSimdLevel }) {
+                rasterizer.setSimdLevel(simdLevel);
+                addResult(timeStage(
+                        simdLevel == SimdLevel::SCALAR ? "raster_cpu_scalar" : "raster_cpu", config.repetitions, [&] {
+                    rasterizer.beginFrame(imageSize, imageSize, 1.0f);
+                    for (int lineIdx = 0; lineIdx < model.getNumLines(); lineIdx++) {
+                        uint32_t offsetStart = curveOffsets[lineIdx];
+                        rasterizer.strokePolyline(
+                                screenPoints.data() + offsetStart, curveOffsets[lineIdx + 1] - offsetStart, 1.0f,
+                                glm::vec4(0.4f, 1.0f, 0.4f, 0.1f));
+                    }
+                    rasterizer.render(image.data());
+                }), 0, order, simdLevel);
+                if (bestSimdLevel == SimdLevel::SCALAR) {
+                    break;
+                }
+            }
+            checksum += double(image[image.size() / 2]);
+
+            int betaStep = 0;
+            addResult(timeStage("beta_blend", config.repetitions, [&] {
+                model.setBeta(betaStep++ % 2 == 0 ? 0.25f : beta);
+            }), 0, order, bestSimdLevel);
+            model.setBeta(beta);
+
+            // Uniform subdivision evaluated with the SIMD kernels.
+            model.setUseAdaptiveSubdivision(false);
+            model.setUseBetaBlendCache(false);
+            for (int numSubdivisions : config.subdivisionCounts) {
+                model.setNumSubdivisions(numSubdivisions);
+                for (SimdLevel simdLevel : { SimdLevel::SCALAR, bestSimdLevel }) {
+                    model.setSimdLevel(simdLevel);
+                    addResult(timeStage(
+                            simdLevel == SimdLevel::SCALAR ? "tessellation_scalar" : "tessellation",
+                            config.repetitions, [&] {
+                        model.tessellate(radiusPx);
+                    }), numSubdivisions, order, simdLevel);
+                    if (bestSimdLevel == SimdLevel::SCALAR) {
+                        break;
+                    }
+                }
+                const std::vector<glm::vec2>& curvePoints = model.getCurvePoints();
+                if (!curvePoints.empty()) {
+                    checksum += double(curvePoints[curvePoints.size() / 2].x);
+                }
+
+                DiagramSpatialIndex spatialIndex;
+                addResult(timeStage("spatial_index_build", config.repetitions, [&] {
+                    spatialIndex.rebuild(model);
+                }), numSubdivisions, order, SimdLevel::SCALAR);
+
+                // Both hit tests and all repetitions use the same query points, so their timings are comparable.
+                std::mt19937 generator(17);
+                std::uniform_real_distribution<float> distribution(-radiusPx, radiusPx);
+                std::vector<glm::vec2> queryPoints(numHitTestQueries);
+                for (glm::vec2& queryPx : queryPoints) {
+                    queryPx.x = distribution(generator);
+                    queryPx.y = distribution(generator);
+                }
+                addResult(timeStage("hittest", config.repetitions, [&] {
+                    for (const glm::vec2& queryPx : queryPoints) {
+                        checksum += double(spatialIndex.findNearestCurve(model, queryPx / radiusPx, 4.0f / radiusPx));
+                    }
+                }), numSubdivisions, order, SimdLevel::SCALAR);
+                addResult(timeStage("hittest_bruteforce", config.repetitions, [&] {
+                    for (const glm::vec2& queryPx : queryPoints) {
+                        checksum += double(hitTestBruteForce(model, queryPx, radiusPx, 4.0f));
+                    }
+                }), numSubdivisions, order, SimdLevel::SCALAR);
+            }
+        }
+    }
+
+    if (config.outputPath.empty()) {
+        writeResults(std::cout, results, config.useCsv);
+    } else {
+        std::ofstream file(config.outputPath);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open output file \"" << config.outputPath << "\"." << std::endl;
+            return 1;
+        }
+        writeResults(file, results, config.useCsv);
+    }
+    std::cerr << "Checksum: " << checksum << std::endl;
+    return 0;
+}
@@ -0,0 +1,579 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Headless batch export of chord diagram images (no window, no GPU). All images are rendered with the tiled CPU
+ * rasterizer in one process, so starting a process per image is avoided. The jobs are pipelined in three stages:
+ * - Geometry: The model of the next job is built (or reused if the dataset is the same) and tessellated on a
+ *   separate thread while the current job is rasterized.
+ * - Rasterization: One image at a time, using all cores.
+ * - Encoding: A pool of worker threads encodes and writes the finished images. The number of images waiting for
+ *   encoding is bounded, which limits the memory usage if encoding is slower than rendering.
+ *
+ * Usage: DiagramExport --jobs jobs.txt [options]
+ *        DiagramExport --datasets complete:100,random:1000:50000 --sizes 1920x1080,3840x2160 [--format png|exr]
+ *                      [--output-dir dir] [options]
+ *        DiagramExport --import-csv edges.csv graph.hebg [--csv-separator c|tab] [--csv-no-header]
+ * Options: [--encoder-threads n] [--scale s] [--bright] [--curve-thickness t] [--curve-opacity o]
+ *
+ * Job files contain one job per line, "<dataset> <width>x<height> <output file>"; empty lines and lines starting
+ * with # are skipped. The format of the output file follows its extension (.png or .exr). The datasets are
+ * - complete:<numNodes>: All pairs of nodes, i.e., the test diagram of the interactive application.
+ * - random:<numNodes>:<numEdges>[:<seed>]: Random pairs of nodes with random weights in (0, 1].
+ * - file:<path>: A graph file (see GraphFile.hpp), e.g., converted from a CSV edge list with --import-csv. The import
+ *   runs before the jobs, so both can be combined in one call.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ChordDiagramModel.hpp"
+#include "GraphFile.hpp"
+#include "ImageEncoder.hpp"
+#include "RasterizerCpu.hpp"
+
+struct ExportJob {
+    std::string dataset;
+    int width = 0, height = 0;
+    std::string outputPath;
+};
+
+/// Appearance of the diagrams; the defaults match the diagram of the interactive application.
+struct ExportSettings {
+    float scale = 1.0f; //< Pixels per logical unit, i.e., the UI scale factor.
+    bool isDarkMode = true;
+    float curveThickness = 1.5f;
+    float curveOpacity = 0.1f;
+    float beta = 0.75f;
+    int branchingFactor = 4;
+    int numEncoderThreads = std::max(int(std::thread::hardware_concurrency()) / 2, 1);
+};
+
+struct ExportConfig {
+    std::string jobsPath;
+    std::vector<std::string> datasets;
+    std::vector<std::pair<int, int>> sizes;
+    ImageFileFormat format = ImageFileFormat::PNG;
+    std::string outputDirectory = ".";
+    ExportSettings settings;
+    std::string csvImportPath, csvImportGraphPath;
+    CsvImportSettings csvImportSettings;
+};
+
+static std::vector<std::string> splitString(const std::string& str, char separator) {
+    std::vector<std::string> tokens;
+    std::stringstream stream(str);
+    std::string token;
+    while (std::getline(stream, token, separator)) {
+        if (!token.empty()) {
+            tokens.push_back(token);
+        }
+    }
+    return tokens;
+}
+
+static bool parseSize(const std::string& str, int& width, int& height) {
+    size_t separatorPos = str.find('x');
+    if (separatorPos == std::string::npos) {
+        return false;
+    }
+    width = std::atoi(str.substr(0, separatorPos).c_str());
+    height = std::atoi(str.substr(separatorPos + 1).c_str());
+    return width > 0 && height > 0;
+}
+
+static bool parseArguments(int argc, char* argv[], ExportConfig& config) {
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--jobs") == 0 && hasValue) {
+            config.jobsPath = argv[++i];
+        } else if (strcmp(argv[i], "--datasets") == 0 && hasValue) {
+            config.datasets = splitString(argv[++i], ',');
+        } else if (strcmp(argv[i], "--sizes") == 0 && hasValue) {
+            for (const std::string& sizeString : splitString(argv[++i], ',')) {
+                int width, height;
+                if (!parseSize(sizeString, width, height)) {
+                    std::cerr << "Invalid image size: " << sizeString << std::endl;
+                    return false;
+                }
+                config.sizes.emplace_back(width, height);
+            }
+        } else if (strcmp(argv[i], "--format") == 0 && hasValue) {
+            config.format = strcmp(argv[++i], "exr") == 0 ? ImageFileFormat::EXR : ImageFileFormat::PNG;
+        } else if (strcmp(argv[i], "--output-dir") == 0 && hasValue) {
+            config.outputDirectory = argv[++i];
+        } else if (strcmp(argv[i], "--encoder-threads") == 0 && hasValue) {
+            config.settings.numEncoderThreads = std::max(std::atoi(argv[++i]), 1);
+        } else if (strcmp(argv[i], "--scale") == 0 && hasValue) {
+            config.settings.scale = std::max(float(std::atof(argv[++i])), 0.01f);
+        } else if (strcmp(argv[i], "--bright") == 0) {
+            config.settings.isDarkMode = false;
+        } else if (strcmp(argv[i], "--curve-thickness") == 0 && hasValue) {
+            config.settings.curveThickness = std::max(float(std::atof(argv[++i])), 0.0f);
+        } else if (strcmp(argv[i], "--curve-opacity") == 0 && hasValue) {
+            config.settings.curveOpacity = std::clamp(float(std::atof(argv[++i])), 0.0f, 1.0f);
+        } else if (strcmp(argv[i], "--import-csv") == 0 && i + 2 < argc) {
+            config.csvImportPath = argv[++i];
+            config.csvImportGraphPath = argv[++i];
+        } else if (strcmp(argv[i], "--csv-separator") == 0 && hasValue) {
+            i++;
+            config.csvImportSettings.separator = strcmp(argv[i], "tab") == 0 ? '\t' : argv[i][0];
+        } else if (strcmp(argv[i], "--csv-no-header") == 0) {
+            config.csvImportSettings.hasHeader = false;
+        } else {
+            std::cerr << "Unknown or incomplete argument: " << argv[i] << std::endl;
+            return false;
+        }
+    }
+    if (config.csvImportPath.empty() && config.jobsPath.empty() && (config.datasets.empty() || config.sizes.empty())) {
+        std::cerr << "Either --import-csv, --jobs, or --datasets and --sizes need to be passed." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static std::vector<ExportJob> loadJobs(const std::string& jobsPath) {
+    std::ifstream file(jobsPath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Error in loadJobs: Could not open \"" + jobsPath + "\".");
+    }
+    std::vector<ExportJob> jobs;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::istringstream lineStream(line);
+        std::string dataset, sizeString;
+        if (!(lineStream >> dataset) || dataset[0] == '#') {
+            continue;
+        }
+        ExportJob job;
+        job.dataset = dataset;
+        if (!(lineStream >> sizeString >> job.outputPath) || !parseSize(sizeString, job.width, job.height)) {
+            throw std::runtime_error(
+                    "Error in loadJobs: Invalid job in line " + std::to_string(lineNumber) + " of \"" + jobsPath
+                    + "\".");
+        }
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+/**
+ * All combinations of datasets and sizes, named <dataset>_<width>x<height> with ':' replaced by '_'. Graph files are
+ * named after the file name without extension.
+ */
+static std::vector<ExportJob> createJobs(const ExportConfig& config) {
+    std::vector<ExportJob> jobs;
+    for (const std::string& dataset : config.datasets) {
+        std::string name = dataset;
+        if (dataset.rfind("file:", 0) == 0) {
+            name = std::filesystem::path(dataset.substr(5)).stem().string();
+        }
+        std::replace(name.begin(), name.end(), ':', '_');
+        for (const auto& size : config.sizes) {
+            ExportJob job;
+            job.dataset = dataset;
+            job.width = size.first;
+            job.height = size.second;
+            job.outputPath = (std::filesystem::path(config.outputDirectory) / (
+                    name + "_" + std::to_string(size.first) + "x" + std::to_string(size.second)
+                    + IMAGE_FILE_FORMAT_EXTENSIONS[int(config.format)])).string();
+            jobs.push_back(job);
+        }
+    }
+    return jobs;
+}
+
+static std::shared_ptr<ChordDiagramModel> buildDatasetModel(
+        const std::string& dataset, const ExportSettings& settings) {
+    // Checked before splitting, as paths may contain ':'.
+    if (dataset.rfind("file:", 0) == 0) {
+        auto model = std::make_shared<ChordDiagramModel>();
+        model->setBeta(settings.beta);
+        GraphFile graphFile(dataset.substr(5));
+        graphFile.loadIntoModel(*model, settings.branchingFactor);
+        return model;
+    }
+
+    std::vector<std::string> parts = splitString(dataset, ':');
+    auto getIntPart = [&](size_t partIdx, int defaultValue) {
+        return partIdx < parts.size() ? std::atoi(parts[partIdx].c_str()) : defaultValue;
+    };
+    int numNodes = getIntPart(1, 0);
+    if (parts.empty() || numNodes < 2) {
+        throw std::runtime_error("Error in buildDatasetModel: Invalid dataset \"" + dataset + "\".");
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> edgeList;
+    std::vector<float> weights;
+    if (parts[0] == "complete") {
+        edgeList.reserve(size_t(numNodes) * size_t(numNodes - 1) / 2);
+        for (int i = 0; i < numNodes; i++) {
+            for (int j = i + 1; j < numNodes; j++) {
+                edgeList.emplace_back(uint32_t(i), uint32_t(j));
+            }
+        }
+    } else if (parts[0] == "random" && parts.size() >= 3) {
+        int numEdges = std::max(getIntPart(2, 0), 0);
+        std::mt19937 generator(uint32_t(getIntPart(3, 0)));
+        std::uniform_int_distribution<uint32_t> nodeDistribution(0, uint32_t(numNodes - 1));
+        std::uniform_real_distribution<float> weightDistribution(0.0f, 1.0f);
+        edgeList.reserve(size_t(numEdges));
+        weights.reserve(size_t(numEdges));
+        while (int(edgeList.size()) < numEdges) {
+            uint32_t nodeIdx0 = nodeDistribution(generator), nodeIdx1 = nodeDistribution(generator);
+            if (nodeIdx0 != nodeIdx1) {
+                edgeList.emplace_back(nodeIdx0, nodeIdx1);
+                weights.push_back(1.0f - weightDistribution(generator));
+            }
+        }
+    } else {
+        throw std::runtime_error("Error in buildDatasetModel: Unknown dataset \"" + dataset + "\".");
+    }
+
+    auto model = std::make_shared<ChordDiagramModel>();
+    model->setBeta(settings.beta);
+    model->buildRadialHierarchy(numNodes, settings.branchingFactor);
+    model->setEdges(edgeList, weights);
+    return model;
+}
+
+/// Output of the geometry stage; everything the rasterization stage reads, so it does not access the model.
+struct DiagramGeometry {
+    const ExportJob* job = nullptr;
+    float windowWidth = 0.0f, windowHeight = 0.0f; //< In logical units.
+    float chartRadius = 0.0f;
+    std::vector<glm::vec2> curvePoints; //< In logical units.
+    std::vector<uint32_t> curveOffsets;
+    std::vector<uint32_t> curveDrawOrder; //< Culled lines are left out.
+    std::vector<float> curveAlphas; //< Per line.
+    std::vector<glm::vec2> leafPositions; //< In logical units.
+};
+
+/// Geometry stage; the model of the previous job is reused if the dataset is the same.
+class GeometryStage {
+public:
+    explicit GeometryStage(const ExportSettings& _settings) : settings(_settings) {}
+    std::unique_ptr<DiagramGeometry> prepare(const ExportJob& job);
+
+private:
+    const ExportSettings& settings;
+    std::string modelDataset;
+    std::shared_ptr<ChordDiagramModel> model;
+};
+
+std::unique_ptr<DiagramGeometry> GeometryStage::prepare(const ExportJob& job) {
+    if (!model || modelDataset != job.dataset) {
+        model = buildDatasetModel(job.dataset, settings);
+        modelDataset = job.dataset;
+    }
+
+    // Same layout as DiagramBase::computeChartRadius, including the space of the outer ring.
+    auto geometry = std::make_unique<DiagramGeometry>();
+    geometry->job = &job;
+    geometry->windowWidth = float(job.width) / settings.scale;
+    geometry->windowHeight = float(job.height) / settings.scale;
+    float borderSize = geometry->windowWidth < 360.0f || geometry->windowHeight < 360.0f
+            ? 10.0f : std::min(geometry->windowWidth, geometry->windowHeight) / 36.0f;
+    float minDim = std::min(geometry->windowWidth, geometry->windowHeight) - 2.0f * borderSize;
+    geometry->chartRadius = std::round(0.5f * minDim) * 0.9f;
+    float radiusPx = geometry->chartRadius * settings.scale;
+    if (model->getNeedsTessellation(radiusPx)) {
+        model->tessellate(radiusPx);
+    }
+
+    const std::vector<glm::vec2>& modelCurvePoints = model->getCurvePoints();
+    const glm::vec2 center(0.5f * geometry->windowWidth, 0.5f * geometry->windowHeight);
+    geometry->curvePoints.resize(modelCurvePoints.size());
+    for (size_t ptIdx = 0; ptIdx < modelCurvePoints.size(); ptIdx++) {
+        geometry->curvePoints[ptIdx] = center + modelCurvePoints[ptIdx] * geometry->chartRadius;
+    }
+    geometry->curveOffsets = model->getCurveOffsets();
+
+    // Importance order and culling of DiagramBase::updateCurveDrawOrder, and the alpha of DiagramBase::getCurveAlpha.
+    const std::vector<HEBEdge>& edges = model->getEdges();
+    const float alphaCullThreshold = 0.5f / 255.0f;
+    float maxAlphaContribution = settings.curveOpacity * std::min(settings.curveThickness * settings.scale, 1.0f);
+    float minWeight = maxAlphaContribution > 0.0f
+            ? alphaCullThreshold / maxAlphaContribution : std::numeric_limits<float>::infinity();
+    geometry->curveAlphas.resize(edges.size());
+    for (size_t lineIdx = 0; lineIdx < edges.size(); lineIdx++) {
+        geometry->curveAlphas[lineIdx] =
+                float(std::clamp(int(std::ceil(settings.curveOpacity * edges[lineIdx].weight * 255.0f)), 0, 255))
+                / 255.0f;
+        if (edges[lineIdx].weight >= minWeight) {
+            geometry->curveDrawOrder.push_back(uint32_t(lineIdx));
+        }
+    }
+    std::stable_sort(
+            geometry->curveDrawOrder.begin(), geometry->curveDrawOrder.end(),
+            [&edges](uint32_t lineIdx0, uint32_t lineIdx1) { return edges[lineIdx0].weight > edges[lineIdx1].weight; });
+
+    const std::vector<HEBNode>& nodes = model->getNodes();
+    for (size_t nodeIdx = model->getLeafIdxOffset(); nodeIdx < nodes.size(); nodeIdx++) {
+        geometry->leafPositions.push_back(center + nodes[nodeIdx].normalizedPosition * geometry->chartRadius);
+    }
+    return geometry;
+}
+
+/// Draws the diagram like DiagramBase::renderBaseRasterCpu without a selection.
+static void rasterizeDiagram(
+        const DiagramGeometry& geometry, const ExportSettings& settings, RasterizerCpu& rasterizer,
+        std::vector<uint8_t>& image) {
+    const ExportJob& job = *geometry.job;
+    rasterizer.beginFrame(job.width, job.height, settings.scale);
+
+    const float borderWidth = 1.0f, borderRoundingRadius = 4.0f;
+    glm::vec4 backgroundFillColor = settings.isDarkMode
+            ? glm::vec4(20.0f / 255.0f, 20.0f / 255.0f, 20.0f / 255.0f, 1.0f)
+            : glm::vec4(245.0f / 255.0f, 245.0f / 255.0f, 245.0f / 255.0f, 1.0f);
+    glm::vec4 backgroundStrokeColor = settings.isDarkMode
+            ? glm::vec4(60.0f / 255.0f, 60.0f / 255.0f, 60.0f / 255.0f, 1.0f)
+            : glm::vec4(190.0f / 255.0f, 190.0f / 255.0f, 190.0f / 255.0f, 1.0f);
+    rasterizer.drawRoundedRect(
+            glm::vec2(borderWidth, borderWidth),
+            glm::vec2(geometry.windowWidth - borderWidth, geometry.windowHeight - borderWidth), borderRoundingRadius,
+            backgroundFillColor, backgroundStrokeColor, 1.0f);
+
+    for (uint32_t lineIdx : geometry.curveDrawOrder) {
+        uint32_t offsetStart = geometry.curveOffsets[lineIdx];
+        rasterizer.strokePolyline(
+                geometry.curvePoints.data() + offsetStart, geometry.curveOffsets[lineIdx + 1] - offsetStart,
+                settings.curveThickness,
+                glm::vec4(100.0f / 255.0f, 1.0f, 100.0f / 255.0f, geometry.curveAlphas[lineIdx]));
+    }
+
+    const float pointRadius = settings.curveThickness * 1.5f;
+    const glm::vec4 circleColor(180.0f / 255.0f, 180.0f / 255.0f, 180.0f / 255.0f, 1.0f);
+    for (const glm::vec2& leafPosition : geometry.leafPositions) {
+        rasterizer.fillCircle(leafPosition, pointRadius, circleColor);
+    }
+
+    image.resize(size_t(job.width) * size_t(job.height) * 4);
+    rasterizer.render(image.data());
+}
+
+/// Pool of threads encoding and writing the finished images.
+class ImageEncoderPool {
+public:
+    struct Task {
+        std::string outputPath;
+        int width = 0, height = 0;
+        std::vector<uint8_t> image;
+    };
+
+    ImageEncoderPool(int numThreads, size_t _maxQueuedTasks);
+    ~ImageEncoderPool();
+    /// Queues the task; blocks while the maximum number of tasks is waiting.
+    void push(Task task);
+    /// Waits until all images are written and returns the number of failed ones.
+    int finish();
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable cvTask; //< Notified on new tasks and when finishing.
+    std::condition_variable cvSpace; //< Notified when a task was taken from the queue.
+    std::deque<Task> tasks;
+    size_t maxQueuedTasks;
+    bool isFinishing = false;
+    std::atomic<int> numFailed{};
+};
+
+ImageEncoderPool::ImageEncoderPool(int numThreads, size_t _maxQueuedTasks) : maxQueuedTasks(_maxQueuedTasks) {
+    for (int threadIdx = 0; threadIdx < numThreads; threadIdx++) {
+        workers.emplace_back(&ImageEncoderPool::workerLoop, this);
+    }
+}
+
+ImageEncoderPool::~ImageEncoderPool() {
+    finish();
+}
+
+void ImageEncoderPool::push(Task task) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cvSpace.wait(lock, [this] { return tasks.size() < maxQueuedTasks; });
+    tasks.push_back(std::move(task));
+    lock.unlock();
+    cvTask.notify_one();
+}
+
+int ImageEncoderPool::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isFinishing = true;
+    }
+    cvTask.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    return numFailed;
+}
+
+void ImageEncoderPool::workerLoop() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cvTask.wait(lock, [this] { return isFinishing || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        cvSpace.notify_one();
+        try {
+            writeImageFile(
+                    task.outputPath, getImageFileFormatFromPath(task.outputPath), task.width, task.height,
+                    task.image.data());
+        } catch (const std::exception& exception) {
+            std::cerr << exception.what() << std::endl;
+            numFailed++;
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    ExportConfig config;
+    if (!parseArguments(argc, argv, config)) {
+        return 1;
+    }
+    if (!config.csvImportPath.empty()) {
+        try {
+            auto importStartTime = std::chrono::steady_clock::now();
+            CsvImportStatistics statistics = importCsvGraph(
+                    config.csvImportPath, config.csvImportGraphPath, config.csvImportSettings);
+            double importMs = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - importStartTime).count();
+            std::cerr << "Imported " << statistics.numNodes << " nodes and " << statistics.numEdges << " edges ("
+                      << statistics.numSelfLoops << " self-loops skipped) to " << config.csvImportGraphPath
+                      << " in " << importMs << " ms." << std::endl;
+        } catch (const std::exception& exception) {
+            std::cerr << exception.what() << std::endl;
+            return 1;
+        }
+        if (config.jobsPath.empty() && (config.datasets.empty() || config.sizes.empty())) {
+            return 0;
+        }
+    }
+
+    std::vector<ExportJob> jobs;
+    try {
+        if (config.jobsPath.empty()) {
+            std::filesystem::create_directories(config.outputDirectory);
+            jobs = createJobs(config);
+        } else {
+            jobs = loadJobs(config.jobsPath);
+        }
+    } catch (const std::exception& exception) {
+        std::cerr << exception.what() << std::endl;
+        return 1;
+    }
+
+    const ExportSettings& settings = config.settings;
+    auto startTime = std::chrono::steady_clock::now();
+    double geometryWaitMs = 0.0, rasterizeMs = 0.0, encodeWaitMs = 0.0;
+    int numFailed = 0;
+    {
+        GeometryStage geometryStage(settings);
+        auto prepareAsync = [&](size_t jobIdx) {
+            return std::async(std::launch::async, [&geometryStage, &jobs, jobIdx] {
+                return geometryStage.prepare(jobs[jobIdx]);
+            });
+        };
+        // Two images per encoder thread can wait, so the encoders do not starve while the next image is rasterized.
+        ImageEncoderPool encoderPool(settings.numEncoderThreads, size_t(settings.numEncoderThreads) * 2);
+        RasterizerCpu rasterizer;
+        std::future<std::unique_ptr<DiagramGeometry>> nextGeometry;
+        if (!jobs.empty()) {
+            nextGeometry = prepareAsync(0);
+        }
+        for (size_t jobIdx = 0; jobIdx < jobs.size(); jobIdx++) {
+            auto time0 = std::chrono::steady_clock::now();
+            std::unique_ptr<DiagramGeometry> geometry;
+            try {
+                geometry = nextGeometry.get();
+            } catch (const std::exception& exception) {
+                std::cerr << exception.what() << std::endl;
+                numFailed++;
+            }
+            // The geometry stage only touches its model, so the next job can be prepared while this one is drawn.
+            if (jobIdx + 1 < jobs.size()) {
+                nextGeometry = prepareAsync(jobIdx + 1);
+            }
+            if (!geometry) {
+                continue;
+            }
+
+            auto time1 = std::chrono::steady_clock::now();
+            ImageEncoderPool::Task task;
+            task.outputPath = jobs[jobIdx].outputPath;
+            task.width = jobs[jobIdx].width;
+            task.height = jobs[jobIdx].height;
+            rasterizeDiagram(*geometry, settings, rasterizer, task.image);
+            auto time2 = std::chrono::steady_clock::now();
+            encoderPool.push(std::move(task));
+            auto time3 = std::chrono::steady_clock::now();
+
+            geometryWaitMs += std::chrono::duration<double, std::milli>(time1 - time0).count();
+            rasterizeMs += std::chrono::duration<double, std::milli>(time2 - time1).count();
+            encodeWaitMs += std::chrono::duration<double, std::milli>(time3 - time2).count();
+        }
+        numFailed += encoderPool.finish();
+    }
+    double totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    int numExported = int(jobs.size()) - numFailed;
+    std::cerr << "Exported " << numExported << " of " << jobs.size() << " images in " << totalSeconds << " s ("
+              << double(numExported) / std::max(totalSeconds, 1e-9) << " images/s)." << std::endl;
+    std::cerr << "Waiting for geometry: " << geometryWaitMs << " ms, rasterization: " << rasterizeMs
+              << " ms, waiting for encoders: " << encodeWaitMs << " ms." << std::endl;
+    return numFailed == 0 ? 0 : 1;
+}
@@ -26,53 +26,230 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+#include <cmath>
+
 #include "BSpline.hpp"
 
-static float B(int i, int k, float x, const std::vector<float>& t) {
-    if (k == 1) {
-        if (t[i] <= x && x < t[i + 1]) {
-            return 1;
-        } else {
-            return 0;
+/// Returns the i-th knot of the clamped uniform knot vector of order k with n control points.
+static inline float getClampedUniformKnot(int i, int k, int numControlPoints) {
+    int numMiddle = numControlPoints - k + 2;
+    if (i <= k - 1) {
+        return 0.0f;
+    }
+    if (i >= numControlPoints) {
+        return 1.0f;
+    }
+    return float(i - k + 1) / float(numMiddle - 1);
+}
+
+static inline int findSpanClampedUniform(float x, int k, int numControlPoints) {
+    // The inner knots are uniformly spaced, so the span can be computed directly instead of via binary search.
+    int numSegments = numControlPoints - k + 1;
+    if (x >= 1.0f) {
+        return numControlPoints - 1;
+    }
+    if (x <= 0.0f) {
+        return k - 1;
+    }
+    int span = k - 1 + int(x * float(numSegments));
+    return std::clamp(span, k - 1, numControlPoints - 1);
+}
+
+/**
+ * Non-recursive evaluation of the k non-zero basis functions (The NURBS Book, algorithm A2.2).
+ * left and right are scratch arrays of size k.
+ */
+template<class KnotFunc>
+static inline void evaluateBasisFunctions(
+        float x, int span, int k, const KnotFunc& knot, float* basisValues, float* left, float* right) {
+    basisValues[0] = 1.0f;
+    for (int j = 1; j < k; j++) {
+        left[j] = x - knot(span + 1 - j);
+        right[j] = knot(span + j) - x;
+        float saved = 0.0f;
+        for (int r = 0; r < j; r++) {
+            float denom = right[r + 1] + left[j - r];
+            float temp = denom > 1e-6f ? basisValues[r] / denom : 0.0f;
+            basisValues[r] = saved + right[r + 1] * temp;
+            saved = left[j - r] * temp;
         }
+        basisValues[j] = saved;
+    }
+}
+
+/// Calls func(basisValues, left, right) with scratch arrays of size k that are not allocated per call.
+template<class Func>
+static inline auto withBasisScratch(int k, const Func& func) {
+    if (k <= BSPLINE_MAX_STACK_ORDER) {
+        float basisValues[BSPLINE_MAX_STACK_ORDER];
+        float left[BSPLINE_MAX_STACK_ORDER];
+        float right[BSPLINE_MAX_STACK_ORDER];
+        return func(basisValues, left, right);
     } else {
-        float left;
-        float denomLeft = t[i + k - 1] - t[i];
-        if (denomLeft > 1e-6f) {
-            left = (x - t[i]) / denomLeft * B(i, k - 1, x, t);
-        } else {
-            left = 0.0f;
-        }
-        float right;
-        float denomRight = t[i + k] - t[i + 1];
-        if (denomRight > 1e-6f) {
-            right = (t[i + k] - x) / denomRight * B(i + 1, k - 1, x, t);
-        } else {
-            right = 0.0f;
+        thread_local std::vector<float> scratch;
+        if (int(scratch.size()) < 3 * k) {
+            scratch.resize(3 * k);
         }
-        return left + right;
+        return func(scratch.data(), scratch.data() + k, scratch.data() + 2 * k);
+    }
+}
+
+BSplineKnotVector::BSplineKnotVector(int k, int numControlPoints) {
+    setup(k, numControlPoints);
+}
+
+void BSplineKnotVector::setup(int _k, int _numControlPoints) {
+    k = _k;
+    numControlPoints = _numControlPoints;
+    knots.resize(k + numControlPoints);
+    for (int i = 0; i < k + numControlPoints; i++) {
+        knots[i] = getClampedUniformKnot(i, k, numControlPoints);
     }
 }
 
+int BSplineKnotVector::findSpan(float x) const {
+    return findSpanClampedUniform(x, k, numControlPoints);
+}
+
+void BSplineKnotVector::evaluateBasis(float x, int span, float* basisValues) const {
+    const float* t = knots.data();
+    auto knot = [t](int i) { return t[i]; };
+    withBasisScratch(k, [&](float*, float* left, float* right) {
+        evaluateBasisFunctions(x, span, k, knot, basisValues, left, right);
+        return 0;
+    });
+}
+
 glm::vec2 evaluateBSpline(float x, int k, const std::vector<glm::vec2>& controlPoints) {
     auto numControlPoints = int(controlPoints.size());
-    std::vector<float> t(k + numControlPoints);
-    for (int i = 0; i < k - 1; i++) {
-        t[i] = 0.0f;
-        t[int(t.size()) - i - 1] = 1.0f;
+    auto knot = [k, numControlPoints](int i) { return getClampedUniformKnot(i, k, numControlPoints); };
+    int span = findSpanClampedUniform(x, k, numControlPoints);
+    return withBasisScratch(k, [&](float* basisValues, float* left, float* right) {
+        evaluateBasisFunctions(x, span, k, knot, basisValues, left, right);
+        glm::vec2 sum(0.0f);
+        const glm::vec2* pts = controlPoints.data() + span - k + 1;
+        for (int j = 0; j < k; j++) {
+            sum.x += basisValues[j] * pts[j].x;
+            sum.y += basisValues[j] * pts[j].y;
+        }
+        return sum;
+    });
+}
+
+glm::vec2 evaluateBSpline(float x, const BSplineKnotVector& knotVector, const glm::vec2* controlPoints) {
+    int k = knotVector.getOrder();
+    const float* t = knotVector.getKnots().data();
+    auto knot = [t](int i) { return t[i]; };
+    int span = knotVector.findSpan(x);
+    return withBasisScratch(k, [&](float* basisValues, float* left, float* right) {
+        evaluateBasisFunctions(x, span, k, knot, basisValues, left, right);
+        glm::vec2 sum(0.0f);
+        const glm::vec2* pts = controlPoints + span - k + 1;
+        for (int j = 0; j < k; j++) {
+            sum.x += basisValues[j] * pts[j].x;
+            sum.y += basisValues[j] * pts[j].y;
+        }
+        return sum;
+    });
+}
+
+float computeBSplineSecondDerivativeBound(const BSplineKnotVector& knotVector, const glm::vec2* controlPoints) {
+    const int k = knotVector.getOrder();
+    const int numControlPoints = knotVector.getNumControlPoints();
+    const int degree = k - 1;
+    if (degree < 2 || numControlPoints < 3) {
+        return 0.0f;
     }
-    int numMiddle = numControlPoints - k + 2;
-    for (int i = 0; i < numMiddle; i++) {
-        t[i + k - 1] = float(i) / float(numMiddle - 1);
+    const float* t = knotVector.getKnots().data();
+    auto derivativeControlPoint = [&](int i) {
+        float denom = t[i + degree + 1] - t[i + 1];
+        return denom > 1e-6f ? float(degree) * (controlPoints[i + 1] - controlPoints[i]) / denom : glm::vec2(0.0f);
+    };
+    float maxNorm = 0.0f;
+    glm::vec2 d1Prev = derivativeControlPoint(0);
+    for (int i = 0; i < numControlPoints - 2; i++) {
+        glm::vec2 d1Next = derivativeControlPoint(i + 1);
+        float denom = t[i + degree + 1] - t[i + 2];
+        if (denom > 1e-6f) {
+            glm::vec2 d2 = float(degree - 1) * (d1Next - d1Prev) / denom;
+            maxNorm = std::max(maxNorm, std::sqrt(d2.x * d2.x + d2.y * d2.y));
+        }
+        d1Prev = d1Next;
     }
-    if (x == 1) {
-        x -= 1e-5f;
+    return maxNorm;
+}
+
+int getNumFlatteningSegments(float secondDerivativeBound, float tolerance, int maxNumSegments) {
+    if (secondDerivativeBound <= 0.0f || tolerance <= 0.0f) {
+        return 1;
     }
-    glm::vec2 sum(0.0f);
-    for (int i = 0; i < numControlPoints; i++) {
-        float B_val = B(i, k, x, t);
-        sum.x += B_val * controlPoints[i].x;
-        sum.y += B_val * controlPoints[i].y;
+    float numSegments = std::ceil(std::sqrt(secondDerivativeBound / (8.0f * tolerance)));
+    return std::clamp(int(std::min(numSegments, float(maxNumSegments))), 1, maxNumSegments);
+}
+
+BSplineBasisTable::BSplineBasisTable(int k, int numControlPoints, int numSamples) {
+    setup(k, numControlPoints, numSamples);
+}
+
+bool BSplineBasisTable::matches(int _k, int _numControlPoints, int _numSamples) const {
+    return k == _k && numControlPoints == _numControlPoints && numSamples == _numSamples;
+}
+
+void BSplineBasisTable::setup(int _k, int _numControlPoints, int _numSamples) {
+    k = _k;
+    numControlPoints = _numControlPoints;
+    numSamples = _numSamples;
+    weights.clear();
+    weights.resize(size_t(numSamples) * size_t(numControlPoints), 0.0f);
+    firstNonZeroColumns.resize(numSamples);
+
+    BSplineKnotVector knotVector(k, numControlPoints);
+    for (int sampleIdx = 0; sampleIdx < numSamples; sampleIdx++) {
+        float x = numSamples > 1 ? float(sampleIdx) / float(numSamples - 1) : 0.0f;
+        int span = knotVector.findSpan(x);
+        int firstColumn = span - k + 1;
+        float* row = weights.data() + size_t(sampleIdx) * size_t(numControlPoints);
+        knotVector.evaluateBasis(x, span, row + firstColumn);
+        firstNonZeroColumns[sampleIdx] = firstColumn;
+    }
+}
+
+const BSplineBasisTable& BSplineBasisTableCache::getOrCreate(int k, int numControlPoints, int numSamples) {
+    auto it = tables.find(getKey(k, numControlPoints, numSamples));
+    if (it != tables.end()) {
+        return it->second;
+    }
+    return tables.emplace(
+            getKey(k, numControlPoints, numSamples),
+            BSplineBasisTable(k, numControlPoints, numSamples)).first->second;
+}
+
+const BSplineBasisTable* BSplineBasisTableCache::get(int k, int numControlPoints, int numSamples) const {
+    auto it = tables.find(getKey(k, numControlPoints, numSamples));
+    return it != tables.end() ? &it->second : nullptr;
+}
+
+void evaluateBSplineCurves(
+        const BSplineBasisTable& basisTable, const glm::vec2* controlPoints, int numCurves, glm::vec2* curvePoints) {
+    const int k = basisTable.getOrder();
+    const int numControlPoints = basisTable.getNumControlPoints();
+    const int numSamples = basisTable.getNumSamples();
+    const float* weights = basisTable.getWeights();
+    const int* firstNonZeroColumns = basisTable.getFirstNonZeroColumns();
+    for (int curveIdx = 0; curveIdx < numCurves; curveIdx++) {
+        const glm::vec2* pts = controlPoints + size_t(curveIdx) * size_t(numControlPoints);
+        glm::vec2* out = curvePoints + size_t(curveIdx) * size_t(numSamples);
+        for (int sampleIdx = 0; sampleIdx < numSamples; sampleIdx++) {
+            int firstColumn = firstNonZeroColumns[sampleIdx];
+            const float* row = weights + size_t(sampleIdx) * size_t(numControlPoints) + firstColumn;
+            const glm::vec2* rowPts = pts + firstColumn;
+            glm::vec2 sum(0.0f);
+            for (int j = 0; j < k; j++) {
+                sum.x += row[j] * rowPts[j].x;
+                sum.y += row[j] * rowPts[j].y;
+            }
+            out[sampleIdx] = sum;
+        }
     }
-    return sum;
 }
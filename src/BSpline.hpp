@@ -29,9 +29,50 @@
 #ifndef CORRERENDER_BSPLINE_HPP
 #define CORRERENDER_BSPLINE_HPP
 
+#include <cstdint>
 #include <vector>
+#include <unordered_map>
 #include <glm/vec2.hpp>
 
+/// Orders up to this value use scratch memory on the stack; higher orders use a thread-local buffer.
+const int BSPLINE_MAX_STACK_ORDER = 16;
+
+/**
+ * Clamped uniform knot vector of a B-spline curve of order k with n control points, e.g.,
+ * [0, 0, 0, 0.5, 1, 1, 1], [0, 0, 0, 0, 1, 1, 1, 1], etc.
+ * The knot vector only depends on (k, n) and can thus be shared by all curves with the same order and number of
+ * control points.
+ */
+class BSplineKnotVector {
+public:
+    BSplineKnotVector() = default;
+    BSplineKnotVector(int k, int numControlPoints);
+    void setup(int k, int numControlPoints);
+
+    [[nodiscard]] inline int getOrder() const { return k; }
+    [[nodiscard]] inline int getNumControlPoints() const { return numControlPoints; }
+    [[nodiscard]] inline const std::vector<float>& getKnots() const { return knots; }
+
+    /**
+     * Returns the knot span index i with t[i] <= x < t[i + 1] and k - 1 <= i <= n - 1.
+     * Only the control points with indices i - k + 1, ..., i contribute to the curve at x.
+     */
+    [[nodiscard]] int findSpan(float x) const;
+
+    /**
+     * Computes the k basis function values that are non-zero at x using the triangular Cox-de Boor scheme.
+     * @param x The parameter value in range [0, 1].
+     * @param span The knot span returned by @see findSpan.
+     * @param basisValues Output array of size k. basisValues[j] belongs to the control point span - k + 1 + j.
+     */
+    void evaluateBasis(float x, int span, float* basisValues) const;
+
+private:
+    int k = 0;
+    int numControlPoints = 0;
+    std::vector<float> knots;
+};
+
 /**
  * Evaluates a B-spline curve with the passed control points at parameter x.
  * A knot vector is used such that the curve passes through the start and end point, e.g.,
@@ -47,7 +88,97 @@
  *   https://web.mit.edu/hyperbook/Patrikalakis-Maekawa-Cho/node17.html
  *   https://web.mit.edu/hyperbook/Patrikalakis-Maekawa-Cho/node18.html
  * - https://www.cs.cmu.edu/afs/cs/academic/class/15456-f15/Handouts/CAGD-chapter8.pdf
+ * - L. Piegl, W. Tiller: The NURBS Book, 2nd ed., algorithms A2.1 and A2.2.
  */
 glm::vec2 evaluateBSpline(float x, int k, const std::vector<glm::vec2>& controlPoints);
 
+/**
+ * Evaluates a B-spline curve using a precomputed knot vector. Only the k control points in the knot span of x are
+ * accessed, and no memory is allocated for orders up to BSPLINE_MAX_STACK_ORDER.
+ * @param x The parameter value in range [0, 1] along the B-spline curve to evaluate.
+ * @param knotVector The knot vector. Its number of control points must match the size of controlPoints.
+ * @param controlPoints Pointer to knotVector.getNumControlPoints() control points.
+ * @return The evaluated point location.
+ */
+glm::vec2 evaluateBSpline(float x, const BSplineKnotVector& knotVector, const glm::vec2* controlPoints);
+
+/**
+ * Returns an upper bound of |C''(x)| over x in [0, 1] for the B-spline curve C with the passed control points.
+ * The bound is the maximum norm of the control points of the second derivative curve, which is a B-spline curve of
+ * order k - 2 (convex hull property). For k < 3, zero is returned.
+ * @param knotVector The knot vector of the curve.
+ * @param controlPoints Pointer to knotVector.getNumControlPoints() control points.
+ */
+float computeBSplineSecondDerivativeBound(const BSplineKnotVector& knotVector, const glm::vec2* controlPoints);
+
+/**
+ * Returns the number of uniform parameter segments necessary such that the polyline through the segment end points
+ * deviates at most by tolerance from the curve. For a curve with |C''| <= secondDerivativeBound, the deviation of a
+ * chord over a parameter interval of length h is bounded by secondDerivativeBound * h^2 / 8.
+ */
+int getNumFlatteningSegments(float secondDerivativeBound, float tolerance, int maxNumSegments);
+
+/**
+ * Table of basis function values for numSamples uniformly spaced parameters x_s = s / (numSamples - 1) of B-spline
+ * curves with order k and n control points. As all curves with the same (k, n, numSamples) share the same table,
+ * evaluating a curve reduces to the small matrix product (numSamples x n) * (n x 2).
+ * The table is stored densely in row-major order; for each row, only the k entries starting at the first non-zero
+ * column need to be visited.
+ */
+class BSplineBasisTable {
+public:
+    BSplineBasisTable() = default;
+    BSplineBasisTable(int k, int numControlPoints, int numSamples);
+    void setup(int k, int numControlPoints, int numSamples);
+    [[nodiscard]] bool matches(int k, int numControlPoints, int numSamples) const;
+
+    [[nodiscard]] inline int getOrder() const { return k; }
+    [[nodiscard]] inline int getNumControlPoints() const { return numControlPoints; }
+    [[nodiscard]] inline int getNumSamples() const { return numSamples; }
+    /// Dense (numSamples x numControlPoints) weight matrix.
+    [[nodiscard]] inline const float* getWeights() const { return weights.data(); }
+    /// Index of the first non-zero column of each row.
+    [[nodiscard]] inline const int* getFirstNonZeroColumns() const { return firstNonZeroColumns.data(); }
+
+private:
+    int k = 0;
+    int numControlPoints = 0;
+    int numSamples = 0;
+    std::vector<float> weights;
+    std::vector<int> firstNonZeroColumns;
+};
+
+/**
+ * Cache of basis tables keyed on (k, n, numSamples). Element references stay valid when new tables are added.
+ * getOrCreate is not thread-safe, but concurrent calls to get are.
+ */
+class BSplineBasisTableCache {
+public:
+    const BSplineBasisTable& getOrCreate(int k, int numControlPoints, int numSamples);
+    /// Returns nullptr if the table was not created before.
+    [[nodiscard]] const BSplineBasisTable* get(int k, int numControlPoints, int numSamples) const;
+    inline void clear() { tables.clear(); }
+
+private:
+    static inline uint64_t getKey(int k, int numControlPoints, int numSamples) {
+        return (uint64_t(k) << 48) | (uint64_t(numControlPoints) << 24) | uint64_t(numSamples);
+    }
+    std::unordered_map<uint64_t, BSplineBasisTable> tables;
+};
+
+/// Returns the order of the curves through numControlPoints control points used by the diagrams (cubic if possible).
+inline int getBSplineOrderForControlPoints(int numControlPoints) {
+    return numControlPoints < 4 ? numControlPoints : 4;
+}
+
+/**
+ * Evaluates many B-spline curves sharing the same order, number of control points and sample parameters.
+ * @param basisTable The shared basis table.
+ * @param controlPoints numCurves * basisTable.getNumControlPoints() control points, stored curve after curve.
+ * @param numCurves The number of curves to evaluate.
+ * @param curvePoints Output array of numCurves * basisTable.getNumSamples() points, stored curve after curve.
+ */
+void evaluateBSplineCurves(
+        const BSplineBasisTable& basisTable, const glm::vec2* controlPoints, int numCurves, glm::vec2* curvePoints);
+
 #endif //CORRERENDER_BSPLINE_HPP
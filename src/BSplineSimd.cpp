@@ -0,0 +1,363 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BSPLINE_SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+#define BSPLINE_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+// Allows compiling the AVX2 and AVX-512 kernels without raising the minimum instruction set of the whole program.
+#if defined(__GNUC__) || defined(__clang__)
+#define BSPLINE_TARGET(x) __attribute__((target(x)))
+#else
+#define BSPLINE_TARGET(x)
+#endif
+
+#include "BSpline.hpp"
+#include "BSplineSimd.hpp"
+
+/// Widest SIMD width in floats; used for padding the SoA stride.
+static const size_t MAX_SIMD_WIDTH = 16;
+
+void BSplineControlPointsSoA::resize(int _numCurves, int _numControlPoints) {
+    numCurves = _numCurves;
+    numControlPoints = _numControlPoints;
+    stride = (size_t(numCurves) + MAX_SIMD_WIDTH - 1) / MAX_SIMD_WIDTH * MAX_SIMD_WIDTH;
+    x.resize(stride * size_t(numControlPoints));
+    y.resize(stride * size_t(numControlPoints));
+}
+
+#ifdef BSPLINE_SIMD_X86
+static SimdLevel detectSimdLevelX86() {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SimdLevel::AVX2;
+    }
+    return SimdLevel::SSE2;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+    bool hasFma = (info[2] & (1 << 12)) != 0;
+    unsigned long long xcr0 = hasOsxsave ? _xgetbv(0) : 0;
+    bool osSupportsAvx = (xcr0 & 0x6) == 0x6;
+    bool osSupportsAvx512 = (xcr0 & 0xe6) == 0xe6;
+    bool hasAvx2 = false, hasAvx512f = false;
+    if (maxLeaf >= 7) {
+        __cpuidex(info, 7, 0);
+        hasAvx2 = (info[1] & (1 << 5)) != 0;
+        hasAvx512f = (info[1] & (1 << 16)) != 0;
+    }
+    if (hasAvx512f && osSupportsAvx512) {
+        return SimdLevel::AVX512;
+    }
+    if (hasAvx2 && hasFma && osSupportsAvx) {
+        return SimdLevel::AVX2;
+    }
+    return SimdLevel::SSE2;
+#else
+    return SimdLevel::SSE2;
+#endif
+}
+#endif
+
+SimdLevel getBestSupportedSimdLevel() {
+#if defined(BSPLINE_SIMD_X86)
+    static const SimdLevel simdLevel = detectSimdLevelX86();
+    return simdLevel;
+#elif defined(BSPLINE_SIMD_NEON)
+    // NEON is mandatory on AArch64.
+    return SimdLevel::NEON;
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+
+bool getIsSimdLevelSupported(SimdLevel simdLevel) {
+    if (simdLevel == SimdLevel::SCALAR) {
+        return true;
+    }
+    SimdLevel bestLevel = getBestSupportedSimdLevel();
+#ifdef BSPLINE_SIMD_X86
+    return simdLevel != SimdLevel::NEON && int(simdLevel) <= int(bestLevel);
+#else
+    return simdLevel == bestLevel;
+#endif
+}
+
+int getSimdLevelWidth(SimdLevel simdLevel) {
+    switch (simdLevel) {
+        case SimdLevel::SSE2:
+        case SimdLevel::NEON:
+            return 4;
+        case SimdLevel::AVX2:
+            return 8;
+        case SimdLevel::AVX512:
+            return 16;
+        default:
+            return 1;
+    }
+}
+
+/*
+ * Each kernel evaluates the curves [curveStart, curveEnd) in groups of the SIMD width and returns the index of the
+ * first curve it did not process. The x and y sums of one sample are interleaved and written as 64-bit stores to
+ * the output curves of all lanes.
+ */
+
+static int evaluateCurvesScalar(
+        const BSplineBasisTable& basisTable, const float* X, const float* Y, size_t stride,
+        int curveStart, int curveEnd, glm::vec2* curvePoints) {
+    const int k = basisTable.getOrder();
+    const int numControlPoints = basisTable.getNumControlPoints();
+    const int numSamples = basisTable.getNumSamples();
+    const float* weights = basisTable.getWeights();
+    const int* firstNonZeroColumns = basisTable.getFirstNonZeroColumns();
+    for (int c = curveStart; c < curveEnd; c++) {
+        glm::vec2* out = curvePoints + size_t(c) * size_t(numSamples);
+        for (int s = 0; s < numSamples; s++) {
+            int firstColumn = firstNonZeroColumns[s];
+            const float* row = weights + size_t(s) * size_t(numControlPoints) + firstColumn;
+            float sumX = 0.0f, sumY = 0.0f;
+            for (int j = 0; j < k; j++) {
+                size_t offset = size_t(firstColumn + j) * stride + size_t(c);
+                sumX += row[j] * X[offset];
+                sumY += row[j] * Y[offset];
+            }
+            out[s] = glm::vec2(sumX, sumY);
+        }
+    }
+    return curveEnd;
+}
+
+#ifdef BSPLINE_SIMD_X86
+static int evaluateCurvesSse2(
+        const BSplineBasisTable& basisTable, const float* X, const float* Y, size_t stride,
+        int curveStart, int curveEnd, glm::vec2* curvePoints) {
+    const int k = basisTable.getOrder();
+    const int numControlPoints = basisTable.getNumControlPoints();
+    const int numSamples = basisTable.getNumSamples();
+    const float* weights = basisTable.getWeights();
+    const int* firstNonZeroColumns = basisTable.getFirstNonZeroColumns();
+    int c = curveStart;
+    for (; c + 4 <= curveEnd; c += 4) {
+        auto* out = reinterpret_cast<float*>(curvePoints + size_t(c) * size_t(numSamples));
+        const size_t laneStride = size_t(numSamples) * 2;
+        for (int s = 0; s < numSamples; s++) {
+            int firstColumn = firstNonZeroColumns[s];
+            const float* row = weights + size_t(s) * size_t(numControlPoints) + firstColumn;
+            __m128 sumX = _mm_setzero_ps();
+            __m128 sumY = _mm_setzero_ps();
+            for (int j = 0; j < k; j++) {
+                size_t offset = size_t(firstColumn + j) * stride + size_t(c);
+                __m128 w = _mm_set1_ps(row[j]);
+                sumX = _mm_add_ps(sumX, _mm_mul_ps(w, _mm_loadu_ps(X + offset)));
+                sumY = _mm_add_ps(sumY, _mm_mul_ps(w, _mm_loadu_ps(Y + offset)));
+            }
+            __m128 lo = _mm_unpacklo_ps(sumX, sumY); // x0 y0 x1 y1
+            __m128 hi = _mm_unpackhi_ps(sumX, sumY); // x2 y2 x3 y3
+            float* dst = out + size_t(s) * 2;
+            _mm_storel_pi(reinterpret_cast<__m64*>(dst), lo);
+            _mm_storeh_pi(reinterpret_cast<__m64*>(dst + laneStride), lo);
+            _mm_storel_pi(reinterpret_cast<__m64*>(dst + 2 * laneStride), hi);
+            _mm_storeh_pi(reinterpret_cast<__m64*>(dst + 3 * laneStride), hi);
+        }
+    }
+    return c;
+}
+
+BSPLINE_TARGET("avx2,fma")
+static int evaluateCurvesAvx2(
+        const BSplineBasisTable& basisTable, const float* X, const float* Y, size_t stride,
+        int curveStart, int curveEnd, glm::vec2* curvePoints) {
+    const int k = basisTable.getOrder();
+    const int numControlPoints = basisTable.getNumControlPoints();
+    const int numSamples = basisTable.getNumSamples();
+    const float* weights = basisTable.getWeights();
+    const int* firstNonZeroColumns = basisTable.getFirstNonZeroColumns();
+    int c = curveStart;
+    for (; c + 8 <= curveEnd; c += 8) {
+        auto* out = reinterpret_cast<float*>(curvePoints + size_t(c) * size_t(numSamples));
+        const size_t laneStride = size_t(numSamples) * 2;
+        for (int s = 0; s < numSamples; s++) {
+            int firstColumn = firstNonZeroColumns[s];
+            const float* row = weights + size_t(s) * size_t(numControlPoints) + firstColumn;
+            __m256 sumX = _mm256_setzero_ps();
+            __m256 sumY = _mm256_setzero_ps();
+            for (int j = 0; j < k; j++) {
+                size_t offset = size_t(firstColumn + j) * stride + size_t(c);
+                __m256 w = _mm256_set1_ps(row[j]);
+                sumX = _mm256_fmadd_ps(w, _mm256_loadu_ps(X + offset), sumX);
+                sumY = _mm256_fmadd_ps(w, _mm256_loadu_ps(Y + offset), sumY);
+            }
+            // The unpack instructions operate per 128-bit half: lo = x0 y0 x1 y1 | x4 y4 x5 y5.
+            __m256 lo = _mm256_unpacklo_ps(sumX, sumY);
+            __m256 hi = _mm256_unpackhi_ps(sumX, sumY);
+            __m128 lo0 = _mm256_castps256_ps128(lo);
+            __m128 lo1 = _mm256_extractf128_ps(lo, 1);
+            __m128 hi0 = _mm256_castps256_ps128(hi);
+            __m128 hi1 = _mm256_extractf128_ps(hi, 1);
+            float* dst = out + size_t(s) * 2;
+            _mm_storel_pi(reinterpret_cast<__m64*>(dst), lo0);
+            _mm_storeh_pi(reinterpret_cast<__m64*>(dst + laneStride), lo0);
+            _mm_storel_pi(reinterpret_cast<__m64*>(dst + 2 * laneStride), hi0);
+            _mm_storeh_pi(reinterpret_cast<__m64*>(dst + 3 * laneStride), hi0);
+            _mm_storel_pi(reinterpret_cast<__m64*>(dst + 4 * laneStride), lo1);
+            _mm_storeh_pi(reinterpret_cast<__m64*>(dst + 5 * laneStride), lo1);
+            _mm_storel_pi(reinterpret_cast<__m64*>(dst + 6 * laneStride), hi1);
+            _mm_storeh_pi(reinterpret_cast<__m64*>(dst + 7 * laneStride), hi1);
+        }
+    }
+    return c;
+}
+
+BSPLINE_TARGET("avx512f")
+static int evaluateCurvesAvx512(
+        const BSplineBasisTable& basisTable, const float* X, const float* Y, size_t stride,
+        int curveStart, int curveEnd, glm::vec2* curvePoints) {
+    const int k = basisTable.getOrder();
+    const int numControlPoints = basisTable.getNumControlPoints();
+    const int numSamples = basisTable.getNumSamples();
+    const float* weights = basisTable.getWeights();
+    const int* firstNonZeroColumns = basisTable.getFirstNonZeroColumns();
+    int c = curveStart;
+    for (; c + 16 <= curveEnd; c += 16) {
+        auto* out = reinterpret_cast<float*>(curvePoints + size_t(c) * size_t(numSamples));
+        const size_t laneStride = size_t(numSamples) * 2;
+        for (int s = 0; s < numSamples; s++) {
+            int firstColumn = firstNonZeroColumns[s];
+            const float* row = weights + size_t(s) * size_t(numControlPoints) + firstColumn;
+            __m512 sumX = _mm512_setzero_ps();
+            __m512 sumY = _mm512_setzero_ps();
+            for (int j = 0; j < k; j++) {
+                size_t offset = size_t(firstColumn + j) * stride + size_t(c);
+                __m512 w = _mm512_set1_ps(row[j]);
+                sumX = _mm512_fmadd_ps(w, _mm512_loadu_ps(X + offset), sumX);
+                sumY = _mm512_fmadd_ps(w, _mm512_loadu_ps(Y + offset), sumY);
+            }
+            // Spill and interleave; at 16 lanes the stores dominate over the shuffles either way.
+            alignas(64) float lanesX[16];
+            alignas(64) float lanesY[16];
+            _mm512_store_ps(lanesX, sumX);
+            _mm512_store_ps(lanesY, sumY);
+            float* dst = out + size_t(s) * 2;
+            for (int lane = 0; lane < 16; lane++) {
+                dst[size_t(lane) * laneStride] = lanesX[lane];
+                dst[size_t(lane) * laneStride + 1] = lanesY[lane];
+            }
+        }
+    }
+    return c;
+}
+#endif
+
+#ifdef BSPLINE_SIMD_NEON
+static int evaluateCurvesNeon(
+        const BSplineBasisTable& basisTable, const float* X, const float* Y, size_t stride,
+        int curveStart, int curveEnd, glm::vec2* curvePoints) {
+    const int k = basisTable.getOrder();
+    const int numControlPoints = basisTable.getNumControlPoints();
+    const int numSamples = basisTable.getNumSamples();
+    const float* weights = basisTable.getWeights();
+    const int* firstNonZeroColumns = basisTable.getFirstNonZeroColumns();
+    int c = curveStart;
+    for (; c + 4 <= curveEnd; c += 4) {
+        auto* out = reinterpret_cast<float*>(curvePoints + size_t(c) * size_t(numSamples));
+        const size_t laneStride = size_t(numSamples) * 2;
+        for (int s = 0; s < numSamples; s++) {
+            int firstColumn = firstNonZeroColumns[s];
+            const float* row = weights + size_t(s) * size_t(numControlPoints) + firstColumn;
+            float32x4_t sumX = vdupq_n_f32(0.0f);
+            float32x4_t sumY = vdupq_n_f32(0.0f);
+            for (int j = 0; j < k; j++) {
+                size_t offset = size_t(firstColumn + j) * stride + size_t(c);
+#if defined(__aarch64__) || defined(_M_ARM64)
+                sumX = vfmaq_n_f32(sumX, vld1q_f32(X + offset), row[j]);
+                sumY = vfmaq_n_f32(sumY, vld1q_f32(Y + offset), row[j]);
+#else
+                sumX = vmlaq_n_f32(sumX, vld1q_f32(X + offset), row[j]);
+                sumY = vmlaq_n_f32(sumY, vld1q_f32(Y + offset), row[j]);
+#endif
+            }
+            float32x4x2_t xy = vzipq_f32(sumX, sumY); // x0 y0 x1 y1, x2 y2 x3 y3
+            float* dst = out + size_t(s) * 2;
+            vst1_f32(dst, vget_low_f32(xy.val[0]));
+            vst1_f32(dst + laneStride, vget_high_f32(xy.val[0]));
+            vst1_f32(dst + 2 * laneStride, vget_low_f32(xy.val[1]));
+            vst1_f32(dst + 3 * laneStride, vget_high_f32(xy.val[1]));
+        }
+    }
+    return c;
+}
+#endif
+
+void evaluateBSplineCurvesSoA(
+        const BSplineBasisTable& basisTable, const float* controlPointsX, const float* controlPointsY, size_t stride,
+        int numCurves, glm::vec2* curvePoints, SimdLevel simdLevel) {
+    int c = 0;
+    switch (simdLevel) {
+#ifdef BSPLINE_SIMD_X86
+        case SimdLevel::AVX512:
+            c = evaluateCurvesAvx512(basisTable, controlPointsX, controlPointsY, stride, c, numCurves, curvePoints);
+            [[fallthrough]];
+        case SimdLevel::AVX2:
+            c = evaluateCurvesAvx2(basisTable, controlPointsX, controlPointsY, stride, c, numCurves, curvePoints);
+            [[fallthrough]];
+        case SimdLevel::SSE2:
+            c = evaluateCurvesSse2(basisTable, controlPointsX, controlPointsY, stride, c, numCurves, curvePoints);
+            break;
+#endif
+#ifdef BSPLINE_SIMD_NEON
+        case SimdLevel::NEON:
+            c = evaluateCurvesNeon(basisTable, controlPointsX, controlPointsY, stride, c, numCurves, curvePoints);
+            break;
+#endif
+        default:
+            break;
+    }
+    evaluateCurvesScalar(basisTable, controlPointsX, controlPointsY, stride, c, numCurves, curvePoints);
+}
+
+void evaluateBSplineCurvesSoA(
+        const BSplineBasisTable& basisTable, const BSplineControlPointsSoA& controlPoints, glm::vec2* curvePoints) {
+    evaluateBSplineCurvesSoA(
+            basisTable, controlPoints.x.data(), controlPoints.y.data(), controlPoints.stride,
+            controlPoints.numCurves, curvePoints, getBestSupportedSimdLevel());
+}
@@ -0,0 +1,92 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BSPLINESIMD_HPP
+#define BSPLINESIMD_HPP
+
+#include <vector>
+#include <glm/vec2.hpp>
+
+class BSplineBasisTable;
+
+/// Instruction set used by the vectorized B-spline curve evaluation.
+enum class SimdLevel {
+    SCALAR, SSE2, AVX2, AVX512, NEON
+};
+const char* const SIMD_LEVEL_NAMES[] = {
+        "Scalar", "SSE2", "AVX2", "AVX-512", "NEON"
+};
+
+/// Returns the widest instruction set supported by both the build and the CPU (detected once at runtime).
+SimdLevel getBestSupportedSimdLevel();
+[[nodiscard]] bool getIsSimdLevelSupported(SimdLevel simdLevel);
+/// Returns the number of curves evaluated per instruction.
+[[nodiscard]] int getSimdLevelWidth(SimdLevel simdLevel);
+
+/**
+ * Control points of many curves with the same number of control points in structure-of-arrays layout.
+ * The coordinates of control point j of curve c are stored at x[j * stride + c] and y[j * stride + c], such that the
+ * same control point of consecutive curves can be loaded with a single vector load.
+ */
+struct BSplineControlPointsSoA {
+    int numControlPoints = 0;
+    int numCurves = 0;
+    size_t stride = 0; //< numCurves rounded up to a multiple of the widest SIMD width.
+    std::vector<float> x;
+    std::vector<float> y;
+
+    void resize(int _numCurves, int _numControlPoints);
+    inline void set(int curveIdx, int controlPointIdx, const glm::vec2& pt) {
+        size_t idx = size_t(controlPointIdx) * stride + size_t(curveIdx);
+        x[idx] = pt.x;
+        y[idx] = pt.y;
+    }
+    [[nodiscard]] inline glm::vec2 get(int curveIdx, int controlPointIdx) const {
+        size_t idx = size_t(controlPointIdx) * stride + size_t(curveIdx);
+        return { x[idx], y[idx] };
+    }
+};
+
+/**
+ * Evaluates numCurves B-spline curves in SoA layout (see @see BSplineControlPointsSoA) with explicitly vectorized
+ * kernels. Curves not filling a complete vector are processed by the scalar fallback.
+ * @param basisTable The basis table shared by all curves.
+ * @param controlPointsX The x coordinates of the control points; control point j of curve c is at j * stride + c.
+ * @param controlPointsY The y coordinates of the control points.
+ * @param stride The distance between control point j and j + 1 of the same curve in the arrays above.
+ * @param numCurves The number of curves to evaluate.
+ * @param curvePoints Output array of numCurves * basisTable.getNumSamples() points, stored curve after curve.
+ * @param simdLevel The instruction set to use. It must be supported by the CPU.
+ */
+void evaluateBSplineCurvesSoA(
+        const BSplineBasisTable& basisTable, const float* controlPointsX, const float* controlPointsY, size_t stride,
+        int numCurves, glm::vec2* curvePoints, SimdLevel simdLevel);
+void evaluateBSplineCurvesSoA(
+        const BSplineBasisTable& basisTable, const BSplineControlPointsSoA& controlPoints, glm::vec2* curvePoints);
+
+#endif //BSPLINESIMD_HPP
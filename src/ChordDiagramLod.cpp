@@ -0,0 +1,150 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "ChordDiagramLod.hpp"
+
+bool ChordDiagramLod::getNeedsRebuild(const ChordDiagramModel& model, int maxNumSectors) const {
+    return sourceModelId != model.getModelId() || sourceControlPolygonsVersion != model.getControlPolygonsVersion()
+            || sourceEdgeWeightsVersion != model.getEdgeWeightsVersion() || sourceMaxNumSectors != maxNumSectors;
+}
+
+void ChordDiagramLod::build(const ChordDiagramModel& model, int maxNumSectors) {
+    sourceModelId = model.getModelId();
+    sourceControlPolygonsVersion = model.getControlPolygonsVersion();
+    sourceEdgeWeightsVersion = model.getEdgeWeightsVersion();
+    sourceMaxNumSectors = maxNumSectors;
+
+    const std::vector<HEBNode>& nodes = model.getNodes();
+    const uint32_t leafIdxOffset = model.getLeafIdxOffset();
+    const auto numNodes = uint32_t(nodes.size());
+
+    // Find the deepest level with at most maxNumSectors nodes.
+    uint32_t maxDepth = 0;
+    for (const HEBNode& node : nodes) {
+        maxDepth = std::max(maxDepth, node.depth);
+    }
+    std::vector<uint32_t> levelSizes(maxDepth + 1, 0);
+    for (const HEBNode& node : nodes) {
+        levelSizes[node.depth]++;
+    }
+    uint32_t sectorDepth = 0;
+    while (sectorDepth < maxDepth && levelSizes[sectorDepth + 1] <= uint32_t(std::max(maxNumSectors, 1))) {
+        sectorDepth++;
+    }
+
+    // Truncate the hierarchy at the sector depth. The sectors (and shallower leaves) become the leaves of the coarse
+    // model; they are stored after the inner nodes, which keeps parents before their children.
+    std::vector<uint8_t> hasChildren(numNodes, 0);
+    for (const HEBNode& node : nodes) {
+        if (node.parentIdx < numNodes) {
+            hasChildren[node.parentIdx] = 1;
+        }
+    }
+    const uint32_t invalidIdx = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> lodNodeIndices(numNodes, invalidIdx);
+    std::vector<uint32_t> innerNodes, sectorNodes;
+    for (uint32_t nodeIdx = 0; nodeIdx < numNodes; nodeIdx++) {
+        const HEBNode& node = nodes[nodeIdx];
+        if (node.depth < sectorDepth && hasChildren[nodeIdx]) {
+            innerNodes.push_back(nodeIdx);
+        } else if (node.depth <= sectorDepth) {
+            sectorNodes.push_back(nodeIdx);
+        }
+    }
+    std::vector<HEBNode> lodNodes;
+    lodNodes.reserve(innerNodes.size() + sectorNodes.size());
+    for (const std::vector<uint32_t>& nodeList : { innerNodes, sectorNodes }) {
+        for (uint32_t nodeIdx : nodeList) {
+            const HEBNode& node = nodes[nodeIdx];
+            lodNodeIndices[nodeIdx] = uint32_t(lodNodes.size());
+            HEBNode lodNode;
+            lodNode.depth = node.depth;
+            lodNode.angle = node.angle;
+            lodNode.parentIdx = node.parentIdx < numNodes ? lodNodeIndices[node.parentIdx] : invalidIdx;
+            // Sectors lie on the unit circle, and the inner nodes are spaced evenly up to it.
+            float radius = hasChildren[nodeIdx] && node.depth < sectorDepth
+                    ? float(node.depth) / float(std::max(sectorDepth, 1u)) : 1.0f;
+            lodNode.normalizedPosition = radius * glm::vec2(std::cos(node.angle), std::sin(node.angle));
+            lodNodes.push_back(lodNode);
+        }
+    }
+    const auto lodLeafIdxOffset = uint32_t(innerNodes.size());
+
+    // Map every leaf to its sector and aggregate the edges by sector pair.
+    const int numLeaves = model.getNumLeaves();
+    std::vector<uint32_t> leafSectors(std::max(numLeaves, 0));
+    for (int leafIdx = 0; leafIdx < numLeaves; leafIdx++) {
+        uint32_t nodeIdx = leafIdxOffset + uint32_t(leafIdx);
+        while (nodes[nodeIdx].depth > sectorDepth) {
+            nodeIdx = nodes[nodeIdx].parentIdx;
+        }
+        leafSectors[leafIdx] = lodNodeIndices[nodeIdx] - lodLeafIdxOffset;
+    }
+    std::vector<std::pair<uint64_t, float>> sectorPairs; //< Packed sector pair and edge weight.
+    sectorPairs.reserve(model.getEdges().size());
+    for (const HEBEdge& edge : model.getEdges()) {
+        uint32_t sector0 = leafSectors[edge.pointIdx0];
+        uint32_t sector1 = leafSectors[edge.pointIdx1];
+        if (sector0 != sector1) {
+            sectorPairs.emplace_back(
+                    (uint64_t(std::min(sector0, sector1)) << 32u) | uint64_t(std::max(sector0, sector1)), edge.weight);
+        }
+    }
+    std::stable_sort(sectorPairs.begin(), sectorPairs.end(), [](const auto& p0, const auto& p1) {
+        return p0.first < p1.first;
+    });
+    std::vector<std::pair<uint32_t, uint32_t>> superEdges;
+    std::vector<float> pairWeights;
+    for (size_t i = 0; i < sectorPairs.size(); i++) {
+        if (i == 0 || sectorPairs[i].first != sectorPairs[i - 1].first) {
+            superEdges.emplace_back(
+                    uint32_t(sectorPairs[i].first >> 32u), uint32_t(sectorPairs[i].first & 0xFFFFFFFFu));
+            pairWeights.push_back(0.0f);
+        }
+        pairWeights.back() += sectorPairs[i].second;
+    }
+
+    lodModel.setNodes(std::move(lodNodes), lodLeafIdxOffset);
+    lodModel.setEdges(superEdges);
+
+    // setEdges reorders the lines, so the weights are looked up by sector pair.
+    const std::vector<HEBEdge>& lodEdges = lodModel.getEdges();
+    superEdgeWeights.resize(lodEdges.size());
+    maxSuperEdgeWeight = 0.0f;
+    for (size_t lineIdx = 0; lineIdx < lodEdges.size(); lineIdx++) {
+        auto it = std::lower_bound(
+                superEdges.begin(), superEdges.end(),
+                std::make_pair(lodEdges[lineIdx].pointIdx0, lodEdges[lineIdx].pointIdx1));
+        superEdgeWeights[lineIdx] = pairWeights[it - superEdges.begin()];
+        maxSuperEdgeWeight = std::max(maxSuperEdgeWeight, superEdgeWeights[lineIdx]);
+    }
+}
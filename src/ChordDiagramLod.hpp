@@ -0,0 +1,68 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CHORDDIAGRAMLOD_HPP
+#define CHORDDIAGRAMLOD_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "ChordDiagramModel.hpp"
+
+/**
+ * Level of detail for chord diagrams with many edges: The edges are aggregated into super-edges between angular
+ * sectors, i.e., the nodes of the hierarchy at the deepest level with at most maxNumSectors nodes. The super-edges are
+ * stored as edges of a coarse model (the hierarchy truncated at the sector level with the sectors as leaves), so they
+ * are bundled and tessellated like regular edges. Edges within one sector are not represented.
+ */
+class ChordDiagramLod {
+public:
+    /// Returns whether the node hierarchy, the edges or their weights changed since the last build.
+    [[nodiscard]] bool getNeedsRebuild(const ChordDiagramModel& model, int maxNumSectors) const;
+    void build(const ChordDiagramModel& model, int maxNumSectors);
+
+    /// The coarse model; its tessellation settings are managed by the caller.
+    [[nodiscard]] inline ChordDiagramModel& getModel() { return lodModel; }
+    /// Sum of the weights of the aggregated edges per line of the coarse model.
+    [[nodiscard]] inline const std::vector<float>& getSuperEdgeWeights() const { return superEdgeWeights; }
+    [[nodiscard]] inline float getMaxSuperEdgeWeight() const { return maxSuperEdgeWeight; }
+    [[nodiscard]] inline int getNumSectors() const { return lodModel.getNumLeaves(); }
+    [[nodiscard]] inline int getNumSuperEdges() const { return lodModel.getNumLines(); }
+
+private:
+    ChordDiagramModel lodModel;
+    std::vector<float> superEdgeWeights;
+    float maxSuperEdgeWeight = 0.0f;
+
+    uint64_t sourceModelId = 0;
+    uint64_t sourceControlPolygonsVersion = 0;
+    uint64_t sourceEdgeWeightsVersion = 0;
+    int sourceMaxNumSectors = 0;
+};
+
+#endif //CHORDDIAGRAMLOD_HPP
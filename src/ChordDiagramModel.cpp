@@ -0,0 +1,612 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "ParallelFor.hpp"
+#include "ChordDiagramModel.hpp"
+
+static std::atomic<uint64_t> nextModelId{1};
+
+ChordDiagramModel::ChordDiagramModel() : modelId(nextModelId.fetch_add(1)), simdLevel(getBestSupportedSimdLevel()) {
+}
+
+void ChordDiagramModel::buildRadialHierarchy(int numLeaves, int branchingFactor) {
+    std::vector<HEBNode> newNodes;
+    uint32_t newLeafIdxOffset = 0;
+    HEBTree::buildRadialHierarchy(numLeaves, branchingFactor, newNodes, newLeafIdxOffset);
+    setNodes(std::move(newNodes), newLeafIdxOffset);
+}
+
+void ChordDiagramModel::setNodes(std::vector<HEBNode> _nodes, uint32_t _leafIdxOffset) {
+    // Checked before the model is changed.
+    HEBTree::validateHierarchy(_nodes, _leafIdxOffset);
+    nodes = std::move(_nodes);
+    leafIdxOffset = _leafIdxOffset;
+    hebTree.build(nodes, leafIdxOffset);
+    edges.clear();
+    updateEdgePaths();
+    invalidateTessellation();
+}
+
+void ChordDiagramModel::validateEdges(
+        const char* functionName, const std::vector<std::pair<uint32_t, uint32_t>>& newEdges,
+        const std::vector<float>& weights) const {
+    const auto numLeaves = uint32_t(std::max(getNumLeaves(), 0));
+    for (const auto& newEdge : newEdges) {
+        if (newEdge.first >= numLeaves || newEdge.second >= numLeaves) {
+            throw std::runtime_error(std::string("Error in ChordDiagramModel::") + functionName
+                    + ": Leaf index out of range.");
+        }
+    }
+    if (!weights.empty() && weights.size() != newEdges.size()) {
+        throw std::runtime_error(std::string("Error in ChordDiagramModel::") + functionName
+                + ": The number of weights does not match the number of edges.");
+    }
+}
+
+void ChordDiagramModel::setEdges(
+        const std::vector<std::pair<uint32_t, uint32_t>>& newEdges, const std::vector<float>& weights) {
+    validateEdges("setEdges", newEdges, weights);
+    if (newEdges.size() > size_t(std::numeric_limits<int>::max())) {
+        throw std::runtime_error("Error in ChordDiagramModel::setEdges: Too many edges.");
+    }
+    edges.resize(newEdges.size());
+    for (size_t i = 0; i < newEdges.size(); i++) {
+        edges[i].pointIdx0 = newEdges[i].first;
+        edges[i].pointIdx1 = newEdges[i].second;
+        edges[i].weight = weights.empty() ? 1.0f : weights[i];
+    }
+    updateEdgePaths();
+    invalidateTessellation();
+}
+
+void ChordDiagramModel::setEdgesFromRecords(
+        const uint8_t* records, size_t numEdges, size_t recordStride, float weightScale) {
+    if (numEdges > size_t(std::numeric_limits<int>::max())) {
+        throw std::runtime_error("Error in ChordDiagramModel::setEdgesFromRecords: Too many edges.");
+    }
+    if (recordStride < 3 * sizeof(uint32_t)) {
+        throw std::runtime_error("Error in ChordDiagramModel::setEdgesFromRecords: Invalid record stride.");
+    }
+    auto readEdge = [&](int edgeIdx, HEBEdge& edge) {
+        const uint8_t* record = records + size_t(edgeIdx) * recordStride;
+        float weight = 0.0f;
+        std::memcpy(&edge.pointIdx0, record, sizeof(uint32_t));
+        std::memcpy(&edge.pointIdx1, record + sizeof(uint32_t), sizeof(uint32_t));
+        std::memcpy(&weight, record + 2 * sizeof(uint32_t), sizeof(float));
+        edge.weight = std::isfinite(weight) ? std::clamp(weight * weightScale, 0.0f, 1.0f) : 0.0f;
+    };
+
+    // Pass 1: Validate the leaf indices, cache the LCAs and count the edges per chunk and control point count. LCA
+    // queries are dominated by cache misses, so caching them is cheaper than recomputing them in the second pass.
+    // Processing a chunk only depends on its own records, so the counts are deterministic for any number of threads.
+    const auto numLeaves = uint32_t(std::max(getNumLeaves(), 0));
+    const int numItems = int(numEdges);
+    const int numChunks = (numItems + EDGE_RECORD_CHUNK_SIZE - 1) / EDGE_RECORD_CHUNK_SIZE;
+    constexpr int numBuckets = HEB_MAX_CONTROL_POINTS + 1;
+    std::vector<size_t> bucketOffsets(size_t(numChunks) * numBuckets, 0);
+    std::vector<uint32_t> lcaIndices(numEdges);
+    std::atomic<bool> hasInvalidLeafIndices{false};
+    parallelForChunks(numItems, EDGE_RECORD_CHUNK_SIZE, [&](int threadIdx, int begin, int end) {
+        size_t* chunkCounts = bucketOffsets.data() + size_t(begin / EDGE_RECORD_CHUNK_SIZE) * numBuckets;
+        HEBEdge edge;
+        for (int edgeIdx = begin; edgeIdx < end; edgeIdx++) {
+            readEdge(edgeIdx, edge);
+            if (edge.pointIdx0 >= numLeaves || edge.pointIdx1 >= numLeaves) {
+                hasInvalidLeafIndices = true;
+                return;
+            }
+            hebTree.updateEdgePaths(&edge, 1);
+            lcaIndices[edgeIdx] = edge.lcaIdx;
+            chunkCounts[edge.numControlPoints]++;
+        }
+    });
+    if (hasInvalidLeafIndices) {
+        throw std::runtime_error("Error in ChordDiagramModel::setEdgesFromRecords: Leaf index out of range.");
+    }
+
+    // Exclusive prefix sum in (bucket, chunk) order gives the same order as the stable sort in updateEdgePaths.
+    size_t offset = 0;
+    for (int bucketIdx = 0; bucketIdx < numBuckets; bucketIdx++) {
+        for (int chunkIdx = 0; chunkIdx < numChunks; chunkIdx++) {
+            size_t& bucketOffset = bucketOffsets[size_t(chunkIdx) * numBuckets + bucketIdx];
+            size_t count = bucketOffset;
+            bucketOffset = offset;
+            offset += count;
+        }
+    }
+
+    // Pass 2: Scatter the edges to their sorted positions.
+    edges.clear();
+    edges.shrink_to_fit();
+    edges.resize(numEdges);
+    parallelForChunks(numItems, EDGE_RECORD_CHUNK_SIZE, [&](int threadIdx, int begin, int end) {
+        size_t* chunkOffsets = bucketOffsets.data() + size_t(begin / EDGE_RECORD_CHUNK_SIZE) * numBuckets;
+        HEBEdge edge;
+        for (int edgeIdx = begin; edgeIdx < end; edgeIdx++) {
+            readEdge(edgeIdx, edge);
+            edge.lcaIdx = lcaIndices[edgeIdx];
+            edge.numControlPoints = hebTree.getPathLength(
+                    leafIdxOffset + edge.pointIdx0, leafIdxOffset + edge.pointIdx1, edge.lcaIdx);
+            edges[chunkOffsets[edge.numControlPoints]++] = edge;
+        }
+    });
+
+    controlPolygonsVersion++;
+    edgeWeightsVersion++;
+    numLinesTotal = int(edges.size());
+    updateCurveGroups();
+    invalidateTessellation();
+}
+
+void ChordDiagramModel::updateEdgePaths() {
+    controlPolygonsVersion++;
+    edgeWeightsVersion++;
+    hebTree.updateEdgePaths(edges);
+
+    // Sort the edges by their number of control points so that curves sharing a basis table are contiguous.
+    std::stable_sort(edges.begin(), edges.end(), [](const HEBEdge& e0, const HEBEdge& e1) {
+        return e0.numControlPoints < e1.numControlPoints;
+    });
+    numLinesTotal = int(edges.size());
+    updateCurveGroups();
+}
+
+void ChordDiagramModel::updateCurveGroups() {
+    curveGroups.clear();
+    for (int lineIdx = 0; lineIdx < numLinesTotal; lineIdx++) {
+        auto numControlPoints = int(edges[lineIdx].numControlPoints);
+        if (curveGroups.empty() || curveGroups.back().numControlPoints != numControlPoints) {
+            curveGroups.push_back({ lineIdx, lineIdx, numControlPoints });
+        }
+        curveGroups.back().lineEnd = lineIdx + 1;
+    }
+    if (int(knotVectors.size()) != HEB_MAX_CONTROL_POINTS + 1
+            || (knotVectors.size() > 1 && knotVectors.back().getOrder() != getLineOrder(HEB_MAX_CONTROL_POINTS))) {
+        knotVectors.resize(HEB_MAX_CONTROL_POINTS + 1);
+        for (int n = 1; n <= HEB_MAX_CONTROL_POINTS; n++) {
+            knotVectors[n].setup(getLineOrder(n), n);
+        }
+    }
+}
+
+int ChordDiagramModel::getLineControlPoints(int lineIdx, glm::vec2* linePoints, float polygonBeta) const {
+    const HEBEdge& edge = edges[lineIdx];
+    hebTree.getControlPoints(nodes, edge, polygonBeta, linePoints);
+    return int(edge.numControlPoints);
+}
+
+void ChordDiagramModel::invalidateTessellation() {
+    isTessellated = false;
+}
+
+void ChordDiagramModel::markCurvesDirty(
+        int lineStart, int lineEnd, bool offsetsChanged, const std::vector<uint8_t>* isLineChanged) {
+    if (lineStart >= lineEnd && !offsetsChanged) {
+        return;
+    }
+    if (dirtyLineStart >= dirtyLineEnd) {
+        dirtyLineStart = lineStart;
+        dirtyLineEnd = lineEnd;
+    } else {
+        dirtyLineStart = std::min(dirtyLineStart, lineStart);
+        dirtyLineEnd = std::max(dirtyLineEnd, lineEnd);
+    }
+    curveOffsetsChanged = curveOffsetsChanged || offsetsChanged;
+    curvePointsVersion++;
+    lineVersions.resize(size_t(numLinesTotal), curvePointsVersion);
+    for (int lineIdx = lineStart; lineIdx < lineEnd; lineIdx++) {
+        if (!isLineChanged || (*isLineChanged)[lineIdx]) {
+            lineVersions[lineIdx] = curvePointsVersion;
+        }
+    }
+}
+
+void ChordDiagramModel::resetCurvesDirty() {
+    dirtyLineStart = dirtyLineEnd = 0;
+    curveOffsetsChanged = false;
+    dirtyBaseVersion = curvePointsVersion;
+}
+
+void ChordDiagramModel::setBeta(float _beta) {
+    if (beta == _beta) {
+        return;
+    }
+    beta = _beta;
+    if (!isTessellated || numLinesTotal == 0) {
+        return;
+    }
+    if (useBetaBlendCache) {
+        blendCurves(0, numLinesTotal);
+        markCurvesDirty(0, numLinesTotal, false);
+    } else {
+        tessellateCurves(0);
+    }
+}
+
+void ChordDiagramModel::setUseAdaptiveSubdivision(bool _useAdaptiveSubdivision) {
+    if (useAdaptiveSubdivision != _useAdaptiveSubdivision) {
+        useAdaptiveSubdivision = _useAdaptiveSubdivision;
+        invalidateTessellation();
+    }
+}
+
+void ChordDiagramModel::setSubdivisionTolerancePx(float _subdivisionTolerancePx) {
+    if (subdivisionTolerancePx != _subdivisionTolerancePx) {
+        subdivisionTolerancePx = _subdivisionTolerancePx;
+        invalidateTessellation();
+    }
+}
+
+void ChordDiagramModel::setNumSubdivisions(int _numSubdivisions) {
+    _numSubdivisions = std::max(_numSubdivisions, 2);
+    if (numSubdivisions != _numSubdivisions) {
+        numSubdivisions = _numSubdivisions;
+        invalidateTessellation();
+    }
+}
+
+void ChordDiagramModel::setSplineOrder(int _splineOrder) {
+    _splineOrder = std::clamp(_splineOrder, 1, BSPLINE_MAX_STACK_ORDER);
+    if (splineOrder != _splineOrder) {
+        splineOrder = _splineOrder;
+        updateCurveGroups();
+        invalidateTessellation();
+    }
+}
+
+void ChordDiagramModel::setUseBetaBlendCache(bool _useBetaBlendCache) {
+    if (useBetaBlendCache != _useBetaBlendCache) {
+        useBetaBlendCache = _useBetaBlendCache;
+        invalidateTessellation();
+    }
+}
+
+bool ChordDiagramModel::getNeedsTessellation(float radiusPx) const {
+    if (!isTessellated) {
+        return true;
+    }
+    // Only re-tessellate if the curves were flattened for a significantly different radius.
+    return useAdaptiveSubdivision && numLinesTotal > 0 && (radiusPx > tessellationRadiusPx
+            || radiusPx * TESSELLATION_RADIUS_HEADROOM * TESSELLATION_RADIUS_HEADROOM < tessellationRadiusPx);
+}
+
+void ChordDiagramModel::tessellate(float radiusPx) {
+    tessellationRadiusPx = std::max(radiusPx * TESSELLATION_RADIUS_HEADROOM, 1.0f);
+    tessellateCurves(0);
+    isTessellated = true;
+}
+
+void ChordDiagramModel::tessellateCurves(int lineStart) {
+    computeCurveSampleCounts(lineStart, numLinesTotal);
+    computeCurveOffsets(lineStart);
+    if (useBetaBlendCache) {
+        curvePointsBundled.resize(curvePoints.size());
+        curvePointsStraight.resize(curvePoints.size());
+        evaluateCurves(lineStart, numLinesTotal, 1.0f, curvePointsBundled.data());
+        evaluateCurves(lineStart, numLinesTotal, 0.0f, curvePointsStraight.data());
+        blendCurves(lineStart, numLinesTotal);
+    } else {
+        curvePointsBundled = {};
+        curvePointsStraight = {};
+        evaluateCurves(lineStart, numLinesTotal, beta, curvePoints.data());
+    }
+    markCurvesDirty(lineStart, numLinesTotal, true);
+}
+
+uint32_t ChordDiagramModel::computeCurveNumSamples(int lineIdx, glm::vec2* linePoints, float radiusPx) const {
+    if (!useAdaptiveSubdivision) {
+        return uint32_t(numSubdivisions);
+    }
+    // With the blend cache, the sample count must be valid for all beta in [0, 1]. As the curve is linear in beta,
+    // the maximum of the bounds at beta = 0 and beta = 1 is an upper bound.
+    int numControlPoints = getLineControlPoints(lineIdx, linePoints, useBetaBlendCache ? 1.0f : beta);
+    const BSplineKnotVector& knotVector = knotVectors[numControlPoints];
+    float secondDerivativeBound = computeBSplineSecondDerivativeBound(knotVector, linePoints);
+    if (useBetaBlendCache) {
+        getLineControlPoints(lineIdx, linePoints, 0.0f);
+        secondDerivativeBound = std::max(
+                secondDerivativeBound, computeBSplineSecondDerivativeBound(knotVector, linePoints));
+    }
+    int numSegments = getNumFlatteningSegments(
+            secondDerivativeBound * radiusPx, subdivisionTolerancePx, MAX_ADAPTIVE_SUBDIVISIONS);
+    return uint32_t(numSegments + 1);
+}
+
+void ChordDiagramModel::computeCurveSampleCounts(int lineStart, int lineEnd) {
+    // The number of samples of each curve is stored shifted by one for the prefix sum in computeCurveOffsets.
+    curveOffsets.resize(numLinesTotal + 1);
+    parallelForChunks(lineEnd - lineStart, CURVE_CHUNK_SIZE, [&](int threadIdx, int begin, int end) {
+        glm::vec2 linePoints[HEB_MAX_CONTROL_POINTS];
+        for (int lineIdx = lineStart + begin; lineIdx < lineStart + end; lineIdx++) {
+            curveOffsets[lineIdx + 1] = computeCurveNumSamples(lineIdx, linePoints, tessellationRadiusPx);
+        }
+    });
+}
+
+void ChordDiagramModel::computeCurveOffsets(int lineStart) {
+    // Prefix sum and basis tables for all (control point count, sample count) pairs in use.
+    if (lineStart == 0) {
+        curveOffsets[0] = 0;
+    }
+    for (int lineIdx = lineStart; lineIdx < numLinesTotal; lineIdx++) {
+        auto numControlPoints = int(edges[lineIdx].numControlPoints);
+        uint32_t numSamples = curveOffsets[lineIdx + 1];
+        basisTableCache.getOrCreate(getLineOrder(numControlPoints), numControlPoints, int(numSamples));
+        curveOffsets[lineIdx + 1] += curveOffsets[lineIdx];
+    }
+    curvePoints.resize(curveOffsets[numLinesTotal]);
+}
+
+void ChordDiagramModel::evaluateCurves(int lineStart, int lineEnd, float polygonBeta, glm::vec2* target) {
+    if (!useAdaptiveSubdivision) {
+        // All curves of a group share the same order, number of control points and sample parameters and can be
+        // evaluated with the SIMD kernels. Each chunk of lines writes to its own range of target, so the output does
+        // not depend on the scheduling.
+        threadControlPoints.resize(getMaxNumParallelThreads());
+        for (const CurveGroup& group : curveGroups) {
+            int groupStart = std::max(group.lineStart, lineStart);
+            int groupEnd = std::min(group.lineEnd, lineEnd);
+            if (groupStart >= groupEnd) {
+                continue;
+            }
+            const int numControlPoints = group.numControlPoints;
+            const BSplineBasisTable* basisTable = basisTableCache.get(
+                    getLineOrder(numControlPoints), numControlPoints, numSubdivisions);
+            parallelForChunks(groupEnd - groupStart, CURVE_CHUNK_SIZE, [&](int threadIdx, int begin, int end) {
+                begin += groupStart;
+                end += groupStart;
+                BSplineControlPointsSoA& controlPoints = threadControlPoints.at(threadIdx);
+                controlPoints.resize(end - begin, numControlPoints);
+                glm::vec2 linePoints[HEB_MAX_CONTROL_POINTS];
+                for (int lineIdx = begin; lineIdx < end; lineIdx++) {
+                    getLineControlPoints(lineIdx, linePoints, polygonBeta);
+                    for (int cpIdx = 0; cpIdx < numControlPoints; cpIdx++) {
+                        controlPoints.set(lineIdx - begin, cpIdx, linePoints[cpIdx]);
+                    }
+                }
+                evaluateBSplineCurvesSoA(
+                        *basisTable, controlPoints.x.data(), controlPoints.y.data(), controlPoints.stride,
+                        controlPoints.numCurves, target + curveOffsets[begin], simdLevel);
+            });
+        }
+        return;
+    }
+
+    // Adaptive subdivision: Evaluate the curves into their variable-length ranges.
+    parallelForChunks(lineEnd - lineStart, CURVE_CHUNK_SIZE, [&](int threadIdx, int begin, int end) {
+        glm::vec2 linePoints[HEB_MAX_CONTROL_POINTS];
+        for (int lineIdx = lineStart + begin; lineIdx < lineStart + end; lineIdx++) {
+            evaluateCurve(lineIdx, polygonBeta, linePoints, target);
+        }
+    });
+}
+
+void ChordDiagramModel::evaluateCurve(int lineIdx, float polygonBeta, glm::vec2* linePoints, glm::vec2* target) const {
+    int numControlPoints = getLineControlPoints(lineIdx, linePoints, polygonBeta);
+    uint32_t offset = curveOffsets[lineIdx];
+    uint32_t numSamples = curveOffsets[lineIdx + 1] - offset;
+    const BSplineBasisTable* basisTable = basisTableCache.get(
+            getLineOrder(numControlPoints), numControlPoints, int(numSamples));
+    evaluateBSplineCurves(*basisTable, linePoints, 1, target + offset);
+}
+
+void ChordDiagramModel::blendCurves(int lineStart, int lineEnd) {
+    // The curves are linear in their control points, and the control points are linear in beta.
+    const glm::vec2* bundled = curvePointsBundled.data();
+    const glm::vec2* straight = curvePointsStraight.data();
+    glm::vec2* target = curvePoints.data();
+    const float b = beta;
+    parallelForChunks(lineEnd - lineStart, CURVE_CHUNK_SIZE, [&](int threadIdx, int begin, int end) {
+        uint32_t ptStart = curveOffsets[lineStart + begin];
+        uint32_t ptEnd = curveOffsets[lineStart + end];
+        for (uint32_t ptIdx = ptStart; ptIdx < ptEnd; ptIdx++) {
+            target[ptIdx] = b * bundled[ptIdx] + (1.0f - b) * straight[ptIdx];
+        }
+    });
+}
+
+void ChordDiagramModel::setEdgeWeights(const std::vector<float>& weights) {
+    if (weights.size() < size_t(numLinesTotal)) {
+        throw std::runtime_error("Error in ChordDiagramModel::setEdgeWeights: Too few weights.");
+    }
+    for (int lineIdx = 0; lineIdx < numLinesTotal; lineIdx++) {
+        edges[lineIdx].weight = weights[lineIdx];
+    }
+    edgeWeightsVersion++;
+}
+
+void ChordDiagramModel::addEdges(
+        const std::vector<std::pair<uint32_t, uint32_t>>& newEdges, const std::vector<float>& weights) {
+    if (newEdges.empty()) {
+        return;
+    }
+    // Everything is checked before the model is changed.
+    validateEdges("addEdges", newEdges, weights);
+    if (newEdges.size() > size_t(std::numeric_limits<int>::max() - numLinesTotal)) {
+        throw std::runtime_error("Error in ChordDiagramModel::addEdges: Too many edges.");
+    }
+    int lineStart = numLinesTotal;
+    edges.resize(edges.size() + newEdges.size());
+    for (size_t i = 0; i < newEdges.size(); i++) {
+        HEBEdge& edge = edges[size_t(lineStart) + i];
+        edge.pointIdx0 = newEdges[i].first;
+        edge.pointIdx1 = newEdges[i].second;
+        edge.weight = weights.empty() ? 1.0f : weights[i];
+    }
+    hebTree.updateEdgePaths(edges.data() + lineStart, newEdges.size());
+    numLinesTotal = int(edges.size());
+    controlPolygonsVersion++;
+    edgeWeightsVersion++;
+
+    // New edges are appended unsorted; the groups then merely consist of more runs.
+    updateCurveGroups();
+    if (isTessellated) {
+        tessellateCurves(lineStart);
+    }
+}
+
+void ChordDiagramModel::removeEdges(std::vector<int> lineIndices) {
+    std::sort(lineIndices.begin(), lineIndices.end());
+    lineIndices.erase(std::unique(lineIndices.begin(), lineIndices.end()), lineIndices.end());
+    if (lineIndices.empty()) {
+        return;
+    }
+    if (lineIndices.front() < 0 || lineIndices.back() >= numLinesTotal) {
+        throw std::runtime_error("Error in ChordDiagramModel::removeEdges: Line index out of range.");
+    }
+
+    // Compact the edges and their curve point ranges in place.
+    int firstRemovedLine = lineIndices.front();
+    size_t removeIdx = 0;
+    int newLineIdx = firstRemovedLine;
+    uint32_t newOffset = isTessellated ? curveOffsets[firstRemovedLine] : 0;
+    for (int lineIdx = firstRemovedLine; lineIdx < numLinesTotal; lineIdx++) {
+        if (removeIdx < lineIndices.size() && lineIndices[removeIdx] == lineIdx) {
+            removeIdx++;
+            continue;
+        }
+        if (isTessellated) {
+            uint32_t ptStart = curveOffsets[lineIdx];
+            uint32_t numSamples = curveOffsets[lineIdx + 1] - ptStart;
+            if (ptStart != newOffset) {
+                std::copy_n(curvePoints.begin() + ptStart, numSamples, curvePoints.begin() + newOffset);
+                if (useBetaBlendCache) {
+                    std::copy_n(
+                            curvePointsBundled.begin() + ptStart, numSamples, curvePointsBundled.begin() + newOffset);
+                    std::copy_n(
+                            curvePointsStraight.begin() + ptStart, numSamples, curvePointsStraight.begin() + newOffset);
+                }
+            }
+            curveOffsets[newLineIdx] = newOffset;
+            newOffset += numSamples;
+        }
+        edges[newLineIdx] = edges[lineIdx];
+        newLineIdx++;
+    }
+    numLinesTotal = newLineIdx;
+    edges.resize(numLinesTotal);
+    controlPolygonsVersion++;
+    edgeWeightsVersion++;
+    updateCurveGroups();
+    if (!isTessellated) {
+        return;
+    }
+    curveOffsets.resize(numLinesTotal + 1);
+    curveOffsets[numLinesTotal] = newOffset;
+    curvePoints.resize(newOffset);
+    if (useBetaBlendCache) {
+        curvePointsBundled.resize(newOffset);
+        curvePointsStraight.resize(newOffset);
+    }
+    markCurvesDirty(firstRemovedLine, numLinesTotal, true);
+}
+
+void ChordDiagramModel::setNodePositions(
+        const std::vector<uint32_t>& nodeIndices, const std::vector<glm::vec2>& positions) {
+    if (nodeIndices.empty()) {
+        return;
+    }
+    bool isIndexOutOfRange = std::any_of(
+            nodeIndices.begin(), nodeIndices.end(), [this](uint32_t nodeIdx) { return nodeIdx >= nodes.size(); });
+    if (isIndexOutOfRange || positions.size() != nodeIndices.size()) {
+        throw std::runtime_error("Error in ChordDiagramModel::setNodePositions: Invalid node indices or positions.");
+    }
+    std::vector<uint8_t> isNodeChanged(nodes.size(), 0);
+    for (size_t i = 0; i < nodeIndices.size(); i++) {
+        HEBNode& node = nodes.at(nodeIndices[i]);
+        node.normalizedPosition = positions.at(i);
+        node.angle = std::atan2(node.normalizedPosition.y, node.normalizedPosition.x);
+        isNodeChanged[nodeIndices[i]] = 1;
+    }
+    controlPolygonsVersion++;
+    if (!isTessellated || numLinesTotal == 0) {
+        return;
+    }
+
+    // A curve is affected if any node on its tree path moved.
+    std::vector<uint8_t> isLineAffected(numLinesTotal, 0);
+    parallelForChunks(numLinesTotal, CURVE_CHUNK_SIZE, [&](int threadIdx, int begin, int end) {
+        for (int lineIdx = begin; lineIdx < end; lineIdx++) {
+            const HEBEdge& edge = edges[lineIdx];
+            bool affected = isNodeChanged[edge.lcaIdx] != 0;
+            for (uint32_t pointIdx : { edge.pointIdx0, edge.pointIdx1 }) {
+                for (uint32_t nodeIdx = leafIdxOffset + pointIdx; !affected && nodeIdx != edge.lcaIdx;
+                        nodeIdx = nodes[nodeIdx].parentIdx) {
+                    affected = isNodeChanged[nodeIdx] != 0;
+                }
+            }
+            isLineAffected[lineIdx] = affected ? 1 : 0;
+        }
+    });
+
+    // Patch the affected curves in place if their sample count did not change, and re-tessellate otherwise.
+    std::atomic<bool> sampleCountsChanged{false};
+    std::vector<int> threadDirtyStart(getMaxNumParallelThreads(), numLinesTotal);
+    std::vector<int> threadDirtyEnd(getMaxNumParallelThreads(), 0);
+    parallelForChunks(numLinesTotal, CURVE_CHUNK_SIZE, [&](int threadIdx, int begin, int end) {
+        glm::vec2 linePoints[HEB_MAX_CONTROL_POINTS];
+        for (int lineIdx = begin; lineIdx < end; lineIdx++) {
+            if (!isLineAffected[lineIdx]) {
+                continue;
+            }
+            if (computeCurveNumSamples(lineIdx, linePoints, tessellationRadiusPx)
+                    != curveOffsets[lineIdx + 1] - curveOffsets[lineIdx]) {
+                sampleCountsChanged = true;
+                return;
+            }
+            if (useBetaBlendCache) {
+                evaluateCurve(lineIdx, 1.0f, linePoints, curvePointsBundled.data());
+                evaluateCurve(lineIdx, 0.0f, linePoints, curvePointsStraight.data());
+            } else {
+                evaluateCurve(lineIdx, beta, linePoints, curvePoints.data());
+            }
+            threadDirtyStart[threadIdx] = std::min(threadDirtyStart[threadIdx], lineIdx);
+            threadDirtyEnd[threadIdx] = std::max(threadDirtyEnd[threadIdx], lineIdx + 1);
+        }
+    });
+    if (sampleCountsChanged) {
+        tessellateCurves(0);
+        return;
+    }
+    int dirtyStart = *std::min_element(threadDirtyStart.begin(), threadDirtyStart.end());
+    int dirtyEnd = *std::max_element(threadDirtyEnd.begin(), threadDirtyEnd.end());
+    if (dirtyStart < dirtyEnd) {
+        if (useBetaBlendCache) {
+            blendCurves(dirtyStart, dirtyEnd);
+        }
+        markCurvesDirty(dirtyStart, dirtyEnd, false, &isLineAffected);
+    }
+}
@@ -0,0 +1,233 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CHORDDIAGRAMMODEL_HPP
+#define CHORDDIAGRAMMODEL_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <glm/vec2.hpp>
+
+#include "BSpline.hpp"
+#include "BSplineSimd.hpp"
+#include "HEBTree.hpp"
+
+/**
+ * Geometry of a hierarchically bundled chord diagram independent of any window or render backend: the node hierarchy,
+ * the edges and their tessellated B-spline curves. The curves are stored in one contiguous buffer (see
+ * @see getCurvePoints and @see getCurveOffsets) in normalized coordinates, i.e., the leaves lie on the unit circle.
+ * Renderers only read from the model. All modifications, including the tessellation (@see tessellate) and resetting
+ * the dirty range (@see resetCurvesDirty), are done by the single owner of the model outside of rendering (e.g., by
+ * DiagramBase::update of the owning diagram). The model is not internally synchronized, so it must not be modified
+ * while another thread reads from it.
+ */
+class ChordDiagramModel {
+public:
+    ChordDiagramModel();
+    // The model ID must not be shared, so models are not copyable.
+    ChordDiagramModel(const ChordDiagramModel&) = delete;
+    ChordDiagramModel& operator=(const ChordDiagramModel&) = delete;
+
+    /**
+     * Unique in the process and never reused, unlike the address of a destroyed model. Caches key on the ID and the
+     * version counters below, which only increase within one model.
+     */
+    [[nodiscard]] inline uint64_t getModelId() const { return modelId; }
+
+    // Nodes.
+    /// Builds a balanced radial hierarchy with numLeaves leaves (see @see HEBTree::buildRadialHierarchy).
+    void buildRadialHierarchy(int numLeaves, int branchingFactor);
+    /**
+     * Sets the hierarchy; parents must precede their children, and the leaves are stored starting at leafIdxOffset.
+     * Removes all edges. Throws std::runtime_error for invalid hierarchies (see @see HEBTree::validateHierarchy); the
+     * model is left unchanged in this case.
+     */
+    void setNodes(std::vector<HEBNode> _nodes, uint32_t _leafIdxOffset);
+    [[nodiscard]] inline const std::vector<HEBNode>& getNodes() const { return nodes; }
+    [[nodiscard]] inline uint32_t getLeafIdxOffset() const { return leafIdxOffset; }
+    [[nodiscard]] inline int getNumLeaves() const { return int(nodes.size()) - int(leafIdxOffset); }
+    [[nodiscard]] inline const HEBTree& getHEBTree() const { return hebTree; }
+    /// Moves nodes (normalized coordinates) and only recomputes the curves passing through them.
+    void setNodePositions(const std::vector<uint32_t>& nodeIndices, const std::vector<glm::vec2>& positions);
+
+    // Edges. The lines are sorted by their number of control points after setEdges; added edges are appended.
+    /**
+     * Replaces all edges by edges between the passed pairs of leaf indices. The weights default to one if not passed.
+     * The edit functions throw std::runtime_error for out-of-range indices or mismatching weights; the model is left
+     * unchanged in this case.
+     */
+    void setEdges(
+            const std::vector<std::pair<uint32_t, uint32_t>>& newEdges, const std::vector<float>& weights = {});
+    void addEdges(
+            const std::vector<std::pair<uint32_t, uint32_t>>& newEdges, const std::vector<float>& weights = {});
+    /**
+     * Replaces all edges by numEdges packed records of recordStride bytes, each starting with the uint32_t leaf indices
+     * and a float weight (see @see GraphFileEdge). The records are read in place and the edges are scattered directly
+     * into their sorted positions, so no intermediate copy of the edge list is made. The weights are multiplied by
+     * weightScale and clamped to [0, 1]. Throws std::runtime_error if a leaf index is out of range; the model is left
+     * unchanged in this case.
+     */
+    void setEdgesFromRecords(const uint8_t* records, size_t numEdges, size_t recordStride, float weightScale = 1.0f);
+    void removeEdges(std::vector<int> lineIndices);
+    [[nodiscard]] inline const std::vector<HEBEdge>& getEdges() const { return edges; }
+    [[nodiscard]] inline int getNumLines() const { return numLinesTotal; }
+    /// Sets the weights of all lines (in line order); the curves are not affected.
+    void setEdgeWeights(const std::vector<float>& weights);
+    /// Incremented whenever edge weights change, i.e., on edge changes or by @see setEdgeWeights.
+    [[nodiscard]] inline uint64_t getEdgeWeightsVersion() const { return edgeWeightsVersion; }
+    /// Incremented whenever the control polygons change, i.e., on node, edge or layout changes (but not for beta).
+    [[nodiscard]] inline uint64_t getControlPolygonsVersion() const { return controlPolygonsVersion; }
+
+    // Tessellation settings. Changing a setting invalidates the tessellation unless stated otherwise.
+    [[nodiscard]] inline float getBeta() const { return beta; }
+    /// Changing beta only blends the cached curves if the beta blend cache is used.
+    void setBeta(float _beta);
+    void setUseAdaptiveSubdivision(bool _useAdaptiveSubdivision);
+    [[nodiscard]] inline bool getUseAdaptiveSubdivision() const { return useAdaptiveSubdivision; }
+    void setSubdivisionTolerancePx(float _subdivisionTolerancePx);
+    /// Number of samples per curve if adaptive subdivision is not used.
+    void setNumSubdivisions(int _numSubdivisions);
+    [[nodiscard]] inline int getNumSubdivisions() const { return numSubdivisions; }
+    /// Maximum spline order; curves with fewer control points use their number of control points as order.
+    void setSplineOrder(int _splineOrder);
+    [[nodiscard]] inline int getSplineOrder() const { return splineOrder; }
+    void setUseBetaBlendCache(bool _useBetaBlendCache);
+    /// Only affects performance, as all SIMD levels produce the same curves up to rounding.
+    inline void setSimdLevel(SimdLevel _simdLevel) { simdLevel = _simdLevel; }
+
+    /**
+     * Returns whether the curves need to be (re-)tessellated for rendering with the passed chart radius in pixels.
+     * The curves are tessellated for a radius larger than the current one to avoid re-tessellation on small resizes.
+     */
+    [[nodiscard]] bool getNeedsTessellation(float radiusPx) const;
+    void tessellate(float radiusPx);
+    [[nodiscard]] inline bool getIsTessellated() const { return isTessellated; }
+
+    // Output.
+    [[nodiscard]] inline const std::vector<glm::vec2>& getCurvePoints() const { return curvePoints; }
+    /// Offset of each curve in the curve point buffer; size getNumLines() + 1.
+    [[nodiscard]] inline const std::vector<uint32_t>& getCurveOffsets() const { return curveOffsets; }
+
+    /*
+     * Dirty tracking for consumers of the curve points with cached geometry. [dirtyLineStart, dirtyLineEnd) is the
+     * range of lines changed since the last call to resetCurvesDirty. getCurveOffsetsChanged returns true if lines were
+     * added, removed or re-tessellated with different sample counts.
+     * The curve points version is incremented on every change. A consumer whose cached version is older than the
+     * dirty base version (i.e., the version at the last reset, e.g., by another consumer) must rebuild its cache.
+     * As the dirty range may contain unchanged lines (e.g., when moving a node), the line version, i.e., the curve
+     * points version of the last change of a line, can be used to skip lines not changed since a cached version.
+     */
+    [[nodiscard]] inline uint64_t getCurvePointsVersion() const { return curvePointsVersion; }
+    [[nodiscard]] inline uint64_t getDirtyBaseVersion() const { return dirtyBaseVersion; }
+    [[nodiscard]] inline bool getIsCurvesDirty() const { return dirtyLineStart < dirtyLineEnd || curveOffsetsChanged; }
+    [[nodiscard]] inline int getDirtyLineStart() const { return dirtyLineStart; }
+    [[nodiscard]] inline int getDirtyLineEnd() const { return dirtyLineEnd; }
+    [[nodiscard]] inline bool getCurveOffsetsChanged() const { return curveOffsetsChanged; }
+    [[nodiscard]] inline uint64_t getLineVersion(int lineIdx) const { return lineVersions[lineIdx]; }
+    void resetCurvesDirty();
+
+private:
+    /// Throws std::runtime_error if a leaf index is out of range or weights is neither empty nor of matching size.
+    void validateEdges(
+            const char* functionName, const std::vector<std::pair<uint32_t, uint32_t>>& newEdges,
+            const std::vector<float>& weights) const;
+    void updateEdgePaths();
+    void updateCurveGroups();
+    void invalidateTessellation();
+    /// Only the lines with isLineChanged[lineIdx] != 0 in the range get a new line version if isLineChanged is passed.
+    void markCurvesDirty(
+            int lineStart, int lineEnd, bool offsetsChanged, const std::vector<uint8_t>* isLineChanged = nullptr);
+
+    const uint64_t modelId;
+
+    // Nodes and edges.
+    std::vector<HEBNode> nodes;
+    uint32_t leafIdxOffset = 0; //< The leaves are stored at the end of nodes.
+    HEBTree hebTree;
+    std::vector<HEBEdge> edges; //< One curve per edge.
+    int numLinesTotal = 0;
+    uint64_t controlPolygonsVersion = 0;
+    uint64_t edgeWeightsVersion = 0;
+    struct CurveGroup {
+        int lineStart, lineEnd; //< Range of lines with the same number of control points.
+        int numControlPoints;
+    };
+    std::vector<CurveGroup> curveGroups;
+
+    // Parallel curve tessellation.
+    /// Writes the control points of the line (at most HEB_MAX_CONTROL_POINTS) and returns their number.
+    int getLineControlPoints(int lineIdx, glm::vec2* linePoints, float polygonBeta) const;
+    [[nodiscard]] inline int getLineOrder(int numControlPoints) const {
+        return std::min(numControlPoints, splineOrder);
+    }
+    [[nodiscard]] uint32_t computeCurveNumSamples(int lineIdx, glm::vec2* linePoints, float radiusPx) const;
+    void computeCurveSampleCounts(int lineStart, int lineEnd);
+    void computeCurveOffsets(int lineStart); //< Also resizes curvePoints.
+    void evaluateCurves(int lineStart, int lineEnd, float polygonBeta, glm::vec2* target);
+    void evaluateCurve(int lineIdx, float polygonBeta, glm::vec2* linePoints, glm::vec2* target) const;
+    /// Tessellates [lineStart, numLinesTotal) for the current tessellation radius.
+    void tessellateCurves(int lineStart);
+    float beta = 0.75f;
+    int numSubdivisions = 50;
+    int splineOrder = 4;
+    SimdLevel simdLevel;
+    std::vector<glm::vec2> curvePoints;
+    std::vector<uint32_t> curveOffsets;
+    BSplineBasisTableCache basisTableCache;
+    std::vector<BSplineKnotVector> knotVectors; //< Indexed by the number of control points.
+    static constexpr int CURVE_CHUNK_SIZE = 1024; //< Lines per task; a multiple of the widest SIMD width.
+    static constexpr int EDGE_RECORD_CHUNK_SIZE = 1 << 16; //< Edge records per task in @see setEdgesFromRecords.
+    std::vector<BSplineControlPointsSoA> threadControlPoints; //< Per-thread scratch buffers.
+    bool isTessellated = false;
+
+    // Adaptive subdivision with a maximum deviation of subdivisionTolerancePx from the exact curve.
+    bool useAdaptiveSubdivision = true;
+    float subdivisionTolerancePx = 0.25f;
+    static constexpr int MAX_ADAPTIVE_SUBDIVISIONS = 256;
+    static constexpr float TESSELLATION_RADIUS_HEADROOM = 1.25f;
+    float tessellationRadiusPx = 0.0f; //< Radius the adaptive tessellation is valid up to.
+
+    /*
+     * Beta blending: The curves for beta = 1 (bundled) and beta = 0 (straight) are cached, so changing beta only
+     * requires a linear blend of the two instead of a re-tessellation.
+     */
+    void blendCurves(int lineStart, int lineEnd);
+    bool useBetaBlendCache = true;
+    std::vector<glm::vec2> curvePointsBundled;
+    std::vector<glm::vec2> curvePointsStraight;
+
+    int dirtyLineStart = 0, dirtyLineEnd = 0;
+    bool curveOffsetsChanged = false;
+    uint64_t curvePointsVersion = 0;
+    uint64_t dirtyBaseVersion = 0;
+    std::vector<uint64_t> lineVersions;
+};
+
+#endif //CHORDDIAGRAMMODEL_HPP
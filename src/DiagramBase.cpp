@@ -27,6 +27,9 @@
  */
 
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <limits>
 #include <random>
 
 #ifdef SUPPORT_SKIA
@@ -39,19 +42,37 @@
 
 #include <Math/Geometry/AABB2.hpp>
 #include <Utils/AppSettings.hpp>
+#include <Utils/File/Logfile.hpp>
 #include <Input/Mouse.hpp>
 #include <Math/Math.hpp>
 #include <Graphics/Vector/VectorBackendNanoVG.hpp>
 #include <Graphics/Vector/nanovg/nanovg.h>
+#include <Graphics/Vulkan/Render/Renderer.hpp>
 #include <ImGui/ImGuiWrapper.hpp>
 
-#include "BSpline.hpp"
+#include "GraphFile.hpp"
+#include "ParallelFor.hpp"
+#include "VectorBackendCurvesVk.hpp"
+#include "VectorBackendNanoVGProfiled.hpp"
+#include "VectorBackendNanoVGPipelined.hpp"
+#include "VectorBackendRasterCpu.hpp"
 #include "DiagramBase.hpp"
 
 DiagramBase::DiagramBase() {
     sgl::NanoVGSettings nanoVgSettings{};
     nanoVgSettings.renderBackend = sgl::RenderSystem::OPENGL;
-    registerRenderBackendIfSupported<sgl::VectorBackendNanoVG>([this]() { this->renderBaseNanoVG(); }, nanoVgSettings);
+    registerRenderBackendIfSupported<VectorBackendNanoVGProfiled>(
+            [this]() { this->renderBaseNanoVG(); }, nanoVgSettings);
+    registerRenderBackendIfSupported<VectorBackendCurvesVk>([this]() { this->renderBaseCurvesVk(); });
+    registerRenderBackendIfSupported<VectorBackendNanoVGPipelined>([this]() { this->renderBaseNanoVGPipelined(); });
+    registerRenderBackendIfSupported<VectorBackendRasterCpu>([this]() { this->renderBaseRasterCpu(); });
+}
+
+DiagramBase::~DiagramBase() {
+    // The worker cannot be interrupted, so wait for it to not leave it running with a destroyed widget.
+    if (asyncBuildFuture.valid()) {
+        asyncBuildFuture.wait();
+    }
 }
 
 void DiagramBase::initialize() {
@@ -61,41 +82,175 @@ void DiagramBase::initialize() {
     windowHeight = (200 + borderSizeY) * 2.0f;
     _initialize();
 
-    const int numPoints = 25;
-    nodesList.resize(numPoints);
+    resetSelection();
+    needsReRender = true;
+    computeChartRadius();
+    float radiusPx = chartRadius * scaleFactor;
+    if (model) {
+        prepareOwnedModel();
+        return;
+    }
+
+    auto buildFunction = [
+            numPoints = 25, filePath = graphFilePath, branchingFactor = hierarchyBranchingFactor, modelBeta = beta,
+            radiusPx]() {
+        if (!filePath.empty()) {
+            return buildGraphFileModel(filePath, branchingFactor, modelBeta, radiusPx);
+        }
+        return buildTestModel(numPoints, branchingFactor, modelBeta, radiusPx);
+    };
+    if (useAsyncBuild) {
+        asyncBuildFuture = std::async(std::launch::async, buildFunction);
+    } else {
+        model = buildFunction();
+    }
+}
+
+std::shared_ptr<ChordDiagramModel> DiagramBase::buildTestModel(
+        int numPoints, int branchingFactor, float modelBeta, float radiusPx) {
+    auto newModel = std::make_shared<ChordDiagramModel>();
+    newModel->setBeta(modelBeta);
+    newModel->buildRadialHierarchy(numPoints, branchingFactor);
+    std::vector<std::pair<uint32_t, uint32_t>> edgeList;
     for (int i = 0; i < numPoints; i++) {
-        float angle = sgl::TWO_PI * (float)i / (float)numPoints;
-        nodesList[i].normalizedPosition = glm::vec2(std::cos(angle), std::sin(angle));
+        for (int j = i + 1; j < numPoints; j++) {
+            edgeList.emplace_back(uint32_t(i), uint32_t(j));
+        }
     }
+    newModel->setEdges(edgeList);
+    newModel->tessellate(radiusPx);
+    return newModel;
+}
 
-    std::vector<glm::vec2> controlPoints;
-    numLinesTotal = numPoints * numPoints;
-    curvePoints.resize(numLinesTotal * NUM_SUBDIVISIONS);
-    for (int lineIdx = 0; lineIdx < numLinesTotal; lineIdx++) {
-        int i = lineIdx / numPoints;
-        int j = lineIdx % numPoints;
-        glm::vec2 pt0 = nodesList[i].normalizedPosition;
-        glm::vec2 pt1 = nodesList[j].normalizedPosition;
-        glm::vec2 ptx = glm::vec2(-0.1f, 0.1f);
-        glm::vec2 pty = glm::vec2(0.1f, -0.1f);
-        controlPoints.clear();
-        controlPoints.push_back(pt0);
-        controlPoints.push_back(ptx);
-        controlPoints.push_back(pty);
-        controlPoints.push_back(pt1);
-
-        for (int ptIdx = 0; ptIdx < NUM_SUBDIVISIONS; ptIdx++) {
-            float t = float(ptIdx) / float(NUM_SUBDIVISIONS - 1);
-            int k = 4;
-            if (controlPoints.size() == 3) {
-                k = 3;
-            }
-            curvePoints.at(lineIdx * NUM_SUBDIVISIONS + ptIdx) = evaluateBSpline(t, k, controlPoints);
+std::shared_ptr<ChordDiagramModel> DiagramBase::buildGraphFileModel(
+        const std::string& filePath, int branchingFactor, float modelBeta, float radiusPx) {
+    auto newModel = std::make_shared<ChordDiagramModel>();
+    newModel->setBeta(modelBeta);
+    {
+        // The mapping is released before tessellating, as the edges are copied to the model.
+        GraphFile graphFile(filePath);
+        graphFile.loadIntoModel(*newModel, branchingFactor);
+    }
+    newModel->tessellate(radiusPx);
+    return newModel;
+}
+
+bool DiagramBase::publishAsyncBuild(bool wait) {
+    if (!asyncBuildFuture.valid()) {
+        return false;
+    }
+    if (!wait && asyncBuildFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return false;
+    }
+    // A failed build, e.g., due to a corrupt graph file, keeps the previous (or empty) model.
+    std::shared_ptr<ChordDiagramModel> newModel;
+    try {
+        newModel = asyncBuildFuture.get();
+    } catch (const std::exception& exception) {
+        asyncBuildErrorMessage = exception.what();
+        sgl::Logfile::get()->writeError(asyncBuildErrorMessage);
+        needsReRender = true;
+        return false;
+    }
+    asyncBuildErrorMessage.clear();
+    model = std::move(newModel);
+    isModelOwner = true;
+    model->setBeta(beta);
+    cachedModel = nullptr;
+    drawOrderModel = nullptr;
+    spatialIndex.clear();
+    resetSelection();
+    needsReRender = true;
+    return true;
+}
+
+void DiagramBase::setModel(const std::shared_ptr<ChordDiagramModel>& _model, bool _isModelOwner) {
+    publishAsyncBuild(true);
+    model = _model;
+    isModelOwner = _isModelOwner;
+    cachedModel = nullptr;
+    drawOrderModel = nullptr;
+    spatialIndex.clear();
+    if (model) {
+        beta = model->getBeta();
+    }
+    resetSelection();
+    needsReRender = true;
+}
+
+void DiagramBase::resetSelection() {
+    selectedLineIdx = -1;
+    selectedPointIndices[0] = -1;
+    selectedPointIndices[1] = -1;
+}
+
+void DiagramBase::setBeta(float _beta) {
+    if (beta == _beta) {
+        return;
+    }
+    beta = _beta;
+    if (model) {
+        model->setBeta(beta);
+        needsReRender = true;
+    }
+}
+
+void DiagramBase::addEdges(
+        const std::vector<std::pair<uint32_t, uint32_t>>& newEdges, const std::vector<float>& weights) {
+    publishAsyncBuild(true);
+    if (model && !newEdges.empty()) {
+        model->addEdges(newEdges, weights);
+        needsReRender = true;
+    }
+}
+
+void DiagramBase::removeEdges(std::vector<int> lineIndices) {
+    publishAsyncBuild(true);
+    if (!model || lineIndices.empty()) {
+        return;
+    }
+    std::sort(lineIndices.begin(), lineIndices.end());
+    lineIndices.erase(std::unique(lineIndices.begin(), lineIndices.end()), lineIndices.end());
+    // The model validates the indices first, so the selection is only adjusted if the removal succeeded.
+    model->removeEdges(lineIndices);
+    if (selectedLineIdx >= 0) {
+        auto it = std::lower_bound(lineIndices.begin(), lineIndices.end(), selectedLineIdx);
+        if (it != lineIndices.end() && *it == selectedLineIdx) {
+            resetSelection();
+        } else {
+            selectedLineIdx -= int(it - lineIndices.begin());
         }
     }
+    needsReRender = true;
+}
+
+void DiagramBase::setNodePositions(const std::vector<uint32_t>& nodeIndices, const std::vector<glm::vec2>& positions) {
+    publishAsyncBuild(true);
+    if (model && !nodeIndices.empty()) {
+        model->setNodePositions(nodeIndices, positions);
+        needsReRender = true;
+    }
 }
 
 void DiagramBase::onBackendCreated() {
+    if (auto* backendNanoVG = dynamic_cast<VectorBackendNanoVGProfiled*>(vectorBackend)) {
+        backendNanoVG->setFrameProfiler(frameProfiler);
+    }
+    if (auto* backendPipelined = dynamic_cast<VectorBackendNanoVGPipelined*>(vectorBackend)) {
+        backendPipelined->setFrameProfiler(frameProfiler);
+        backendPipelined->setRingDepth(interopRingDepth);
+        backendPipelined->setSharingMode(interopSharingMode);
+    }
+    if (auto* backendRasterCpu = dynamic_cast<VectorBackendRasterCpu*>(vectorBackend)) {
+        backendRasterCpu->setFrameProfiler(frameProfiler);
+    }
+}
+
+void DiagramBase::setFrameProfiler(FrameProfiler* _frameProfiler) {
+    frameProfiler = _frameProfiler;
+    if (vectorBackend) {
+        onBackendCreated();
+    }
 }
 
 void DiagramBase::onBackendDestroyed() {
@@ -112,7 +267,41 @@ void DiagramBase::setClearColor(const sgl::Color& clearColor) {
     float g = clearColor.getFloatG();
     float b = clearColor.getFloatB();
     float clearColorLuminance = 0.2126f * r + 0.7152f * g + 0.0722f * b;
-    isDarkMode = clearColorLuminance <= 0.5f;
+    bool newIsDarkMode = clearColorLuminance <= 0.5f;
+    if (isDarkMode != newIsDarkMode) {
+        isDarkMode = newIsDarkMode;
+        needsReRender = true;
+    }
+}
+
+void DiagramBase::setRenderedModelState() {
+    renderedModel = model.get();
+    if (model) {
+        renderedCurvePointsVersion = model->getCurvePointsVersion();
+        renderedControlPolygonsVersion = model->getControlPolygonsVersion();
+    }
+}
+
+void DiagramBase::validateSelection() {
+    if (!model) {
+        resetSelection();
+        return;
+    }
+    if (!isModelOwner && selectionModelId == model->getModelId()
+            && (selectionControlPolygonsVersion != model->getControlPolygonsVersion()
+                || selectionEdgeWeightsVersion != model->getEdgeWeightsVersion())) {
+        resetSelection();
+    }
+    selectionModelId = model->getModelId();
+    selectionControlPolygonsVersion = model->getControlPolygonsVersion();
+    selectionEdgeWeightsVersion = model->getEdgeWeightsVersion();
+
+    // The renderers index the lines and leaves with the selection.
+    const int numLeaves = model->getNumLeaves();
+    if (selectedLineIdx >= model->getNumLines() || selectedPointIndices[0] >= numLeaves
+            || selectedPointIndices[1] >= numLeaves) {
+        resetSelection();
+    }
 }
 
 void DiagramBase::setIsMouseGrabbedByParent(bool _isMouseGrabbedByParent) {
@@ -128,11 +317,23 @@ void DiagramBase::updateSizeByParent() {
     windowHeight = float(parentHeight) / (scaleFactor * float(ssf));
     onUpdatedWindowSize();
     onWindowSizeChanged();
+    needsReRender = true;
 }
 
 void DiagramBase::update(float dt) {
-    glm::ivec2 mousePositionPx(sgl::Mouse->getX(), sgl::Mouse->getY());
-    glm::vec2 mousePosition(sgl::Mouse->getX(), sgl::Mouse->getY());
+    FrameProfilerScope profilerScope(frameProfiler, FrameStage::DIAGRAM_UPDATE);
+    publishAsyncBuild(false);
+    prepareOwnedModel();
+    // The model may also be modified by other owners, e.g., when shared between multiple diagrams.
+    if (model && (renderedModel != model.get() || renderedCurvePointsVersion != model->getCurvePointsVersion()
+            || renderedControlPolygonsVersion != model->getControlPolygonsVersion())) {
+        needsReRender = true;
+    }
+    validateSelection();
+
+    mouseState = queryMouseState();
+    glm::ivec2 mousePositionPx = mouseState.positionPx;
+    glm::vec2 mousePosition(mouseState.positionPx);
     if (sgl::ImGuiWrapper::get()->getUseDockSpaceMode()) {
         mousePosition -= glm::vec2(imGuiWindowOffsetX, imGuiWindowOffsetY);
         mousePositionPx -= glm::ivec2(imGuiWindowOffsetX, imGuiWindowOffsetY);
@@ -145,7 +346,7 @@ void DiagramBase::update(float dt) {
 
     // Mouse press event.
     if (isMouseOverDiagram && !isWindowFixed) {
-        if (sgl::Mouse->buttonPressed(1)) {
+        if (mouseState.buttonPressed) {
             isMouseGrabbed = true;
         }
         mousePressEventResizeWindow(mousePositionPx, mousePosition);
@@ -153,7 +354,7 @@ void DiagramBase::update(float dt) {
     }
 
     // Mouse move event.
-    if (sgl::Mouse->mouseMoved()) {
+    if (mouseState.moved) {
         if (isMouseOverDiagram || isMouseGrabbed) {
             mouseMoveEvent(mousePositionPx, mousePosition);
         } else {
@@ -161,8 +362,12 @@ void DiagramBase::update(float dt) {
         }
     }
 
+    if (useHoverPicking && mouseState.moved && !isDraggingWindow && !isResizingWindow) {
+        updateHoverPicking(isMouseOverDiagram, mousePosition);
+    }
+
     // Mouse release event.
-    if (sgl::Mouse->buttonReleased(1)) {
+    if (mouseState.buttonReleased) {
         checkWindowMoveOrResizeJustFinished(mousePositionPx);
         resizeDirection = ResizeDirection::NONE;
         isDraggingWindow = false;
@@ -171,6 +376,74 @@ void DiagramBase::update(float dt) {
     }
 }
 
+void DiagramBase::setCurveThickness(float _curveThickness) {
+    curveThickness = _curveThickness;
+    needsReRender = true;
+}
+
+void DiagramBase::setCurveOpacity(float _curveOpacity) {
+    curveOpacity = _curveOpacity;
+    needsReRender = true;
+}
+
+void DiagramBase::setCurveTimeBudgetMs(float _curveTimeBudgetMs) {
+    curveTimeBudgetMs = _curveTimeBudgetMs;
+    needsReRender = true;
+}
+
+void DiagramBase::setUseLod(bool _useLod) {
+    useLod = _useLod;
+    needsReRender = true;
+}
+
+void DiagramBase::setLodEdgeThreshold(int _lodEdgeThreshold) {
+    lodEdgeThreshold = std::max(_lodEdgeThreshold, 0);
+    needsReRender = true;
+}
+
+void DiagramBase::setUseHoverPicking(bool _useHoverPicking) {
+    useHoverPicking = _useHoverPicking;
+    if (!useHoverPicking && (selectedLineIdx >= 0 || selectedPointIndices[0] >= 0)) {
+        resetSelection();
+        needsReRender = true;
+    }
+}
+
+void DiagramBase::updateHoverPicking(bool isMouseOverDiagram, const glm::vec2& mousePosition) {
+    int newSelectedLineIdx = -1;
+    int newSelectedPointIndices[2] = { -1, -1 };
+    if (isMouseOverDiagram && model && model->getIsTessellated() && chartRadius > 0.0f) {
+        auto startTime = std::chrono::steady_clock::now();
+        spatialIndex.update(*model);
+        const glm::vec2 center(windowWidth / 2.0f, windowHeight / 2.0f);
+        const glm::vec2 queryPosition = (mousePosition - center) / chartRadius;
+        const float maxDist = pickRadius / chartRadius;
+        const float nodeRadius = curveThickness * pointRadiusBase / chartRadius;
+        // Nodes are drawn on top of the curves, so they take precedence.
+        int leafIdx = spatialIndex.findNearestNode(*model, queryPosition, maxDist, nodeRadius);
+        if (leafIdx >= 0) {
+            newSelectedPointIndices[0] = leafIdx;
+        } else {
+            newSelectedLineIdx = spatialIndex.findNearestCurve(*model, queryPosition, maxDist);
+            if (newSelectedLineIdx >= 0) {
+                const HEBEdge& edge = model->getEdges().at(newSelectedLineIdx);
+                newSelectedPointIndices[0] = int(edge.pointIdx0);
+                newSelectedPointIndices[1] = int(edge.pointIdx1);
+            }
+        }
+        auto endTime = std::chrono::steady_clock::now();
+        lastPickTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    }
+
+    if (newSelectedLineIdx != selectedLineIdx || newSelectedPointIndices[0] != selectedPointIndices[0]
+            || newSelectedPointIndices[1] != selectedPointIndices[1]) {
+        selectedLineIdx = newSelectedLineIdx;
+        selectedPointIndices[0] = newSelectedPointIndices[0];
+        selectedPointIndices[1] = newSelectedPointIndices[1];
+        needsReRender = true;
+    }
+}
+
 void DiagramBase::checkWindowMoveOrResizeJustFinished(const glm::ivec2& mousePositionPx) {
     bool dragFinished =
             isDraggingWindow && (mousePositionPx.x - mouseDragStartPosX || mousePositionPx.y - mouseDragStartPosY);
@@ -180,8 +453,28 @@ void DiagramBase::checkWindowMoveOrResizeJustFinished(const glm::ivec2& mousePos
     }
 }
 
+void DiagramBase::setScriptedMouseState(const DiagramMouseState* state) {
+    useScriptedMouseState = state != nullptr;
+    if (state) {
+        scriptedMouseState = *state;
+    }
+}
+
+DiagramMouseState DiagramBase::queryMouseState() const {
+    if (useScriptedMouseState) {
+        return scriptedMouseState;
+    }
+    DiagramMouseState state;
+    state.positionPx = glm::ivec2(sgl::Mouse->getX(), sgl::Mouse->getY());
+    state.isButtonDown = sgl::Mouse->isButtonDown(1);
+    state.buttonPressed = sgl::Mouse->buttonPressed(1);
+    state.buttonReleased = sgl::Mouse->buttonReleased(1);
+    state.moved = sgl::Mouse->mouseMoved();
+    return state;
+}
+
 bool DiagramBase::getIsMouseOverDiagramImGui() const {
-    glm::ivec2 mousePositionPx(sgl::Mouse->getX(), sgl::Mouse->getY());
+    glm::ivec2 mousePositionPx = queryMouseState().positionPx;
     if (sgl::ImGuiWrapper::get()->getUseDockSpaceMode()) {
         mousePositionPx -= glm::ivec2(imGuiWindowOffsetX, imGuiWindowOffsetY);
     }
@@ -189,7 +482,7 @@ bool DiagramBase::getIsMouseOverDiagramImGui() const {
 }
 
 void DiagramBase::mouseMoveEvent(const glm::ivec2& mousePositionPx, const glm::vec2& mousePositionScaled) {
-    if (sgl::Mouse->buttonReleased(1)) {
+    if (mouseState.buttonReleased) {
         checkWindowMoveOrResizeJustFinished(mousePositionPx);
         resizeDirection = ResizeDirection::NONE;
         isDraggingWindow = false;
@@ -281,7 +574,7 @@ void DiagramBase::mouseMoveEvent(const glm::ivec2& mousePositionPx, const glm::v
 }
 
 void DiagramBase::mouseMoveEventParent(const glm::ivec2& mousePositionPx, const glm::vec2& mousePositionScaled) {
-    if (sgl::Mouse->isButtonUp(1)) {
+    if (!mouseState.isButtonDown) {
         checkWindowMoveOrResizeJustFinished(mousePositionPx);
         resizeDirection = ResizeDirection::NONE;
         isDraggingWindow = false;
@@ -327,7 +620,7 @@ void DiagramBase::mouseMoveEventParent(const glm::ivec2& mousePositionPx, const
 }
 
 void DiagramBase::mousePressEventResizeWindow(const glm::ivec2& mousePositionPx, const glm::vec2& mousePositionScaled) {
-    if (sgl::Mouse->buttonPressed(1)) {
+    if (mouseState.buttonPressed) {
         // First, check if a resize event was started.
         glm::vec2 mousePosition(float(mousePositionPx.x), float(mousePositionPx.y));
 
@@ -367,7 +660,7 @@ void DiagramBase::mousePressEventResizeWindow(const glm::ivec2& mousePositionPx,
 }
 
 void DiagramBase::mousePressEventMoveWindow(const glm::ivec2& mousePositionPx, const glm::vec2& mousePositionScaled) {
-    if (resizeDirection == ResizeDirection::NONE && sgl::Mouse->buttonPressed(1)) {
+    if (resizeDirection == ResizeDirection::NONE && mouseState.buttonPressed) {
         isDraggingWindow = true;
         windowOffsetXBase = windowOffsetX;
         windowOffsetYBase = windowOffsetY;
@@ -378,10 +671,15 @@ void DiagramBase::mousePressEventMoveWindow(const glm::ivec2& mousePositionPx, c
 
 
 void DiagramBase::getNanoVGContext() {
-    vg = static_cast<sgl::VectorBackendNanoVG*>(vectorBackend)->getContext();
+    if (getSelectedVectorBackendId() == VectorBackendNanoVGPipelined::getClassID()) {
+        vg = static_cast<VectorBackendNanoVGPipelined*>(vectorBackend)->getContext();
+    } else {
+        vg = static_cast<sgl::VectorBackendNanoVG*>(vectorBackend)->getContext();
+    }
 }
 
 void DiagramBase::renderBaseNanoVG() {
+    FrameProfilerScope profilerScope(frameProfiler, FrameStage::RENDER_BASE_NANOVG);
     getNanoVGContext();
 
     sgl::Color backgroundFillColor = isDarkMode ? backgroundFillColorDark : backgroundFillColorBright;
@@ -413,6 +711,275 @@ void DiagramBase::renderBaseNanoVG() {
     nvgFillColor(vg, testColor);
     nvgFill(vg);*/
     renderChordDiagramNanoVG();
+    setRenderedModelState();
+}
+
+void DiagramBase::renderBaseNanoVGPipelined() {
+    auto* backend = static_cast<VectorBackendNanoVGPipelined*>(vectorBackend);
+    backend->beginFrame(windowWidth, windowHeight);
+    renderBaseNanoVG();
+    backend->endFrame();
+}
+
+const char* DiagramBase::getNanoVGBackendId() const {
+    if (interopRingDepth > 0 && VectorBackendNanoVGPipelined::checkIsSupported()) {
+        return VectorBackendNanoVGPipelined::getClassID();
+    }
+    return sgl::VectorBackendNanoVG::getClassID();
+}
+
+void DiagramBase::setUseGpuCurveRenderer(bool useGpuCurveRenderer) {
+    setSelectedVectorBackendId(useGpuCurveRenderer ? VectorBackendCurvesVk::getClassID() : getNanoVGBackendId());
+    needsReRender = true;
+}
+
+void DiagramBase::setInteropRingDepth(int _interopRingDepth) {
+    interopRingDepth = std::clamp(_interopRingDepth, 0, VectorBackendNanoVGPipelined::MAX_RING_DEPTH);
+    if (getUseGpuCurveRenderer() || getUseCpuRasterizer()) {
+        return;
+    }
+    setSelectedVectorBackendId(getNanoVGBackendId());
+    if (getSelectedVectorBackendId() == VectorBackendNanoVGPipelined::getClassID() && vectorBackend) {
+        static_cast<VectorBackendNanoVGPipelined*>(vectorBackend)->setRingDepth(interopRingDepth);
+    }
+    needsReRender = true;
+}
+
+void DiagramBase::setInteropSharingMode(InteropSharingMode _interopSharingMode) {
+    interopSharingMode = _interopSharingMode;
+    if (getSelectedVectorBackendId() == VectorBackendNanoVGPipelined::getClassID() && vectorBackend) {
+        static_cast<VectorBackendNanoVGPipelined*>(vectorBackend)->setSharingMode(interopSharingMode);
+        needsReRender = true;
+    }
+}
+
+InteropSharingMode DiagramBase::getInteropSharingMode() const {
+    if (getSelectedVectorBackendId() == VectorBackendNanoVGPipelined::getClassID() && vectorBackend) {
+        return static_cast<VectorBackendNanoVGPipelined*>(vectorBackend)->getSharingMode();
+    }
+    return interopSharingMode;
+}
+
+bool DiagramBase::getHasPendingFrames() const {
+    if (getSelectedVectorBackendId() == VectorBackendNanoVGPipelined::getClassID() && vectorBackend) {
+        return static_cast<VectorBackendNanoVGPipelined*>(vectorBackend)->getHasPendingFrames();
+    }
+    return false;
+}
+
+void DiagramBase::compositePendingFrames() {
+    if (getSelectedVectorBackendId() == VectorBackendNanoVGPipelined::getClassID() && vectorBackend) {
+        static_cast<VectorBackendNanoVGPipelined*>(vectorBackend)->compositePendingFrames();
+    }
+}
+
+bool DiagramBase::getUseGpuCurveRenderer() const {
+    return getSelectedVectorBackendId() == VectorBackendCurvesVk::getClassID();
+}
+
+void DiagramBase::setUseCpuRasterizer(bool useCpuRasterizer) {
+    setSelectedVectorBackendId(useCpuRasterizer ? VectorBackendRasterCpu::getClassID() : getNanoVGBackendId());
+    needsReRender = true;
+}
+
+bool DiagramBase::getUseCpuRasterizer() const {
+    return getSelectedVectorBackendId() == VectorBackendRasterCpu::getClassID();
+}
+
+static inline glm::vec4 colorToVec4(const sgl::Color& color, float alpha) {
+    return { color.getFloatR(), color.getFloatG(), color.getFloatB(), alpha };
+}
+
+void DiagramBase::renderBaseRasterCpu() {
+    FrameProfilerScope profilerScope(frameProfiler, FrameStage::RENDER_BASE_RASTER_CPU);
+    auto* backend = static_cast<VectorBackendRasterCpu*>(vectorBackend);
+    RasterizerCpu& rasterizer = backend->beginFrame(windowWidth);
+
+    // Render the render target-filling widget rectangle.
+    sgl::Color backgroundFillColor = isDarkMode ? backgroundFillColorDark : backgroundFillColorBright;
+    sgl::Color backgroundStrokeColor = isDarkMode ? backgroundStrokeColorDark : backgroundStrokeColorBright;
+    float backgroundAlpha = std::clamp(backgroundOpacity, 0.0f, 1.0f);
+    rasterizer.drawRoundedRect(
+            glm::vec2(borderWidth, borderWidth),
+            glm::vec2(windowWidth - borderWidth, windowHeight - borderWidth), borderRoundingRadius,
+            colorToVec4(backgroundFillColor, backgroundAlpha), colorToVec4(backgroundStrokeColor, backgroundAlpha),
+            renderBackgroundStroke ? 1.0f : 0.0f);
+
+    renderChordDiagramRasterCpu(rasterizer);
+    backend->endFrame();
+    setRenderedModelState();
+}
+
+void DiagramBase::renderChordDiagramRasterCpu(RasterizerCpu& rasterizer) {
+    computeChartRadius();
+    if (!model || !model->getIsTessellated()) {
+        // Still building asynchronously, or not yet tessellated by the owner of a shared model.
+        return;
+    }
+
+    float radiusPx = chartRadius * scaleFactor;
+    updateScreenCurvePoints();
+    isLodActive = getShouldUseLod(radiusPx);
+    if (isLodActive) {
+        updateLod(radiusPx);
+    }
+    const std::vector<glm::vec2>& curvePoints = screenCurvePoints;
+    const std::vector<uint32_t>& curveOffsets = model->getCurveOffsets();
+    const std::vector<HEBEdge>& edges = model->getEdges();
+    const std::vector<HEBNode>& nodesList = model->getNodes();
+    const uint32_t leafIdxOffset = model->getLeafIdxOffset();
+    const glm::vec4 curveColor(100.0f / 255.0f, 1.0f, 100.0f / 255.0f, 1.0f);
+
+    // The points are referenced by the rasterizer, so the screen-space caches must not change until endFrame.
+    numCurvePathsSubmitted = 0;
+    numCurveStrokeCalls = 0;
+    numBudgetCulledCurves = 0;
+    if (!curvePoints.empty()) {
+        if (isLodActive) {
+            const std::vector<uint32_t>& lodCurveOffsets = lod.getModel().getCurveOffsets();
+            const int numSuperEdges = lod.getModel().getNumLines();
+            int maxBucketIdx = numSuperEdges > 0 ? updateSuperEdgeBuckets() : -1;
+            for (int bucketIdx = 0; bucketIdx <= maxBucketIdx; bucketIdx++) {
+                float strokeWidth, alpha;
+                getSuperEdgeBucketStyle(bucketIdx, strokeWidth, alpha);
+                for (int lineIdx = 0; lineIdx < numSuperEdges; lineIdx++) {
+                    if (lodBucketIndices[lineIdx] != bucketIdx) {
+                        continue;
+                    }
+                    uint32_t offsetStart = lodCurveOffsets[lineIdx];
+                    rasterizer.strokePolyline(
+                            lodScreenPoints.data() + offsetStart, lodCurveOffsets[lineIdx + 1] - offsetStart,
+                            strokeWidth, glm::vec4(curveColor.x, curveColor.y, curveColor.z, alpha));
+                    numCurvePathsSubmitted++;
+                }
+            }
+        } else {
+            // The CPU path has no time budget, as it is meant for complete offline images.
+            updateCurveDrawOrder();
+            for (uint32_t lineIdx : curveDrawOrder) {
+                if (int(lineIdx) == selectedLineIdx) {
+                    continue;
+                }
+                float alpha = float(getCurveAlpha(edges[lineIdx].weight)) / 255.0f;
+                rasterizer.strokePolyline(
+                        curvePoints.data() + curveOffsets[lineIdx], curveOffsets[lineIdx + 1] - curveOffsets[lineIdx],
+                        curveThickness, glm::vec4(curveColor.x, curveColor.y, curveColor.z, alpha));
+                numCurvePathsSubmitted++;
+            }
+        }
+
+        if (selectedLineIdx >= 0) {
+            // Background color outline and the line itself.
+            sgl::Color outlineColor = isDarkMode ? backgroundFillColorDark : backgroundFillColorBright;
+            uint32_t offsetStart = curveOffsets.at(selectedLineIdx);
+            uint32_t numPoints = curveOffsets.at(selectedLineIdx + 1) - offsetStart;
+            rasterizer.strokePolyline(
+                    curvePoints.data() + offsetStart, numPoints, curveThickness * 3.0f,
+                    colorToVec4(outlineColor, outlineColor.getFloatA()));
+            rasterizer.strokePolyline(curvePoints.data() + offsetStart, numPoints, curveThickness * 2.0f, curveColor);
+            numCurvePathsSubmitted += 2;
+        }
+    }
+
+    // Draw the point circles.
+    const glm::vec2 center(windowWidth / 2.0f, windowHeight / 2.0f);
+    float pointRadius = curveThickness * pointRadiusBase;
+    glm::vec4 circleColor = colorToVec4(circleFillColor, circleFillColor.getFloatA());
+    for (int leafIdx = int(leafIdxOffset); leafIdx < int(nodesList.size()); leafIdx++) {
+        int pointIdx = leafIdx - int(leafIdxOffset);
+        if (pointIdx == selectedPointIndices[0] || pointIdx == selectedPointIndices[1]) {
+            continue;
+        }
+        const auto& leaf = nodesList.at(leafIdx);
+        rasterizer.fillCircle(center + leaf.normalizedPosition * chartRadius, pointRadius, circleColor);
+    }
+    int numPointsSelected = selectedPointIndices[0] < 0 ? 0 : (selectedPointIndices[1] < 0 ? 1 : 2);
+    glm::vec4 circleColorSelected = colorToVec4(circleFillColorSelected0, circleFillColorSelected0.getFloatA());
+    for (int idx = 0; idx < numPointsSelected; idx++) {
+        const auto& leaf = nodesList.at(int(leafIdxOffset) + selectedPointIndices[idx]);
+        rasterizer.fillCircle(center + leaf.normalizedPosition * chartRadius, pointRadius * 1.5f, circleColorSelected);
+    }
+}
+
+void DiagramBase::renderBaseCurvesVk() {
+    FrameProfilerScope profilerScope(frameProfiler, FrameStage::RENDER_BASE_CURVES_VK);
+    auto* backend = static_cast<VectorBackendCurvesVk*>(vectorBackend);
+    computeChartRadius();
+    auto width = float(backend->getRenderTargetWidth());
+    auto height = float(backend->getRenderTargetHeight());
+    float pxScale = width / windowWidth;
+
+    sgl::Color backgroundFillColor = isDarkMode ? backgroundFillColorDark : backgroundFillColorBright;
+    glm::vec4 clearColor(
+            backgroundFillColor.getFloatR(), backgroundFillColor.getFloatG(), backgroundFillColor.getFloatB(),
+            backgroundOpacity);
+
+    // Per-curve alphas and culling as in the NanoVG backend; the GPU has no time budget.
+    updateCurveDrawsVk();
+    numBudgetCulledCurves = 0;
+
+    InstancedCurvePushConstants curvePushConstants{};
+    curvePushConstants.color = glm::vec4(100.0f / 255.0f, 1.0f, 100.0f / 255.0f, 1.0f);
+    curvePushConstants.selectedColor = glm::vec4(100.0f / 255.0f, 1.0f, 100.0f / 255.0f, 1.0f);
+    curvePushConstants.center = glm::vec2(0.5f * width, 0.5f * height);
+    curvePushConstants.viewportSize = glm::vec2(width, height);
+    curvePushConstants.radius = chartRadius * pxScale;
+    curvePushConstants.halfWidth = 0.5f * curveThickness * pxScale;
+    curvePushConstants.beta = beta;
+    curvePushConstants.numSamples = gpuCurveNumSamples;
+    curvePushConstants.maxOrder = model ? model->getSplineOrder() : 4;
+    curvePushConstants.selectedCurveIdx = selectedLineIdx;
+
+    InstancedNodePushConstants nodePushConstants{};
+    nodePushConstants.color = glm::vec4(
+            circleFillColor.getFloatR(), circleFillColor.getFloatG(), circleFillColor.getFloatB(),
+            circleFillColor.getFloatA());
+    nodePushConstants.center = curvePushConstants.center;
+    nodePushConstants.viewportSize = curvePushConstants.viewportSize;
+    nodePushConstants.radius = curvePushConstants.radius;
+    nodePushConstants.pointRadius = curveThickness * pointRadiusBase * pxScale;
+
+    if (frameProfiler) {
+        frameProfiler->beginGpuStageVk(FrameStage::GPU_CURVES_VK, rendererVk->getVkCommandBuffer());
+    }
+    backend->renderDiagram(
+            model.get(), curveDrawsVk, curveDrawsVkVersion, clearColor, curvePushConstants, nodePushConstants);
+    if (frameProfiler) {
+        frameProfiler->endGpuStageVk(FrameStage::GPU_CURVES_VK, rendererVk->getVkCommandBuffer());
+    }
+    setRenderedModelState();
+}
+
+void DiagramBase::updateCurveDrawsVk() {
+    if (!model) {
+        if (!curveDrawsVk.empty()) {
+            curveDrawsVk.clear();
+            curveDrawsVkVersion++;
+        }
+        return;
+    }
+    updateCurveDrawOrder();
+    if (curveDrawsVkVersion != 0 && curveDrawsVkDrawOrderVersion == curveDrawOrderVersion
+            && curveDrawsVkSelectedLineIdx == selectedLineIdx && curveDrawsVkOpacity == curveOpacity) {
+        return;
+    }
+    curveDrawsVkDrawOrderVersion = curveDrawOrderVersion;
+    curveDrawsVkSelectedLineIdx = selectedLineIdx;
+    curveDrawsVkOpacity = curveOpacity;
+    curveDrawsVkVersion++;
+
+    const std::vector<HEBEdge>& edges = model->getEdges();
+    curveDrawsVk.clear();
+    curveDrawsVk.reserve(curveDrawOrder.size() + 1);
+    for (uint32_t lineIdx : curveDrawOrder) {
+        if (int(lineIdx) != selectedLineIdx) {
+            curveDrawsVk.push_back({ lineIdx, float(getCurveAlpha(edges[lineIdx].weight)) / 255.0f });
+        }
+    }
+    // The selected curve is drawn on top, even if it was culled.
+    if (selectedLineIdx >= 0 && selectedLineIdx < model->getNumLines()) {
+        curveDrawsVk.push_back({ uint32_t(selectedLineIdx), 1.0f });
+    }
 }
 
 
@@ -456,7 +1023,7 @@ std::string DiagramBase::getNiceNumberString(float number, int digits) {
 }
 
 
-void DiagramBase::renderChordDiagramNanoVG() {
+void DiagramBase::computeChartRadius() {
     if (windowWidth < 360.0f || windowHeight < 360.0f) {
         borderSizeX = borderSizeY = 10.0f;
     } else {
@@ -471,47 +1038,50 @@ void DiagramBase::renderChordDiagramNanoVG() {
     }
     outerRingWidth = totalRadius - chartRadius - outerRingOffset;
     chartRadius = totalRadius * (1.0f - outerRingSizePct);
+}
+
+void DiagramBase::renderChordDiagramNanoVG() {
+    FrameProfilerScope profilerScope(frameProfiler, FrameStage::RENDER_CHORD_DIAGRAM_NANOVG);
+    computeChartRadius();
+    if (!model || !model->getIsTessellated()) {
+        // Still building asynchronously, or not yet tessellated by the owner of a shared model.
+        return;
+    }
+
+    float radiusPx = chartRadius * scaleFactor;
+    updateScreenCurvePoints();
+    isLodActive = getShouldUseLod(radiusPx);
+    if (isLodActive) {
+        updateLod(radiusPx);
+    }
+    const std::vector<glm::vec2>& curvePoints = screenCurvePoints;
+    const std::vector<uint32_t>& curveOffsets = model->getCurveOffsets();
+    const std::vector<HEBNode>& nodesList = model->getNodes();
+    const uint32_t leafIdxOffset = model->getLeafIdxOffset();
 
     // Draw the B-spline curves.
     NVGcolor curveStrokeColor = nvgRGBA(
             100, 255, 100, uint8_t(std::clamp(int(std::ceil(curveOpacity * 255.0f)), 0, 255)));
+    numCurvePathsSubmitted = 0;
+    numCurveStrokeCalls = 0;
+    numBudgetCulledCurves = 0;
     if (!curvePoints.empty()) {
         nvgStrokeWidth(vg, curveThickness);
-        for (int lineIdx = 0; lineIdx < numLinesTotal; lineIdx++) {
-            if (lineIdx == selectedLineIdx) {
-                continue;
-            }
-            nvgBeginPath(vg);
-            glm::vec2 pt0 = curvePoints.at(lineIdx * NUM_SUBDIVISIONS + 0);
-            pt0.x = windowWidth / 2.0f + pt0.x * chartRadius;
-            pt0.y = windowHeight / 2.0f + pt0.y * chartRadius;
-            nvgMoveTo(vg, pt0.x, pt0.y);
-            for (int ptIdx = 1; ptIdx < NUM_SUBDIVISIONS; ptIdx++) {
-                glm::vec2 pt = curvePoints.at(lineIdx * NUM_SUBDIVISIONS + ptIdx);
-                pt.x = windowWidth / 2.0f + pt.x * chartRadius;
-                pt.y = windowHeight / 2.0f + pt.y * chartRadius;
-                nvgLineTo(vg, pt.x, pt.y);
-            }
-
-            nvgStrokeColor(vg, curveStrokeColor);
-            nvgStroke(vg);
+        nvgStrokeColor(vg, curveStrokeColor);
+        if (isLodActive) {
+            renderSuperEdgesNanoVG();
+        } else {
+            renderCurvesNanoVG();
         }
 
         if (selectedLineIdx >= 0) {
             // Background color outline.
             sgl::Color outlineColor = isDarkMode ? backgroundFillColorDark : backgroundFillColorBright;
+            uint32_t offsetStart = curveOffsets.at(selectedLineIdx);
+            uint32_t offsetEnd = curveOffsets.at(selectedLineIdx + 1);
             nvgStrokeWidth(vg, curveThickness * 3.0f);
             nvgBeginPath(vg);
-            glm::vec2 pt0 = curvePoints.at(selectedLineIdx * NUM_SUBDIVISIONS + 0);
-            pt0.x = windowWidth / 2.0f + pt0.x * chartRadius;
-            pt0.y = windowHeight / 2.0f + pt0.y * chartRadius;
-            nvgMoveTo(vg, pt0.x, pt0.y);
-            for (int ptIdx = 1; ptIdx < NUM_SUBDIVISIONS; ptIdx++) {
-                glm::vec2 pt = curvePoints.at(selectedLineIdx * NUM_SUBDIVISIONS + ptIdx);
-                pt.x = windowWidth / 2.0f + pt.x * chartRadius;
-                pt.y = windowHeight / 2.0f + pt.y * chartRadius;
-                nvgLineTo(vg, pt.x, pt.y);
-            }
+            addCurveSubPathNanoVG(curvePoints.data() + offsetStart, offsetEnd - offsetStart);
             nvgStrokeColor(vg, nvgRGBA(
                     outlineColor.getR(), outlineColor.getG(), outlineColor.getB(), outlineColor.getA()));
             nvgStroke(vg);
@@ -519,25 +1089,20 @@ void DiagramBase::renderChordDiagramNanoVG() {
             // Line itself.
             nvgStrokeWidth(vg, curveThickness * 2.0f);
             nvgBeginPath(vg);
-            nvgMoveTo(vg, pt0.x, pt0.y);
-            for (int ptIdx = 1; ptIdx < NUM_SUBDIVISIONS; ptIdx++) {
-                glm::vec2 pt = curvePoints.at(selectedLineIdx * NUM_SUBDIVISIONS + ptIdx);
-                pt.x = windowWidth / 2.0f + pt.x * chartRadius;
-                pt.y = windowHeight / 2.0f + pt.y * chartRadius;
-                nvgLineTo(vg, pt.x, pt.y);
-            }
+            addCurveSubPathNanoVG(curvePoints.data() + offsetStart, offsetEnd - offsetStart);
             curveStrokeColor.a = 1.0f;
             nvgStrokeColor(vg, curveStrokeColor);
             nvgStroke(vg);
+            numCurveStrokeCalls += 2;
         }
     }
 
     // Draw the point circles.
     float pointRadius = curveThickness * pointRadiusBase;
     nvgBeginPath(vg);
-    for (int leafIdx = int(0); leafIdx < int(nodesList.size()); leafIdx++) {
+    for (int leafIdx = int(leafIdxOffset); leafIdx < int(nodesList.size()); leafIdx++) {
         const auto& leaf = nodesList.at(leafIdx);
-        int pointIdx = leafIdx - int(0);
+        int pointIdx = leafIdx - int(leafIdxOffset);
         if (pointIdx == selectedPointIndices[0] || pointIdx == selectedPointIndices[1]) {
             continue;
         }
@@ -556,7 +1121,7 @@ void DiagramBase::renderChordDiagramNanoVG() {
             circleFillColorSelected0.getR(), circleFillColorSelected0.getG(),
             circleFillColorSelected0.getB(), circleFillColorSelected0.getA());
     for (int idx = 0; idx < numPointsSelected; idx++) {
-        const auto& leaf = nodesList.at(int(0) + selectedPointIndices[idx]);
+        const auto& leaf = nodesList.at(int(leafIdxOffset) + selectedPointIndices[idx]);
         float pointX = windowWidth / 2.0f + leaf.normalizedPosition.x * chartRadius;
         float pointY = windowHeight / 2.0f + leaf.normalizedPosition.y * chartRadius;
         nvgBeginPath(vg);
@@ -570,6 +1135,252 @@ void DiagramBase::renderChordDiagramNanoVG() {
     }
 }
 
+void DiagramBase::updateCurveDrawOrder() {
+    // Thinner strokes than a pixel only cover a fraction of it.
+    float maxAlphaContribution = curveOpacity * std::min(curveThickness * scaleFactor, 1.0f);
+    float minWeight = maxAlphaContribution > 0.0f
+            ? alphaCullThreshold / maxAlphaContribution : std::numeric_limits<float>::infinity();
+    if (drawOrderModel == model.get() && drawOrderEdgeWeightsVersion == model->getEdgeWeightsVersion()
+            && drawOrderMinWeight == minWeight) {
+        return;
+    }
+    drawOrderModel = model.get();
+    drawOrderEdgeWeightsVersion = model->getEdgeWeightsVersion();
+    drawOrderMinWeight = minWeight;
+    curveDrawOrderVersion++;
+
+    const std::vector<HEBEdge>& edges = model->getEdges();
+    const int numLinesTotal = model->getNumLines();
+    curveDrawOrder.clear();
+    curveDrawOrder.reserve(numLinesTotal);
+    for (int lineIdx = 0; lineIdx < numLinesTotal; lineIdx++) {
+        if (edges[lineIdx].weight >= minWeight) {
+            curveDrawOrder.push_back(uint32_t(lineIdx));
+        }
+    }
+    numCulledCurves = numLinesTotal - int(curveDrawOrder.size());
+    std::stable_sort(curveDrawOrder.begin(), curveDrawOrder.end(), [&edges](uint32_t lineIdx0, uint32_t lineIdx1) {
+        return edges[lineIdx0].weight > edges[lineIdx1].weight;
+    });
+}
+
+uint8_t DiagramBase::getCurveAlpha(float weight) const {
+    return uint8_t(std::clamp(int(std::ceil(curveOpacity * weight * 255.0f)), 0, 255));
+}
+
+void DiagramBase::renderCurvesNanoVG() {
+    updateCurveDrawOrder();
+    const std::vector<glm::vec2>& curvePoints = screenCurvePoints;
+    const std::vector<uint32_t>& curveOffsets = model->getCurveOffsets();
+    const std::vector<HEBEdge>& edges = model->getEdges();
+    auto startTime = std::chrono::steady_clock::now();
+    auto getIsTimeBudgetExceeded = [&]() {
+        if (curveTimeBudgetMs <= 0.0f) {
+            return false;
+        }
+        auto elapsedTime = std::chrono::steady_clock::now() - startTime;
+        return std::chrono::duration<float, std::milli>(elapsedTime).count() > curveTimeBudgetMs;
+    };
+
+    size_t orderIdx = 0;
+    if (useBatchedCurveStrokes) {
+        // Curves with the same (quantized) opacity share their paint, so they are submitted as sub-paths of few large
+        // strokes. Consecutive curves in importance order mostly have the same opacity.
+        uint32_t numBatchPoints = 0;
+        int batchAlpha = -1;
+        for (; orderIdx < curveDrawOrder.size(); orderIdx++) {
+            auto lineIdx = int(curveDrawOrder[orderIdx]);
+            if (lineIdx == selectedLineIdx) {
+                continue;
+            }
+            int alpha = getCurveAlpha(edges[lineIdx].weight);
+            uint32_t numPoints = curveOffsets[lineIdx + 1] - curveOffsets[lineIdx];
+            if (numBatchPoints > 0 && (alpha != batchAlpha || numBatchPoints + numPoints > MAX_CURVE_BATCH_POINTS)) {
+                nvgStroke(vg);
+                numCurveStrokeCalls++;
+                numBatchPoints = 0;
+                if (getIsTimeBudgetExceeded()) {
+                    break;
+                }
+            }
+            if (numBatchPoints == 0) {
+                batchAlpha = alpha;
+                nvgStrokeColor(vg, nvgRGBA(100, 255, 100, uint8_t(alpha)));
+                nvgBeginPath(vg);
+            }
+            addCurveSubPathNanoVG(curvePoints.data() + curveOffsets[lineIdx], numPoints);
+            numBatchPoints += numPoints;
+        }
+        if (numBatchPoints > 0) {
+            nvgStroke(vg);
+            numCurveStrokeCalls++;
+        }
+    } else {
+        for (; orderIdx < curveDrawOrder.size(); orderIdx++) {
+            auto lineIdx = int(curveDrawOrder[orderIdx]);
+            if (lineIdx == selectedLineIdx) {
+                continue;
+            }
+            if (orderIdx % 64 == 0 && getIsTimeBudgetExceeded()) {
+                break;
+            }
+            nvgStrokeColor(vg, nvgRGBA(100, 255, 100, getCurveAlpha(edges[lineIdx].weight)));
+            nvgBeginPath(vg);
+            uint32_t offsetStart = curveOffsets.at(lineIdx);
+            uint32_t offsetEnd = curveOffsets.at(lineIdx + 1);
+            addCurveSubPathNanoVG(curvePoints.data() + offsetStart, offsetEnd - offsetStart);
+            nvgStroke(vg);
+            numCurveStrokeCalls++;
+        }
+    }
+    numBudgetCulledCurves = int(curveDrawOrder.size() - orderIdx);
+}
+
+bool DiagramBase::getShouldUseLod(float radiusPx) const {
+    if (!useLod || !model) {
+        return false;
+    }
+    float zoomFactor = std::max(radiusPx / LOD_REFERENCE_RADIUS_PX, 1.0f);
+    return float(model->getNumLines()) > float(lodEdgeThreshold) * zoomFactor * zoomFactor;
+}
+
+void DiagramBase::updateLod(float radiusPx) {
+    if (lod.getNeedsRebuild(*model, lodMaxNumSectors)) {
+        lod.build(*model, lodMaxNumSectors);
+    }
+    ChordDiagramModel& lodModel = lod.getModel();
+    lodModel.setBeta(model->getBeta());
+    lodModel.setSplineOrder(model->getSplineOrder());
+    lodModel.setUseAdaptiveSubdivision(model->getUseAdaptiveSubdivision());
+    lodModel.setNumSubdivisions(model->getNumSubdivisions());
+    if (lodModel.getNeedsTessellation(radiusPx)) {
+        lodModel.tessellate(radiusPx);
+    }
+}
+
+int DiagramBase::updateSuperEdgeBuckets() {
+    ChordDiagramModel& lodModel = lod.getModel();
+    const std::vector<glm::vec2>& lodCurvePoints = lodModel.getCurvePoints();
+    const std::vector<float>& superEdgeWeights = lod.getSuperEdgeWeights();
+    const int numSuperEdges = lodModel.getNumLines();
+
+    const glm::vec2 center(windowWidth / 2.0f, windowHeight / 2.0f);
+    lodScreenPoints.resize(lodCurvePoints.size());
+    for (size_t ptIdx = 0; ptIdx < lodCurvePoints.size(); ptIdx++) {
+        lodScreenPoints[ptIdx] = center + lodCurvePoints[ptIdx] * chartRadius;
+    }
+
+    lodBucketIndices.resize(numSuperEdges);
+    int maxBucketIdx = 0;
+    for (int lineIdx = 0; lineIdx < numSuperEdges; lineIdx++) {
+        float weight = superEdgeWeights[lineIdx];
+        int bucketIdx = weight > 1.0f ? std::min(int(std::log2(weight)), LOD_NUM_WEIGHT_BUCKETS - 1) : 0;
+        lodBucketIndices[lineIdx] = bucketIdx;
+        maxBucketIdx = std::max(maxBucketIdx, bucketIdx);
+    }
+    return maxBucketIdx;
+}
+
+void DiagramBase::getSuperEdgeBucketStyle(int bucketIdx, float& strokeWidth, float& alpha) const {
+    float bucketCount = std::exp2(float(bucketIdx) + 0.5f);
+    alpha = 1.0f - std::pow(1.0f - std::clamp(curveOpacity, 0.0f, 1.0f), bucketCount);
+    strokeWidth = curveThickness * std::min(1.0f + 0.25f * float(bucketIdx), 4.0f);
+}
+
+void DiagramBase::renderSuperEdgesNanoVG() {
+    ChordDiagramModel& lodModel = lod.getModel();
+    const std::vector<uint32_t>& lodCurveOffsets = lodModel.getCurveOffsets();
+    const int numSuperEdges = lodModel.getNumLines();
+    if (numSuperEdges == 0) {
+        return;
+    }
+
+    int maxBucketIdx = updateSuperEdgeBuckets();
+    for (int bucketIdx = 0; bucketIdx <= maxBucketIdx; bucketIdx++) {
+        float strokeWidth, alpha;
+        getSuperEdgeBucketStyle(bucketIdx, strokeWidth, alpha);
+        nvgStrokeWidth(vg, strokeWidth);
+        nvgStrokeColor(vg, nvgRGBA(100, 255, 100, uint8_t(std::clamp(int(std::ceil(alpha * 255.0f)), 0, 255))));
+        nvgBeginPath(vg);
+        bool isBucketEmpty = true;
+        for (int lineIdx = 0; lineIdx < numSuperEdges; lineIdx++) {
+            if (lodBucketIndices[lineIdx] != bucketIdx) {
+                continue;
+            }
+            uint32_t offsetStart = lodCurveOffsets[lineIdx];
+            addCurveSubPathNanoVG(lodScreenPoints.data() + offsetStart, lodCurveOffsets[lineIdx + 1] - offsetStart);
+            isBucketEmpty = false;
+        }
+        if (!isBucketEmpty) {
+            nvgStroke(vg);
+            numCurveStrokeCalls++;
+        }
+    }
+}
+
+void DiagramBase::addCurveSubPathNanoVG(const glm::vec2* points, uint32_t numPoints) {
+    if (numPoints == 0) {
+        return;
+    }
+    nvgMoveTo(vg, points[0].x, points[0].y);
+    for (uint32_t ptIdx = 1; ptIdx < numPoints; ptIdx++) {
+        nvgLineTo(vg, points[ptIdx].x, points[ptIdx].y);
+    }
+    numCurvePathsSubmitted++;
+}
+
+void DiagramBase::prepareOwnedModel() {
+    if (!model || !isModelOwner) {
+        return;
+    }
+    // The dirty range is only reset once the screen-space cache consumed it, so the cache stays incremental. Other
+    // consumers with older versions (e.g., the spatial index) rebuild their caches.
+    if (cachedModel == model.get() && cachedCurvePointsVersion == model->getCurvePointsVersion()
+            && model->getIsCurvesDirty()) {
+        model->resetCurvesDirty();
+    }
+    computeChartRadius();
+    float radiusPx = chartRadius * scaleFactor;
+    if (model->getNeedsTessellation(radiusPx)) {
+        model->tessellate(radiusPx);
+    }
+}
+
+void DiagramBase::updateScreenCurvePoints() {
+    const std::vector<glm::vec2>& curvePoints = model->getCurvePoints();
+    const std::vector<uint32_t>& curveOffsets = model->getCurveOffsets();
+    int lineStart = 0, lineEnd = model->getNumLines();
+    bool isTransformUnchanged =
+            cachedModel == model.get() && cachedWindowWidth == windowWidth && cachedWindowHeight == windowHeight
+            && cachedChartRadius == chartRadius && screenCurvePoints.size() == curvePoints.size();
+    if (isTransformUnchanged) {
+        if (cachedCurvePointsVersion == model->getCurvePointsVersion()) {
+            return;
+        }
+        if (cachedCurvePointsVersion >= model->getDirtyBaseVersion() && !model->getCurveOffsetsChanged()) {
+            lineStart = model->getDirtyLineStart();
+            lineEnd = model->getDirtyLineEnd();
+        }
+    }
+
+    screenCurvePoints.resize(curvePoints.size());
+    const glm::vec2 center(windowWidth / 2.0f, windowHeight / 2.0f);
+    const float radius = chartRadius;
+    const uint32_t ptStart = curveOffsets.empty() ? 0 : curveOffsets[lineStart];
+    const uint32_t ptEnd = curveOffsets.empty() ? 0 : curveOffsets[lineEnd];
+    parallelForChunks(int(ptEnd - ptStart), SCREEN_POINTS_CHUNK_SIZE, [&](int threadIdx, int begin, int end) {
+        for (uint32_t ptIdx = ptStart + uint32_t(begin); ptIdx < ptStart + uint32_t(end); ptIdx++) {
+            screenCurvePoints[ptIdx] = center + curvePoints[ptIdx] * radius;
+        }
+    });
+
+    cachedModel = model.get();
+    cachedCurvePointsVersion = model->getCurvePointsVersion();
+    cachedWindowWidth = windowWidth;
+    cachedWindowHeight = windowHeight;
+    cachedChartRadius = chartRadius;
+}
+
 void DiagramBase::renderRings() {
     /*glm::vec2 center(windowWidth / 2.0f, windowHeight / 2.0f);
     auto numFields = int(fieldDataArray.size());
@@ -31,22 +31,39 @@
 
 #include <set>
 #include <sstream>
+#include <string>
 #include <functional>
+#include <future>
+#include <memory>
 
 #include <Graphics/Window.hpp>
 #include <Graphics/Vector/VectorWidget.hpp>
 
+#include "ChordDiagramModel.hpp"
+#include "ChordDiagramLod.hpp"
+#include "DiagramSpatialIndex.hpp"
+#include "FrameProfiler.hpp"
+#include "InstancedCurvePass.hpp"
+#include "VectorBackendNanoVGPipelined.hpp"
+
 struct NVGcontext;
 typedef struct NVGcontext NVGcontext;
 struct NVGcolor;
+class RasterizerCpu;
 
-struct HEBNode {
-    glm::vec2 normalizedPosition;
+/// Mouse input (left button) of a frame as seen by @see DiagramBase::update.
+struct DiagramMouseState {
+    glm::ivec2 positionPx{};
+    bool isButtonDown = false;
+    bool buttonPressed = false;
+    bool buttonReleased = false;
+    bool moved = false;
 };
 
 class DiagramBase : public sgl::VectorWidget {
 public:
     DiagramBase();
+    ~DiagramBase() override;
     virtual void initialize();
     void update(float dt) override;
     [[nodiscard]] bool getIsMouseOverDiagramImGui() const;
@@ -57,6 +74,95 @@ public:
     [[nodiscard]] inline bool getNeedsReRender() { bool tmp = needsReRender; needsReRender = false; return tmp; }
     [[nodiscard]] inline bool getIsMouseGrabbed() const { return isMouseGrabbed; }
 
+    /// The model may be shared between multiple diagrams. It is null until the first (asynchronous) build finished.
+    [[nodiscard]] inline const std::shared_ptr<ChordDiagramModel>& getModel() const { return model; }
+    /**
+     * Exactly one diagram (or the application) should own a shared model. The owning diagram tessellates the model for
+     * its chart radius and resets its dirty range in update; the other diagrams only read from it and do not draw the
+     * curves until the model is tessellated. Models built by the diagram itself are always owned by it.
+     */
+    void setModel(const std::shared_ptr<ChordDiagramModel>& _model, bool _isModelOwner = true);
+    /// If enabled, initialize builds the model on a worker thread while the diagram is rendered empty.
+    inline void setUseAsyncBuild(bool _useAsyncBuild) { useAsyncBuild = _useAsyncBuild; }
+    [[nodiscard]] inline bool getIsBuildingAsync() const { return asyncBuildFuture.valid(); }
+    /// Non-empty if the last asynchronous build failed; the previous (or empty) model is kept in this case.
+    [[nodiscard]] inline const std::string& getAsyncBuildErrorMessage() const { return asyncBuildErrorMessage; }
+    /// If set before initialize, the model is loaded from the graph file (see GraphFile.hpp) instead of a test graph.
+    inline void setGraphFilePath(const std::string& _graphFilePath) { graphFilePath = _graphFilePath; }
+
+    // Incremental updates; only the affected curves are recomputed. Edits wait for a running asynchronous build.
+    [[nodiscard]] inline float getBeta() const { return beta; }
+    void setBeta(float _beta);
+    /// Adds edges between the passed pairs of leaf indices; the weights default to one if not passed.
+    void addEdges(
+            const std::vector<std::pair<uint32_t, uint32_t>>& newEdges, const std::vector<float>& weights = {});
+    void removeEdges(std::vector<int> lineIndices);
+    /// Moves the passed nodes to new normalized positions.
+    void setNodePositions(const std::vector<uint32_t>& nodeIndices, const std::vector<glm::vec2>& positions);
+
+    /// Switches between NanoVG and the GPU-instanced curve renderer (@see VectorBackendCurvesVk).
+    void setUseGpuCurveRenderer(bool useGpuCurveRenderer);
+    [[nodiscard]] bool getUseGpuCurveRenderer() const;
+    /// Switches between NanoVG and the tiled CPU rasterizer (@see VectorBackendRasterCpu), e.g., without a GPU.
+    void setUseCpuRasterizer(bool useCpuRasterizer);
+    [[nodiscard]] bool getUseCpuRasterizer() const;
+    /**
+     * Number of Vulkan-OpenGL interop images NanoVG renders into round-robin (@see VectorBackendNanoVGPipelined).
+     * Zero selects sgl's NanoVG backend, which synchronizes both APIs in every frame.
+     */
+    void setInteropRingDepth(int _interopRingDepth);
+    [[nodiscard]] inline int getInteropRingDepth() const { return interopRingDepth; }
+    /// How the pipelined backend shares its render targets with Vulkan; the sharing mode actually used may differ.
+    void setInteropSharingMode(InteropSharingMode _interopSharingMode);
+    [[nodiscard]] InteropSharingMode getInteropSharingMode() const;
+    /**
+     * With PBO copies, the last frames rendered by the pipelined backend are composited in later frames. If true, the
+     * parent needs to call @see compositePendingFrames and blit in frames where the diagram is not re-rendered.
+     */
+    [[nodiscard]] bool getHasPendingFrames() const;
+    void compositePendingFrames();
+
+    // Curve submission statistics of the last rendered frame.
+    inline void setUseBatchedCurveStrokes(bool _useBatchedCurveStrokes) {
+        useBatchedCurveStrokes = _useBatchedCurveStrokes;
+        needsReRender = true;
+    }
+    [[nodiscard]] inline bool getUseBatchedCurveStrokes() const { return useBatchedCurveStrokes; }
+    [[nodiscard]] inline int getNumCurvePathsSubmitted() const { return numCurvePathsSubmitted; }
+    [[nodiscard]] inline int getNumCurveStrokeCalls() const { return numCurveStrokeCalls; }
+
+    // Curve appearance; the opacity of a curve is curveOpacity times the weight of its edge.
+    void setCurveThickness(float _curveThickness);
+    [[nodiscard]] inline float getCurveThickness() const { return curveThickness; }
+    void setCurveOpacity(float _curveOpacity);
+    [[nodiscard]] inline float getCurveOpacity() const { return curveOpacity; }
+    /// Time budget for submitting the curves in milliseconds; zero disables the limit.
+    void setCurveTimeBudgetMs(float _curveTimeBudgetMs);
+    [[nodiscard]] inline float getCurveTimeBudgetMs() const { return curveTimeBudgetMs; }
+    /// Number of curves not drawn due to their low opacity or the time budget in the last frame.
+    [[nodiscard]] inline int getNumCulledCurves() const { return numCulledCurves; }
+    [[nodiscard]] inline int getNumBudgetCulledCurves() const { return numBudgetCulledCurves; }
+
+    /// Draws super-edges between angular sectors instead of the curves for many edges (@see ChordDiagramLod).
+    void setUseLod(bool _useLod);
+    [[nodiscard]] inline bool getUseLod() const { return useLod; }
+    void setLodEdgeThreshold(int _lodEdgeThreshold);
+    [[nodiscard]] inline bool getIsLodActive() const { return isLodActive; }
+    [[nodiscard]] inline int getNumLodSectors() const { return lod.getNumSectors(); }
+    [[nodiscard]] inline int getNumLodSuperEdges() const { return lod.getNumSuperEdges(); }
+
+    /// Highlights the curve or node under the mouse cursor (@see DiagramSpatialIndex).
+    void setUseHoverPicking(bool _useHoverPicking);
+    [[nodiscard]] inline bool getUseHoverPicking() const { return useHoverPicking; }
+    /// Time of the last hover query including the index update in milliseconds.
+    [[nodiscard]] inline double getLastPickTimeMs() const { return lastPickTimeMs; }
+
+    /// Replaces sgl::Mouse as the input of update, e.g., for scripted playback; null restores the mouse input.
+    void setScriptedMouseState(const DiagramMouseState* state);
+
+    /// Timings of the update and render stages are reported to the profiler if set.
+    void setFrameProfiler(FrameProfiler* _frameProfiler);
+
     [[nodiscard]] inline bool getSelectedVariablesChanged() const { return selectedVariablesChanged; };
     [[nodiscard]] inline const std::set<size_t>& getSelectedVariableIndices() const { return selectedVariableIndices; };
     inline void getSelectedVariableIndices(const std::set<size_t>& newSelectedVariableIndices) {
@@ -79,15 +185,131 @@ protected:
     void getNanoVGContext();
     NVGcontext* vg = nullptr;
 
+    /// Wraps renderBaseNanoVG in the frame of the pipelined interop backend.
+    void renderBaseNanoVGPipelined();
+    [[nodiscard]] const char* getNanoVGBackendId() const;
+    int interopRingDepth = 0;
+    InteropSharingMode interopSharingMode = InteropSharingMode::EXTERNAL_MEMORY;
+
+    // GPU-instanced curve backend; the curves are evaluated in the vertex shader with gpuCurveNumSamples samples.
+    void renderBaseCurvesVk();
+    int gpuCurveNumSamples = 64;
+    /// Builds the draw list from curveDrawOrder and the curve alphas, i.e., with the same culling as NanoVG.
+    void updateCurveDrawsVk();
+    std::vector<InstancedCurveDraw> curveDrawsVk;
+    uint64_t curveDrawsVkVersion = 0;
+    uint64_t curveDrawsVkDrawOrderVersion = 0;
+    int curveDrawsVkSelectedLineIdx = -1;
+    float curveDrawsVkOpacity = -1.0f;
+
+    // Tiled CPU raster backend; draws the same primitives as the NanoVG backend.
+    void renderBaseRasterCpu();
+    void renderChordDiagramRasterCpu(RasterizerCpu& rasterizer);
+
     // Test code.
     void renderChordDiagramNanoVG();
-    int numLinesTotal = 0;
-    int MAX_NUM_LINES = 100;
-    const int NUM_SUBDIVISIONS = 50;
-    float beta = 0.75f;
+    /// Appends the curve (in screen coordinates) as a sub-path of the current NanoVG path.
+    void addCurveSubPathNanoVG(const glm::vec2* points, uint32_t numPoints);
+
+    /*
+     * Screen-space vertex cache: The curve points transformed by the window center and chart radius. Only the lines
+     * marked dirty in the model are transformed again, unless the transform or the curve offsets changed.
+     */
+    void updateScreenCurvePoints();
+    /// Model owner step in update: Tessellates the model for the current chart radius and resets its dirty range.
+    void prepareOwnedModel();
+    bool isModelOwner = true;
+    std::vector<glm::vec2> screenCurvePoints;
+    const ChordDiagramModel* cachedModel = nullptr;
+    uint64_t cachedCurvePointsVersion = 0;
+    float cachedWindowWidth = 0.0f, cachedWindowHeight = 0.0f, cachedChartRadius = 0.0f;
+    static constexpr int SCREEN_POINTS_CHUNK_SIZE = 1 << 16;
+    /*
+     * Batched submission: The non-selected curves are added as sub-paths of one NanoVG path per MAX_CURVE_BATCH_POINTS
+     * points, i.e., one stroke (and draw call) per batch instead of per curve. The limit keeps the temporary path and
+     * vertex buffers NanoVG expands each stroke into at a moderate size.
+     */
+    bool useBatchedCurveStrokes = true;
+    static constexpr uint32_t MAX_CURVE_BATCH_POINTS = 1u << 16u;
+    int numCurvePathsSubmitted = 0; //< Number of sub-paths (one per curve) in the last frame.
+    int numCurveStrokeCalls = 0; //< Number of nvgStroke calls for the curves in the last frame.
+
+    /*
+     * Importance order: Curves whose alpha contribution (curveOpacity times the edge weight, and times the stroke width
+     * if thinner than a pixel) is below alphaCullThreshold are culled, as they would vanish in 8-bit color. The others
+     * are drawn by descending weight, so exceeding curveTimeBudgetMs drops the least important curves. All curves have
+     * the same color, so the blended result does not depend on the drawing order.
+     */
+    void renderCurvesNanoVG();
+    void updateCurveDrawOrder();
+    [[nodiscard]] uint8_t getCurveAlpha(float weight) const;
+    std::vector<uint32_t> curveDrawOrder; //< Line indices of the curves that are not culled.
+    uint64_t curveDrawOrderVersion = 0; //< Incremented whenever curveDrawOrder is rebuilt.
+    const ChordDiagramModel* drawOrderModel = nullptr;
+    uint64_t drawOrderEdgeWeightsVersion = 0;
+    float drawOrderMinWeight = -1.0f;
+    float alphaCullThreshold = 0.5f / 255.0f;
+    float curveTimeBudgetMs = 0.0f;
+    int numCulledCurves = 0;
+    int numBudgetCulledCurves = 0;
+
+    /*
+     * Level of detail: Above lodEdgeThreshold edges, the edges are drawn as super-edges aggregated by angular sector,
+     * so the frame time does not grow with the number of edges. The threshold grows with the chart area relative to a
+     * chart radius of LOD_REFERENCE_RADIUS_PX, i.e., the individual curves are drawn again when zooming in. A selected
+     * curve is always drawn individually on top.
+     */
+    [[nodiscard]] bool getShouldUseLod(float radiusPx) const;
+    void updateLod(float radiusPx);
+    void renderSuperEdgesNanoVG();
+    /*
+     * Transforms the super-edges to lodScreenPoints and sorts them into buckets by the log2 of their edge count.
+     * A super-edge aggregating edges with a total weight of n gets the opacity n overlapping curves would have, i.e.,
+     * 1 - (1 - alpha)^n. The heavier buckets are drawn on top. Returns the maximum bucket index.
+     */
+    int updateSuperEdgeBuckets();
+    void getSuperEdgeBucketStyle(int bucketIdx, float& strokeWidth, float& alpha) const;
+    bool useLod = true;
+    bool isLodActive = false; //< Whether the last frame was rendered using the LOD.
+    int lodEdgeThreshold = 20000;
+    int lodMaxNumSectors = 64;
+    static constexpr float LOD_REFERENCE_RADIUS_PX = 200.0f;
+    static constexpr int LOD_NUM_WEIGHT_BUCKETS = 32; //< Super-edges are batched by the log2 of their edge count.
+    ChordDiagramLod lod;
+    std::vector<glm::vec2> lodScreenPoints;
+    std::vector<int> lodBucketIndices;
+    /*
+     * Hover picking: The curve (or node) within pickRadius of the mouse cursor is selected. The spatial index is only
+     * updated for picking, i.e., incrementally for the lines changed since the last query.
+     */
+    void updateHoverPicking(bool isMouseOverDiagram, const glm::vec2& mousePosition);
+    void resetSelection();
+    DiagramSpatialIndex spatialIndex;
+    bool useHoverPicking = true;
+    float pickRadius = 4.0f; //< In diagram coordinates (i.e., before applying the scale factor).
+    double lastPickTimeMs = 0.0;
+    std::shared_ptr<ChordDiagramModel> model; //< Geometry of the diagram; only read from during rendering.
+    int hierarchyBranchingFactor = 4;
+    float beta = 0.75f; //< Also applied to models published by an asynchronous build.
+
+    /*
+     * Asynchronous build: The worker builds a new model (i.e., the back buffer) while the current one is rendered.
+     * The new model is only published on the main thread at a frame boundary in update, so the renderer never sees
+     * a partially built model.
+     */
+    static std::shared_ptr<ChordDiagramModel> buildTestModel(
+            int numPoints, int branchingFactor, float modelBeta, float radiusPx);
+    static std::shared_ptr<ChordDiagramModel> buildGraphFileModel(
+            const std::string& filePath, int branchingFactor, float modelBeta, float radiusPx);
+    /// Publishes the model built by the worker if it is ready (or after waiting for it). Returns whether it did.
+    bool publishAsyncBuild(bool wait);
+    bool useAsyncBuild = true;
+    std::future<std::shared_ptr<ChordDiagramModel>> asyncBuildFuture;
+    std::string graphFilePath;
+    std::string asyncBuildErrorMessage;
     float curveThickness = 1.5f;
     float curveOpacity = 0.1f;
-    std::vector<glm::vec2> curvePoints;
+    void computeChartRadius();
     float chartRadius{};
     float totalRadius{};
 
@@ -108,7 +330,6 @@ protected:
     sgl::Color circleStrokeColorDark = sgl::Color(255, 255, 255, 255);
     sgl::Color circleStrokeColorBright = sgl::Color(0, 0, 0, 255);
     int selectedPointIndices[2] = { -1, -1 };
-    std::vector<HEBNode> nodesList;
 
     // Scale factor used for rendering.
     float s = 1.0f;
@@ -137,6 +358,20 @@ protected:
     float textSize = 8.0f;
 
     bool needsReRender = false;
+    FrameProfiler* frameProfiler = nullptr;
+    /// Model state of the last rendered frame; model changes by other owners also trigger a re-render.
+    void setRenderedModelState();
+    const ChordDiagramModel* renderedModel = nullptr;
+    uint64_t renderedCurvePointsVersion = 0;
+    uint64_t renderedControlPolygonsVersion = 0;
+    /**
+     * Edits through this diagram keep the selection valid. Other owners of a shared model may reorder or remove lines
+     * and nodes, so the selection is reset if the model changed since the last update.
+     */
+    void validateSelection();
+    uint64_t selectionModelId = 0;
+    uint64_t selectionControlPolygonsVersion = 0;
+    uint64_t selectionEdgeWeightsVersion = 0;
     float borderSizeX = 0, borderSizeY = 0;
     const float borderWidth = 1.0f;
     const float borderRoundingRadius = 4.0f;
@@ -174,6 +409,12 @@ protected:
     int lastResizeMouseY = 0;
     sgl::CursorType cursorShape = sgl::CursorType::DEFAULT;
 
+    // Mouse input of the current frame.
+    [[nodiscard]] DiagramMouseState queryMouseState() const;
+    DiagramMouseState mouseState;
+    DiagramMouseState scriptedMouseState;
+    bool useScriptedMouseState = false;
+
     // Offset for deducing mouse position.
     void checkWindowMoveOrResizeJustFinished(const glm::ivec2& mousePositionPx);
     int imGuiWindowOffsetX = 0, imGuiWindowOffsetY = 0;
@@ -0,0 +1,356 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <glm/common.hpp>
+
+#include "ParallelFor.hpp"
+#include "ChordDiagramModel.hpp"
+#include "DiagramSpatialIndex.hpp"
+
+void DiagramSpatialIndex::CellGrid::getCellRange(
+        const glm::vec2& bbMin, const glm::vec2& bbMax, int& x0, int& y0, int& x1, int& y1) const {
+    x0 = std::clamp(int(std::floor((bbMin.x - gridMin.x) * cellSizeInv.x)), 0, numCellsX - 1);
+    y0 = std::clamp(int(std::floor((bbMin.y - gridMin.y) * cellSizeInv.y)), 0, numCellsY - 1);
+    x1 = std::clamp(int(std::floor((bbMax.x - gridMin.x) * cellSizeInv.x)), 0, numCellsX - 1);
+    y1 = std::clamp(int(std::floor((bbMax.y - gridMin.y) * cellSizeInv.y)), 0, numCellsY - 1);
+}
+
+void DiagramSpatialIndex::CellGrid::getInsertCellRange(
+        const glm::vec2& bbMin, const glm::vec2& bbMax, int& x0, int& y0, int& x1, int& y1) const {
+    glm::vec2 extentCells = (bbMax - bbMin) * cellSizeInv;
+    if (extentCells.x <= 1.0f && extentCells.y <= 1.0f) {
+        glm::vec2 midpoint = (bbMin + bbMax) * 0.5f;
+        getCellRange(midpoint, midpoint, x0, y0, x1, y1);
+    } else {
+        getCellRange(bbMin, bbMax, x0, y0, x1, y1);
+    }
+}
+
+void DiagramSpatialIndex::CellGrid::getQueryCellRange(
+        const glm::vec2& pos, float radius, int& x0, int& y0, int& x1, int& y1) const {
+    // Items stored by their midpoint extend at most half a cell beyond their cell.
+    glm::vec2 extent = glm::vec2(radius) + 0.5f / cellSizeInv;
+    getCellRange(pos - extent, pos + extent, x0, y0, x1, y1);
+}
+
+/**
+ * Fills the cell lists of the grid with a counting sort. forEachItem(visitor) must call visitor(bbMin, bbMax, entry)
+ * for every item in the same order on both passes.
+ */
+template<class Entry, class ForEachItem>
+void DiagramSpatialIndex::fillCells(CellGrid& grid, std::vector<Entry>& entries, const ForEachItem& forEachItem) {
+    const size_t numCells = size_t(grid.numCellsX) * size_t(grid.numCellsY);
+    grid.cellOffsets.assign(numCells + 1, 0);
+    forEachItem([&grid](const glm::vec2& bbMin, const glm::vec2& bbMax, const Entry&) {
+        int x0, y0, x1, y1;
+        grid.getInsertCellRange(bbMin, bbMax, x0, y0, x1, y1);
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                grid.cellOffsets[size_t(y) * size_t(grid.numCellsX) + size_t(x) + 1]++;
+            }
+        }
+    });
+    for (size_t cellIdx = 0; cellIdx < numCells; cellIdx++) {
+        grid.cellOffsets[cellIdx + 1] += grid.cellOffsets[cellIdx];
+    }
+
+    entries.resize(grid.cellOffsets.back());
+    std::vector<uint32_t> writeOffsets(grid.cellOffsets.begin(), grid.cellOffsets.end() - 1);
+    forEachItem([&grid, &entries, &writeOffsets](const glm::vec2& bbMin, const glm::vec2& bbMax, const Entry& entry) {
+        int x0, y0, x1, y1;
+        grid.getInsertCellRange(bbMin, bbMax, x0, y0, x1, y1);
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                entries[writeOffsets[size_t(y) * size_t(grid.numCellsX) + size_t(x)]++] = entry;
+            }
+        }
+    });
+}
+
+void DiagramSpatialIndex::setGridLayout(
+        CellGrid& grid, const glm::vec2& bbMin, const glm::vec2& bbMax, float cellSize) {
+    const float extentX = std::max(bbMax.x - bbMin.x, 1e-6f);
+    const float extentY = std::max(bbMax.y - bbMin.y, 1e-6f);
+    cellSize = std::max(cellSize, 1e-6f);
+    grid.gridMin = bbMin;
+    grid.numCellsX = std::clamp(int(std::ceil(extentX / cellSize)), 1, MAX_GRID_RESOLUTION);
+    grid.numCellsY = std::clamp(int(std::ceil(extentY / cellSize)), 1, MAX_GRID_RESOLUTION);
+    grid.cellSizeInv = glm::vec2(float(grid.numCellsX) / extentX, float(grid.numCellsY) / extentY);
+}
+
+void DiagramSpatialIndex::clear() {
+    segmentGrid = {};
+    segmentEntries.clear();
+    numSegments = 0;
+    numLines = 0;
+    overlayGrid = {};
+    overlayEntries.clear();
+    isLineStale.clear();
+    isPointStale.clear();
+    staleLines.clear();
+    numStaleSegments = 0;
+    nodeGrid = {};
+    nodeEntries.clear();
+    indexedModelId = 0;
+    isNodesIndexed = false;
+}
+
+void DiagramSpatialIndex::update(const ChordDiagramModel& model) {
+    if (indexedModelId != model.getModelId()) {
+        rebuild(model);
+        return;
+    }
+    if (!isNodesIndexed || indexedControlPolygonsVersion != model.getControlPolygonsVersion()) {
+        rebuildNodes(model);
+    }
+    if (indexedCurvePointsVersion == model.getCurvePointsVersion()) {
+        return;
+    }
+
+    // The dirty range is only complete if nobody reset it since the last update.
+    const std::vector<uint32_t>& curveOffsets = model.getCurveOffsets();
+    bool canUpdateIncrementally =
+            indexedCurvePointsVersion >= model.getDirtyBaseVersion() && !model.getCurveOffsetsChanged()
+            && model.getIsTessellated() && numLines == model.getNumLines()
+            && curveOffsets.size() == size_t(numLines) + 1 && isPointStale.size() == model.getCurvePoints().size();
+    if (!canUpdateIncrementally) {
+        rebuild(model);
+        return;
+    }
+
+    // Lines in the dirty range with an older line version did not change.
+    for (int lineIdx = model.getDirtyLineStart(); lineIdx < model.getDirtyLineEnd(); lineIdx++) {
+        if (!isLineStale[lineIdx] && model.getLineVersion(lineIdx) > indexedCurvePointsVersion) {
+            isLineStale[lineIdx] = 1;
+            staleLines.push_back(uint32_t(lineIdx));
+            std::fill(
+                    isPointStale.begin() + curveOffsets[lineIdx], isPointStale.begin() + curveOffsets[lineIdx + 1], 1);
+            numStaleSegments += std::max(curveOffsets[lineIdx + 1] - curveOffsets[lineIdx], 1u) - 1u;
+        }
+    }
+    if (float(numStaleSegments) > MAX_STALE_SEGMENTS_FRACTION * float(numSegments)) {
+        rebuild(model);
+        return;
+    }
+    rebuildOverlay(model);
+    indexedCurvePointsVersion = model.getCurvePointsVersion();
+}
+
+void DiagramSpatialIndex::rebuild(const ChordDiagramModel& model) {
+    indexedModelId = model.getModelId();
+    indexedCurvePointsVersion = model.getCurvePointsVersion();
+    rebuildNodes(model);
+
+    const std::vector<glm::vec2>& curvePoints = model.getCurvePoints();
+    const std::vector<uint32_t>& curveOffsets = model.getCurveOffsets();
+    numLines = model.getNumLines();
+    if (!model.getIsTessellated() || curveOffsets.size() != size_t(numLines) + 1) {
+        numLines = 0;
+    }
+    const uint32_t numPoints = numLines > 0 ? curveOffsets[numLines] : 0;
+    isLineStale.assign(size_t(numLines), 0);
+    isPointStale.assign(size_t(numPoints), 0);
+    staleLines.clear();
+    numStaleSegments = 0;
+    overlayEntries.clear();
+
+    // Bounds and mean segment size.
+    const int numThreads = getMaxNumParallelThreads();
+    std::vector<glm::vec2> threadMin(numThreads, glm::vec2(std::numeric_limits<float>::max()));
+    std::vector<glm::vec2> threadMax(numThreads, glm::vec2(std::numeric_limits<float>::lowest()));
+    std::vector<double> threadExtentSum(numThreads, 0.0);
+    std::vector<size_t> threadNumSegments(numThreads, 0);
+    parallelForChunks(numLines, LINE_CHUNK_SIZE, [&](int threadIdx, int begin, int end) {
+        glm::vec2 bbMin = threadMin[threadIdx], bbMax = threadMax[threadIdx];
+        double extentSum = 0.0;
+        size_t numChunkSegments = 0;
+        for (int lineIdx = begin; lineIdx < end; lineIdx++) {
+            for (uint32_t ptIdx = curveOffsets[lineIdx]; ptIdx < curveOffsets[lineIdx + 1]; ptIdx++) {
+                bbMin = glm::min(bbMin, curvePoints[ptIdx]);
+                bbMax = glm::max(bbMax, curvePoints[ptIdx]);
+                if (ptIdx > curveOffsets[lineIdx]) {
+                    glm::vec2 diff = glm::abs(curvePoints[ptIdx] - curvePoints[ptIdx - 1]);
+                    extentSum += double(std::max(diff.x, diff.y));
+                    numChunkSegments++;
+                }
+            }
+        }
+        threadMin[threadIdx] = bbMin;
+        threadMax[threadIdx] = bbMax;
+        threadExtentSum[threadIdx] += extentSum;
+        threadNumSegments[threadIdx] += numChunkSegments;
+    });
+    glm::vec2 bbMin(std::numeric_limits<float>::max()), bbMax(std::numeric_limits<float>::lowest());
+    double extentSum = 0.0;
+    numSegments = 0;
+    for (int threadIdx = 0; threadIdx < numThreads; threadIdx++) {
+        bbMin = glm::min(bbMin, threadMin[threadIdx]);
+        bbMax = glm::max(bbMax, threadMax[threadIdx]);
+        extentSum += threadExtentSum[threadIdx];
+        numSegments += threadNumSegments[threadIdx];
+    }
+    if (numSegments == 0) {
+        bbMin = glm::vec2(-1.0f);
+        bbMax = glm::vec2(1.0f);
+    }
+
+    // Cells about as large as the mean segment, unless this would result in mostly empty cells.
+    float cellSize = numSegments > 0 ? float(extentSum / double(numSegments)) : 2.0f;
+    float area = std::max(bbMax.x - bbMin.x, 1e-6f) * std::max(bbMax.y - bbMin.y, 1e-6f);
+    cellSize = std::max(cellSize, std::sqrt(area * SEGMENTS_PER_CELL / float(std::max(numSegments, size_t(1)))));
+    setGridLayout(segmentGrid, bbMin, bbMax, cellSize);
+    fillCells(segmentGrid, segmentEntries, [&](const auto& visitor) {
+        for (int lineIdx = 0; lineIdx < numLines; lineIdx++) {
+            for (uint32_t ptIdx = curveOffsets[lineIdx] + 1; ptIdx < curveOffsets[lineIdx + 1]; ptIdx++) {
+                const glm::vec2& p0 = curvePoints[ptIdx - 1];
+                const glm::vec2& p1 = curvePoints[ptIdx];
+                visitor(glm::min(p0, p1), glm::max(p0, p1), ptIdx - 1);
+            }
+        }
+    });
+    overlayGrid = segmentGrid;
+    overlayGrid.cellOffsets.assign(segmentGrid.cellOffsets.size(), 0);
+}
+
+void DiagramSpatialIndex::rebuildOverlay(const ChordDiagramModel& model) {
+    const std::vector<glm::vec2>& curvePoints = model.getCurvePoints();
+    const std::vector<uint32_t>& curveOffsets = model.getCurveOffsets();
+    fillCells(overlayGrid, overlayEntries, [&](const auto& visitor) {
+        for (uint32_t lineIdx : staleLines) {
+            for (uint32_t ptIdx = curveOffsets[lineIdx] + 1; ptIdx < curveOffsets[lineIdx + 1]; ptIdx++) {
+                const glm::vec2& p0 = curvePoints[ptIdx - 1];
+                const glm::vec2& p1 = curvePoints[ptIdx];
+                visitor(glm::min(p0, p1), glm::max(p0, p1), ptIdx - 1);
+            }
+        }
+    });
+}
+
+void DiagramSpatialIndex::rebuildNodes(const ChordDiagramModel& model) {
+    isNodesIndexed = true;
+    indexedControlPolygonsVersion = model.getControlPolygonsVersion();
+    const std::vector<HEBNode>& nodes = model.getNodes();
+    const uint32_t leafIdxOffset = model.getLeafIdxOffset();
+    const int numLeaves = std::max(model.getNumLeaves(), 0);
+
+    glm::vec2 bbMin(-1.0f), bbMax(1.0f);
+    for (int leafIdx = 0; leafIdx < numLeaves; leafIdx++) {
+        bbMin = glm::min(bbMin, nodes[leafIdxOffset + leafIdx].normalizedPosition);
+        bbMax = glm::max(bbMax, nodes[leafIdxOffset + leafIdx].normalizedPosition);
+    }
+    float area = (bbMax.x - bbMin.x) * (bbMax.y - bbMin.y);
+    setGridLayout(nodeGrid, bbMin, bbMax, std::sqrt(area / float(std::max(numLeaves, 1))));
+    fillCells(nodeGrid, nodeEntries, [&](const auto& visitor) {
+        for (int leafIdx = 0; leafIdx < numLeaves; leafIdx++) {
+            const glm::vec2& position = nodes[leafIdxOffset + leafIdx].normalizedPosition;
+            visitor(position, position, uint32_t(leafIdx));
+        }
+    });
+}
+
+int DiagramSpatialIndex::findNearestCurve(
+        const ChordDiagramModel& model, const glm::vec2& pos, float maxDist, float* distOut) const {
+    const std::vector<glm::vec2>& curvePoints = model.getCurvePoints();
+    // The segment with the smallest point index wins ties, i.e., the same line as for a linear search.
+    uint32_t closestPointIdx = std::numeric_limits<uint32_t>::max();
+    float closestDistSq = maxDist * maxDist;
+    auto visitCells = [&](const CellGrid& grid, const std::vector<uint32_t>& entries, bool skipStale) {
+        if (grid.cellOffsets.empty()) {
+            return;
+        }
+        int x0, y0, x1, y1;
+        grid.getQueryCellRange(pos, maxDist, x0, y0, x1, y1);
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                size_t cellIdx = size_t(y) * size_t(grid.numCellsX) + size_t(x);
+                for (uint32_t entryIdx = grid.cellOffsets[cellIdx]; entryIdx < grid.cellOffsets[cellIdx + 1];
+                        entryIdx++) {
+                    uint32_t pointIdx = entries[entryIdx];
+                    if (skipStale && isPointStale[pointIdx]) {
+                        continue;
+                    }
+                    const glm::vec2& p0 = curvePoints[pointIdx];
+                    glm::vec2 d = curvePoints[pointIdx + 1] - p0;
+                    glm::vec2 q = pos - p0;
+                    float lengthSq = d.x * d.x + d.y * d.y;
+                    float t = lengthSq > 0.0f ? std::clamp((q.x * d.x + q.y * d.y) / lengthSq, 0.0f, 1.0f) : 0.0f;
+                    glm::vec2 diff = q - t * d;
+                    float distSq = diff.x * diff.x + diff.y * diff.y;
+                    if (distSq < closestDistSq || (distSq == closestDistSq && pointIdx < closestPointIdx)) {
+                        closestDistSq = distSq;
+                        closestPointIdx = pointIdx;
+                    }
+                }
+            }
+        }
+    };
+    visitCells(segmentGrid, segmentEntries, !staleLines.empty());
+    visitCells(overlayGrid, overlayEntries, false);
+    if (closestPointIdx == std::numeric_limits<uint32_t>::max()) {
+        return -1;
+    }
+    if (distOut) {
+        *distOut = std::sqrt(closestDistSq);
+    }
+    const std::vector<uint32_t>& curveOffsets = model.getCurveOffsets();
+    auto it = std::upper_bound(curveOffsets.begin(), curveOffsets.end(), closestPointIdx);
+    return int(it - curveOffsets.begin()) - 1;
+}
+
+int DiagramSpatialIndex::findNearestNode(
+        const ChordDiagramModel& model, const glm::vec2& pos, float maxDist, float nodeRadius) const {
+    if (nodeGrid.cellOffsets.empty()) {
+        return -1;
+    }
+    const std::vector<HEBNode>& nodes = model.getNodes();
+    const uint32_t leafIdxOffset = model.getLeafIdxOffset();
+    int closestLeafIdx = -1;
+    float closestDist = maxDist;
+    int x0, y0, x1, y1;
+    nodeGrid.getQueryCellRange(pos, maxDist + nodeRadius, x0, y0, x1, y1);
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            size_t cellIdx = size_t(y) * size_t(nodeGrid.numCellsX) + size_t(x);
+            for (uint32_t entryIdx = nodeGrid.cellOffsets[cellIdx]; entryIdx < nodeGrid.cellOffsets[cellIdx + 1];
+                    entryIdx++) {
+                uint32_t leafIdx = nodeEntries[entryIdx];
+                glm::vec2 diff = pos - nodes[leafIdxOffset + leafIdx].normalizedPosition;
+                // Distance to the circle, i.e., zero inside of it.
+                float dist = std::max(std::sqrt(diff.x * diff.x + diff.y * diff.y) - nodeRadius, 0.0f);
+                if (dist < closestDist || (dist == closestDist && int(leafIdx) < closestLeafIdx)) {
+                    closestDist = dist;
+                    closestLeafIdx = int(leafIdx);
+                }
+            }
+        }
+    }
+    return closestLeafIdx;
+}
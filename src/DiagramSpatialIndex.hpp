@@ -0,0 +1,120 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DIAGRAMSPATIALINDEX_HPP
+#define DIAGRAMSPATIALINDEX_HPP
+
+#include <cstdint>
+#include <vector>
+#include <glm/vec2.hpp>
+
+class ChordDiagramModel;
+
+/**
+ * Uniform grid over the curve segments and leaf nodes of a @see ChordDiagramModel in normalized coordinates for
+ * picking, i.e., finding the nearest curve or node within a radius around a query point. The grid is loose: Segments no
+ * larger than a cell are only stored in the cell containing their midpoint, and queries are extended by half a cell
+ * instead. Larger segments are stored in all cells their bounding box overlaps. The cell size is chosen close to the
+ * mean segment size, so almost all segments are stored once.
+ *
+ * Incremental updates: Lines marked dirty in the model are flagged as stale in the main grid, and their segments are
+ * inserted into a small overlay grid with the same layout instead. The main grid is only rebuilt if the curve offsets
+ * changed or the stale segments exceed a fraction of all segments.
+ */
+class DiagramSpatialIndex {
+public:
+    /// Brings the index up to date with the model; cheap if the model did not change since the last call.
+    void update(const ChordDiagramModel& model);
+    void rebuild(const ChordDiagramModel& model);
+    void clear();
+
+    /**
+     * Returns the index of the line with the segment closest to pos with a distance of at most maxDist, or -1 if there
+     * is none. Must be called with the model passed to the last call to @see update.
+     */
+    [[nodiscard]] int findNearestCurve(
+            const ChordDiagramModel& model, const glm::vec2& pos, float maxDist, float* distOut = nullptr) const;
+    /// Returns the leaf index (relative to the leaf offset) of the nearest node circle within maxDist, or -1.
+    [[nodiscard]] int findNearestNode(
+            const ChordDiagramModel& model, const glm::vec2& pos, float maxDist, float nodeRadius) const;
+
+    // Statistics.
+    [[nodiscard]] inline size_t getNumSegments() const { return numSegments; }
+    [[nodiscard]] inline size_t getNumStaleSegments() const { return numStaleSegments; }
+    [[nodiscard]] inline int getNumCellsX() const { return segmentGrid.numCellsX; }
+    [[nodiscard]] inline int getNumCellsY() const { return segmentGrid.numCellsY; }
+
+private:
+    /// Cell layout and compressed cell lists, i.e., the entries of cell i are [cellOffsets[i], cellOffsets[i + 1]).
+    struct CellGrid {
+        glm::vec2 gridMin{}, cellSizeInv{};
+        int numCellsX = 0, numCellsY = 0;
+        std::vector<uint32_t> cellOffsets;
+        /// Computes the clamped range of cells overlapped by the passed bounding box.
+        void getCellRange(
+                const glm::vec2& bbMin, const glm::vec2& bbMax, int& x0, int& y0, int& x1, int& y1) const;
+        /// Range of cells an item with the passed bounding box is stored in.
+        void getInsertCellRange(
+                const glm::vec2& bbMin, const glm::vec2& bbMax, int& x0, int& y0, int& x1, int& y1) const;
+        /// Range of cells that may contain items within radius of pos.
+        void getQueryCellRange(const glm::vec2& pos, float radius, int& x0, int& y0, int& x1, int& y1) const;
+    };
+    static void setGridLayout(CellGrid& grid, const glm::vec2& bbMin, const glm::vec2& bbMax, float cellSize);
+    template<class Entry, class ForEachItem>
+    static void fillCells(CellGrid& grid, std::vector<Entry>& entries, const ForEachItem& forEachItem);
+    void rebuildOverlay(const ChordDiagramModel& model);
+    void rebuildNodes(const ChordDiagramModel& model);
+
+    // Curve segments.
+    // The entries are the indices of the first points of the segments in the curve point buffer.
+    CellGrid segmentGrid;
+    std::vector<uint32_t> segmentEntries;
+    size_t numSegments = 0;
+    int numLines = 0;
+    CellGrid overlayGrid; //< Same layout as segmentGrid, but only contains the stale lines.
+    std::vector<uint32_t> overlayEntries;
+    std::vector<uint8_t> isLineStale;
+    std::vector<uint8_t> isPointStale; //< Per point, so the main grid entries can be filtered without a line lookup.
+    std::vector<uint32_t> staleLines;
+    size_t numStaleSegments = 0;
+    static constexpr float MAX_STALE_SEGMENTS_FRACTION = 0.25f;
+    static constexpr float SEGMENTS_PER_CELL = 4.0f; //< Lower bound used if there are few, but large segments.
+    static constexpr int MAX_GRID_RESOLUTION = 2048; //< Cells per axis.
+    static constexpr int LINE_CHUNK_SIZE = 1024;
+
+    // Leaf nodes.
+    CellGrid nodeGrid;
+    std::vector<uint32_t> nodeEntries;
+
+    uint64_t indexedModelId = 0; //< See @see ChordDiagramModel::getModelId; 0 if nothing is indexed.
+    uint64_t indexedCurvePointsVersion = 0;
+    uint64_t indexedControlPolygonsVersion = 0;
+    bool isNodesIndexed = false;
+};
+
+#endif //DIAGRAMSPATIALINDEX_HPP
@@ -0,0 +1,484 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#ifdef SUPPORT_OPENGL
+#include <GL/glew.h>
+#endif
+
+#include "FrameProfiler.hpp"
+
+static_assert(
+        sizeof(FRAME_STAGE_NAMES) / sizeof(*FRAME_STAGE_NAMES) == NUM_FRAME_STAGES,
+        "FRAME_STAGE_NAMES must contain one name per stage.");
+static_assert(NUM_FRAME_STAGES <= 32, "The GPU timers store the stages as 32-bit masks.");
+
+static uint32_t getProfilerThreadId() {
+    static std::atomic<uint32_t> nextThreadId{0};
+    thread_local uint32_t threadId = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+    return threadId;
+}
+
+FrameEventRing::FrameEventRing() : slots(new Slot[CAPACITY]) {
+}
+
+void FrameEventRing::push(const FrameEvent& event) {
+    uint64_t index = writeIndex.fetch_add(1, std::memory_order_acq_rel);
+    Slot& slot = slots[index & (CAPACITY - 1)];
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.stage.store(uint32_t(event.stage), std::memory_order_relaxed);
+    slot.source.store(uint32_t(event.source), std::memory_order_relaxed);
+    slot.threadId.store(event.threadId, std::memory_order_relaxed);
+    slot.frameIndex.store(event.frameIndex, std::memory_order_relaxed);
+    slot.startNs.store(event.startNs, std::memory_order_relaxed);
+    slot.durationNs.store(event.durationNs, std::memory_order_relaxed);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+uint64_t FrameEventRing::read(uint64_t begin, std::vector<FrameEvent>& events) const {
+    uint64_t end = getWriteIndex();
+    if (end - begin > CAPACITY) {
+        begin = end - CAPACITY;
+    }
+    for (uint64_t index = begin; index < end; index++) {
+        const Slot& slot = slots[index & (CAPACITY - 1)];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * index + 2) {
+            // Still being written or already overwritten.
+            continue;
+        }
+        FrameEvent event{};
+        event.stage = FrameStage(slot.stage.load(std::memory_order_relaxed));
+        event.source = FrameEventSource(slot.source.load(std::memory_order_relaxed));
+        event.threadId = slot.threadId.load(std::memory_order_relaxed);
+        event.frameIndex = slot.frameIndex.load(std::memory_order_relaxed);
+        event.startNs = slot.startNs.load(std::memory_order_relaxed);
+        event.durationNs = slot.durationNs.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+            events.push_back(event);
+        }
+    }
+    return end;
+}
+
+
+GpuTimerVk::~GpuTimerVk() {
+    destroy();
+}
+
+void GpuTimerVk::initialize(sgl::vk::Device* _device) {
+    destroy();
+    const VkPhysicalDeviceLimits& limits = _device->getPhysicalDeviceProperties().limits;
+    if (!limits.timestampComputeAndGraphics) {
+        return;
+    }
+    device = _device;
+    timestampPeriod = limits.timestampPeriod;
+    VkQueryPoolCreateInfo queryPoolCreateInfo{};
+    queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolCreateInfo.queryCount = uint32_t(NUM_QUERY_FRAMES * NUM_FRAME_STAGES * 2);
+    if (vkCreateQueryPool(device->getVkDevice(), &queryPoolCreateInfo, nullptr, &queryPool) != VK_SUCCESS) {
+        queryPool = VK_NULL_HANDLE;
+        device = nullptr;
+    }
+    queryFrames = {};
+}
+
+void GpuTimerVk::destroy() {
+    if (queryPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(device->getVkDevice(), queryPool, nullptr);
+        queryPool = VK_NULL_HANDLE;
+    }
+    device = nullptr;
+}
+
+void GpuTimerVk::begin(FrameStage stage, VkCommandBuffer commandBuffer) {
+    if (queryPool == VK_NULL_HANDLE) {
+        return;
+    }
+    uint64_t frameIndex = profiler->getFrameIndex();
+    auto queryFrameIdx = uint32_t(frameIndex % NUM_QUERY_FRAMES);
+    QueryFrame& queryFrame = queryFrames.at(queryFrameIdx);
+    if (queryFrame.frameIndex != frameIndex) {
+        // Results not available after NUM_QUERY_FRAMES frames are dropped.
+        resolveQueryFrame(queryFrameIdx);
+        queryFrame.frameIndex = frameIndex;
+        queryFrame.openStagesMask = 0;
+        queryFrame.pendingStagesMask = 0;
+    }
+    uint32_t stageBit = 1u << uint32_t(stage);
+    if (((queryFrame.openStagesMask | queryFrame.pendingStagesMask) & stageBit) != 0) {
+        // Only the first occurrence of a stage per frame is measured.
+        return;
+    }
+    uint32_t firstQuery = (queryFrameIdx * uint32_t(NUM_FRAME_STAGES) + uint32_t(stage)) * 2;
+    vkCmdResetQueryPool(commandBuffer, queryPool, firstQuery, 2);
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, firstQuery);
+    queryFrame.openStagesMask |= stageBit;
+    queryFrame.cpuStartNs.at(size_t(stage)) = profiler->getTimeNs();
+}
+
+void GpuTimerVk::end(FrameStage stage, VkCommandBuffer commandBuffer) {
+    if (queryPool == VK_NULL_HANDLE) {
+        return;
+    }
+    uint64_t frameIndex = profiler->getFrameIndex();
+    auto queryFrameIdx = uint32_t(frameIndex % NUM_QUERY_FRAMES);
+    QueryFrame& queryFrame = queryFrames.at(queryFrameIdx);
+    uint32_t stageBit = 1u << uint32_t(stage);
+    if (queryFrame.frameIndex != frameIndex || (queryFrame.openStagesMask & stageBit) == 0) {
+        return;
+    }
+    uint32_t firstQuery = (queryFrameIdx * uint32_t(NUM_FRAME_STAGES) + uint32_t(stage)) * 2;
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, firstQuery + 1);
+    queryFrame.openStagesMask &= ~stageBit;
+    queryFrame.pendingStagesMask |= stageBit;
+}
+
+void GpuTimerVk::resolve() {
+    if (queryPool == VK_NULL_HANDLE) {
+        return;
+    }
+    for (uint32_t queryFrameIdx = 0; queryFrameIdx < NUM_QUERY_FRAMES; queryFrameIdx++) {
+        resolveQueryFrame(queryFrameIdx);
+    }
+}
+
+bool GpuTimerVk::resolveQueryFrame(uint32_t queryFrameIdx) {
+    QueryFrame& queryFrame = queryFrames.at(queryFrameIdx);
+    for (size_t stageIdx = 0; stageIdx < NUM_FRAME_STAGES; stageIdx++) {
+        uint32_t stageBit = 1u << uint32_t(stageIdx);
+        if ((queryFrame.pendingStagesMask & stageBit) == 0) {
+            continue;
+        }
+        // Timestamp and availability value per query.
+        uint64_t results[4] = {};
+        uint32_t firstQuery = (queryFrameIdx * uint32_t(NUM_FRAME_STAGES) + uint32_t(stageIdx)) * 2;
+        VkResult result = vkGetQueryPoolResults(
+                device->getVkDevice(), queryPool, firstQuery, 2, sizeof(results), results, 2 * sizeof(uint64_t),
+                VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+        if ((result != VK_SUCCESS && result != VK_NOT_READY) || results[1] == 0 || results[3] == 0) {
+            continue;
+        }
+        auto durationNs = int64_t(double(results[2] - results[0]) * double(timestampPeriod));
+        profiler->recordGpuEvent(
+                FrameStage(stageIdx), FrameEventSource::GPU_VULKAN, queryFrame.frameIndex,
+                queryFrame.cpuStartNs.at(stageIdx), durationNs);
+        queryFrame.pendingStagesMask &= ~stageBit;
+    }
+    return queryFrame.pendingStagesMask == 0;
+}
+
+
+bool GpuTimerGl::initialize() {
+    isInitialized = true;
+#ifdef SUPPORT_OPENGL
+    isSupported = GLEW_ARB_timer_query || GLEW_VERSION_3_3;
+    if (isSupported) {
+        queries.resize(NUM_QUERY_FRAMES * NUM_FRAME_STAGES * 2);
+        glGenQueries(GLsizei(queries.size()), queries.data());
+    }
+#else
+    isSupported = false;
+#endif
+    return isSupported;
+}
+
+void GpuTimerGl::destroy() {
+#ifdef SUPPORT_OPENGL
+    if (!queries.empty()) {
+        glDeleteQueries(GLsizei(queries.size()), queries.data());
+        queries.clear();
+    }
+#endif
+    isInitialized = false;
+    queryFrames = {};
+}
+
+void GpuTimerGl::begin(FrameStage stage) {
+    if ((!isInitialized && !initialize()) || !isSupported || !profiler || !profiler->getIsEnabled()) {
+        return;
+    }
+#ifdef SUPPORT_OPENGL
+    uint64_t frameIndex = profiler->getFrameIndex();
+    auto queryFrameIdx = uint32_t(frameIndex % NUM_QUERY_FRAMES);
+    QueryFrame& queryFrame = queryFrames.at(queryFrameIdx);
+    if (queryFrame.frameIndex != frameIndex) {
+        resolveQueryFrame(queryFrameIdx);
+        queryFrame.frameIndex = frameIndex;
+        queryFrame.openStagesMask = 0;
+        queryFrame.pendingStagesMask = 0;
+    }
+    uint32_t stageBit = 1u << uint32_t(stage);
+    if (((queryFrame.openStagesMask | queryFrame.pendingStagesMask) & stageBit) != 0) {
+        return;
+    }
+    size_t firstQuery = (queryFrameIdx * NUM_FRAME_STAGES + size_t(stage)) * 2;
+    glQueryCounter(queries.at(firstQuery), GL_TIMESTAMP);
+    queryFrame.openStagesMask |= stageBit;
+    queryFrame.cpuStartNs.at(size_t(stage)) = profiler->getTimeNs();
+#endif
+}
+
+void GpuTimerGl::end(FrameStage stage) {
+    if (!isInitialized || !isSupported || !profiler) {
+        return;
+    }
+#ifdef SUPPORT_OPENGL
+    uint64_t frameIndex = profiler->getFrameIndex();
+    auto queryFrameIdx = uint32_t(frameIndex % NUM_QUERY_FRAMES);
+    QueryFrame& queryFrame = queryFrames.at(queryFrameIdx);
+    uint32_t stageBit = 1u << uint32_t(stage);
+    if (queryFrame.frameIndex != frameIndex || (queryFrame.openStagesMask & stageBit) == 0) {
+        return;
+    }
+    size_t firstQuery = (queryFrameIdx * NUM_FRAME_STAGES + size_t(stage)) * 2;
+    glQueryCounter(queries.at(firstQuery + 1), GL_TIMESTAMP);
+    queryFrame.openStagesMask &= ~stageBit;
+    queryFrame.pendingStagesMask |= stageBit;
+#endif
+}
+
+void GpuTimerGl::resolve() {
+    if (!isInitialized || !isSupported || !profiler) {
+        return;
+    }
+    for (uint32_t queryFrameIdx = 0; queryFrameIdx < NUM_QUERY_FRAMES; queryFrameIdx++) {
+        resolveQueryFrame(queryFrameIdx);
+    }
+}
+
+bool GpuTimerGl::resolveQueryFrame(uint32_t queryFrameIdx) {
+    QueryFrame& queryFrame = queryFrames.at(queryFrameIdx);
+#ifdef SUPPORT_OPENGL
+    for (size_t stageIdx = 0; stageIdx < NUM_FRAME_STAGES; stageIdx++) {
+        uint32_t stageBit = 1u << uint32_t(stageIdx);
+        if ((queryFrame.pendingStagesMask & stageBit) == 0) {
+            continue;
+        }
+        size_t firstQuery = (queryFrameIdx * NUM_FRAME_STAGES + stageIdx) * 2;
+        // The end query finishes last, so the begin query is available as well.
+        GLint isAvailable = 0;
+        glGetQueryObjectiv(queries.at(firstQuery + 1), GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+        if (!isAvailable) {
+            continue;
+        }
+        GLuint64 startTime = 0, endTime = 0;
+        glGetQueryObjectui64v(queries.at(firstQuery), GL_QUERY_RESULT, &startTime);
+        glGetQueryObjectui64v(queries.at(firstQuery + 1), GL_QUERY_RESULT, &endTime);
+        profiler->recordGpuEvent(
+                FrameStage(stageIdx), FrameEventSource::GPU_OPENGL, queryFrame.frameIndex,
+                queryFrame.cpuStartNs.at(stageIdx), int64_t(endTime - startTime));
+        queryFrame.pendingStagesMask &= ~stageBit;
+    }
+#endif
+    return queryFrame.pendingStagesMask == 0;
+}
+
+
+FrameProfiler::FrameProfiler() : startTime(std::chrono::steady_clock::now()), gpuTimerVk(this) {
+}
+
+void FrameProfiler::initializeVk(sgl::vk::Device* device) {
+    gpuTimerVk.initialize(device);
+}
+
+void FrameProfiler::destroyVk() {
+    gpuTimerVk.destroy();
+}
+
+void FrameProfiler::recordCpuEvent(FrameStage stage, int64_t startNs, int64_t endNs) {
+    FrameEvent event{};
+    event.stage = stage;
+    event.source = FrameEventSource::CPU;
+    event.threadId = getProfilerThreadId();
+    event.frameIndex = frameIndex;
+    event.startNs = startNs;
+    event.durationNs = endNs - startNs;
+    eventRing.push(event);
+}
+
+void FrameProfiler::recordGpuEvent(
+        FrameStage stage, FrameEventSource source, uint64_t eventFrameIndex, int64_t cpuStartNs,
+        int64_t durationNs) {
+    FrameEvent event{};
+    event.stage = stage;
+    event.source = source;
+    event.frameIndex = eventFrameIndex;
+    event.startNs = cpuStartNs;
+    event.durationNs = durationNs;
+    eventRing.push(event);
+}
+
+void FrameProfiler::endFrame() {
+    if (isEnabled) {
+        gpuTimerVk.resolve();
+    }
+
+    // GPU results arrive a few frames late, so the events are summed up in the history slot of their frame.
+    newEvents.clear();
+    historyReadIndex = eventRing.read(historyReadIndex, newEvents);
+    for (const FrameEvent& event : newEvents) {
+        if (event.frameIndex > frameIndex || frameIndex - event.frameIndex >= uint64_t(HISTORY_SIZE - 1)) {
+            continue;
+        }
+        auto historyIdx = size_t(event.frameIndex % uint64_t(HISTORY_SIZE));
+        stageHistories.at(size_t(event.stage)).at(historyIdx) += float(double(event.durationNs) * 1e-6);
+    }
+    if (isRecording) {
+        for (const FrameEvent& event : newEvents) {
+            if (event.frameIndex < recordingStartFrame
+                    || event.frameIndex - recordingStartFrame >= uint64_t(recordedFrames.size())) {
+                continue;
+            }
+            RecordedFrame& recordedFrame = recordedFrames.at(size_t(event.frameIndex - recordingStartFrame));
+            recordedFrame.stageTimesMs.at(size_t(event.stage)) += float(double(event.durationNs) * 1e-6);
+        }
+    }
+
+    int64_t endFrameNs = getTimeNs();
+    frameTimeHistory.at(size_t(frameIndex % uint64_t(HISTORY_SIZE))) =
+            lastEndFrameNs > 0 ? float(double(endFrameNs - lastEndFrameNs) * 1e-6) : 0.0f;
+    if (isRecording) {
+        recordedFrames.back().frameTimeMs = float(double(endFrameNs - lastEndFrameNs) * 1e-6);
+        recordedFrames.emplace_back();
+    }
+    lastEndFrameNs = endFrameNs;
+    frameIndex++;
+    auto historyIdx = size_t(frameIndex % uint64_t(HISTORY_SIZE));
+    for (auto& stageHistory : stageHistories) {
+        stageHistory.at(historyIdx) = 0.0f;
+    }
+}
+
+float FrameProfiler::getStageAverageMs(FrameStage stage) const {
+    double sum = 0.0;
+    int numFrames = 0;
+    for (float timeMs : stageHistories.at(size_t(stage))) {
+        if (timeMs > 0.0f) {
+            sum += double(timeMs);
+            numFrames++;
+        }
+    }
+    return numFrames > 0 ? float(sum / double(numFrames)) : 0.0f;
+}
+
+float FrameProfiler::getFrameTimeAverageMs() const {
+    double sum = 0.0;
+    int numFrames = 0;
+    for (float timeMs : frameTimeHistory) {
+        if (timeMs > 0.0f) {
+            sum += double(timeMs);
+            numFrames++;
+        }
+    }
+    return numFrames > 0 ? float(sum / double(numFrames)) : 0.0f;
+}
+
+void FrameProfiler::resetHistories() {
+    for (auto& stageHistory : stageHistories) {
+        stageHistory.fill(0.0f);
+    }
+    frameTimeHistory.fill(0.0f);
+}
+
+float FrameProfiler::getStageMaxMs(FrameStage stage) const {
+    const auto& stageHistory = stageHistories.at(size_t(stage));
+    return *std::max_element(stageHistory.begin(), stageHistory.end());
+}
+
+bool FrameProfiler::exportChromeTrace(const std::string& filePath) const {
+    std::ofstream file(filePath);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::vector<FrameEvent> events;
+    eventRing.read(0, events);
+
+    // GPU events get their own rows; the trace viewer expects times in microseconds.
+    const uint32_t gpuThreadIdVulkan = 1000, gpuThreadIdOpenGL = 1001;
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << gpuThreadIdVulkan
+         << ",\"args\":{\"name\":\"GPU (Vulkan)\"}},\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << gpuThreadIdOpenGL
+         << ",\"args\":{\"name\":\"GPU (OpenGL)\"}}";
+    file << std::fixed << std::setprecision(3);
+    for (const FrameEvent& event : events) {
+        uint32_t threadId = event.threadId;
+        const char* category = "cpu";
+        if (event.source == FrameEventSource::GPU_VULKAN) {
+            threadId = gpuThreadIdVulkan;
+            category = "gpu";
+        } else if (event.source == FrameEventSource::GPU_OPENGL) {
+            threadId = gpuThreadIdOpenGL;
+            category = "gpu";
+        }
+        file << ",\n{\"name\":\"" << FRAME_STAGE_NAMES[size_t(event.stage)] << "\",\"cat\":\"" << category
+             << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadId
+             << ",\"ts\":" << double(event.startNs) * 1e-3 << ",\"dur\":" << double(event.durationNs) * 1e-3
+             << ",\"args\":{\"frame\":" << event.frameIndex << "}}";
+    }
+    file << "\n]}\n";
+    return bool(file);
+}
+
+void FrameProfiler::startRecording() {
+    isRecording = true;
+    recordingStartFrame = frameIndex;
+    recordedFrames.clear();
+    recordedFrames.emplace_back();
+}
+
+bool FrameProfiler::writeRecordedFramesCsv(const std::string& filePath, size_t numFrames) const {
+    std::ofstream file(filePath);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << "frame,frame_time_ms";
+    for (const char* stageName : FRAME_STAGE_NAMES) {
+        file << ",\"" << stageName << "\"";
+    }
+    file << "\n";
+    file << std::fixed << std::setprecision(4);
+    numFrames = std::min(numFrames, recordedFrames.size());
+    for (size_t frameIdx = 0; frameIdx < numFrames; frameIdx++) {
+        const RecordedFrame& recordedFrame = recordedFrames.at(frameIdx);
+        file << frameIdx << "," << recordedFrame.frameTimeMs;
+        for (float stageTimeMs : recordedFrame.stageTimesMs) {
+            file << "," << stageTimeMs;
+        }
+        file << "\n";
+    }
+    return bool(file);
+}
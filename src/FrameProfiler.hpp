@@ -0,0 +1,265 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FRAMEPROFILER_HPP
+#define FRAMEPROFILER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Graphics/Vulkan/Utils/Device.hpp>
+
+/// Timed stages of a frame. The GPU stages are measured with timestamp queries and resolved a few frames later.
+enum class FrameStage : uint32_t {
+    DIAGRAM_UPDATE, WIDGET_RENDER, NANOVG_BEGIN_INTEROP, RENDER_BASE_NANOVG, RENDER_CHORD_DIAGRAM_NANOVG,
+    NANOVG_FLUSH_INTEROP, RENDER_BASE_CURVES_VK, BLIT_TO_TARGET_VK, INTEROP_LATENCY, INTEROP_COPY,
+    RENDER_BASE_RASTER_CPU, RASTERIZE_TILES_CPU,
+    GPU_NANOVG_GL, GPU_CURVES_VK, GPU_BLIT_VK,
+    NUM_STAGES
+};
+constexpr size_t NUM_FRAME_STAGES = size_t(FrameStage::NUM_STAGES);
+const char* const FRAME_STAGE_NAMES[] = {
+        "Diagram Update", "Widget Render", "NanoVG Begin + Interop Wait", "Render Base (NanoVG)",
+        "Render Chord Diagram (NanoVG)", "NanoVG Flush + Interop Signal", "Render Base (Vulkan Curves)",
+        "Blit to Target (Vulkan)", "Interop Latency (Pipelined)", "Interop Readback + Copy (PBO)",
+        "Render Base (CPU Raster)", "Rasterize Tiles (CPU)",
+        "GPU NanoVG (OpenGL)", "GPU Curves (Vulkan)", "GPU Blit (Vulkan)"
+};
+
+enum class FrameEventSource : uint32_t {
+    CPU, GPU_VULKAN, GPU_OPENGL
+};
+
+struct FrameEvent {
+    FrameStage stage;
+    FrameEventSource source;
+    uint32_t threadId; //< Small ID assigned on first use per thread; only set for CPU events.
+    uint64_t frameIndex;
+    int64_t startNs; //< CPU time since the profiler was created; GPU events use the CPU time of their submission.
+    int64_t durationNs;
+};
+
+/**
+ * Fixed-size ring buffer of frame events that may be written from multiple threads without locks. Writers claim a slot
+ * with an atomic counter, and each slot is guarded by a sequence number, so readers skip slots that are being written
+ * or were already overwritten.
+ */
+class FrameEventRing {
+public:
+    static constexpr uint64_t CAPACITY = 16384; //< Power of two.
+    FrameEventRing();
+    void push(const FrameEvent& event);
+    /// Appends the events in [begin, getWriteIndex()) still held by the buffer; returns the end of the read range.
+    uint64_t read(uint64_t begin, std::vector<FrameEvent>& events) const;
+    [[nodiscard]] inline uint64_t getWriteIndex() const { return writeIndex.load(std::memory_order_acquire); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence{0}; //< 2 * index + 1 while being written, 2 * index + 2 afterwards.
+        std::atomic<uint32_t> stage{0};
+        std::atomic<uint32_t> source{0};
+        std::atomic<uint32_t> threadId{0};
+        std::atomic<uint64_t> frameIndex{0};
+        std::atomic<int64_t> startNs{0};
+        std::atomic<int64_t> durationNs{0};
+    };
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> writeIndex{0};
+};
+
+class FrameProfiler;
+
+/**
+ * Vulkan timestamp queries for the GPU stages. Each frame in flight uses its own range of the query pool, and the
+ * results are fetched without waiting, i.e., stages whose results are not available after NUM_QUERY_FRAMES frames are
+ * dropped.
+ */
+class GpuTimerVk {
+public:
+    static constexpr uint32_t NUM_QUERY_FRAMES = 4;
+    explicit GpuTimerVk(FrameProfiler* profiler) : profiler(profiler) {}
+    ~GpuTimerVk();
+    void initialize(sgl::vk::Device* _device);
+    void destroy();
+    /// Must be called outside of render passes.
+    void begin(FrameStage stage, VkCommandBuffer commandBuffer);
+    void end(FrameStage stage, VkCommandBuffer commandBuffer);
+    /// Records the events of all stages with available results in the profiler.
+    void resolve();
+
+private:
+    bool resolveQueryFrame(uint32_t queryFrameIdx);
+    FrameProfiler* profiler;
+    sgl::vk::Device* device = nullptr;
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    float timestampPeriod = 1.0f; //< Nanoseconds per tick.
+    struct QueryFrame {
+        uint64_t frameIndex = 0;
+        uint32_t openStagesMask = 0; //< Begin, but no end query written yet.
+        uint32_t pendingStagesMask = 0; //< Both queries written, result not fetched yet.
+        std::array<int64_t, NUM_FRAME_STAGES> cpuStartNs{};
+    };
+    std::array<QueryFrame, NUM_QUERY_FRAMES> queryFrames{};
+};
+
+/**
+ * OpenGL timestamp queries for the GPU stages; the same scheme as @see GpuTimerVk. All functions must be called with
+ * the OpenGL context current. Does nothing if sgl was built without OpenGL or GL_ARB_timer_query is not supported.
+ */
+class GpuTimerGl {
+public:
+    static constexpr uint32_t NUM_QUERY_FRAMES = 4;
+    explicit GpuTimerGl(FrameProfiler* profiler) : profiler(profiler) {}
+    void destroy();
+    void begin(FrameStage stage);
+    void end(FrameStage stage);
+    void resolve();
+    inline void setFrameProfiler(FrameProfiler* _profiler) { profiler = _profiler; }
+
+private:
+    bool initialize();
+    bool resolveQueryFrame(uint32_t queryFrameIdx);
+    FrameProfiler* profiler;
+    bool isInitialized = false;
+    bool isSupported = true;
+    std::vector<uint32_t> queries; //< Begin and end query per stage and query frame.
+    struct QueryFrame {
+        uint64_t frameIndex = 0;
+        uint32_t openStagesMask = 0; //< Begin, but no end query written yet.
+        uint32_t pendingStagesMask = 0; //< Both queries written, result not fetched yet.
+        std::array<int64_t, NUM_FRAME_STAGES> cpuStartNs{};
+    };
+    std::array<QueryFrame, NUM_QUERY_FRAMES> queryFrames{};
+};
+
+/**
+ * Collects CPU and GPU timings of the frame stages. The events are kept in a @see FrameEventRing, summed up per frame
+ * for rolling histories shown in the UI and can be exported as a Chrome trace (chrome://tracing, Perfetto).
+ */
+class FrameProfiler {
+public:
+    static constexpr int HISTORY_SIZE = 240; //< In frames.
+    FrameProfiler();
+    void initializeVk(sgl::vk::Device* device);
+    void destroyVk();
+
+    inline void setEnabled(bool _isEnabled) { isEnabled = _isEnabled; }
+    [[nodiscard]] inline bool getIsEnabled() const { return isEnabled; }
+    [[nodiscard]] inline uint64_t getFrameIndex() const { return frameIndex; }
+    [[nodiscard]] inline int64_t getTimeNs() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    void recordCpuEvent(FrameStage stage, int64_t startNs, int64_t endNs);
+    void recordGpuEvent(
+            FrameStage stage, FrameEventSource source, uint64_t eventFrameIndex, int64_t cpuStartNs,
+            int64_t durationNs);
+    inline void beginGpuStageVk(FrameStage stage, VkCommandBuffer commandBuffer) {
+        if (isEnabled) gpuTimerVk.begin(stage, commandBuffer);
+    }
+    inline void endGpuStageVk(FrameStage stage, VkCommandBuffer commandBuffer) {
+        if (isEnabled) gpuTimerVk.end(stage, commandBuffer);
+    }
+
+    /// Called once at the end of each frame; resolves the Vulkan queries and updates the histories.
+    void endFrame();
+
+    /// Per-frame stage times in milliseconds; index getHistoryOffset() is the oldest frame.
+    [[nodiscard]] inline const float* getStageHistory(FrameStage stage) const {
+        return stageHistories.at(size_t(stage)).data();
+    }
+    [[nodiscard]] inline int getHistoryOffset() const { return int((frameIndex + 1) % uint64_t(HISTORY_SIZE)); }
+    /// Mean over the frames in the history that contain the stage.
+    [[nodiscard]] float getStageAverageMs(FrameStage stage) const;
+    [[nodiscard]] float getStageMaxMs(FrameStage stage) const;
+    /// Mean CPU time between the ends of consecutive frames in the history.
+    [[nodiscard]] float getFrameTimeAverageMs() const;
+    /// Clears the histories, e.g., after a settings change that is compared against the previous one.
+    void resetHistories();
+
+    /// Writes all events still held by the ring buffer as Chrome trace event JSON.
+    bool exportChromeTrace(const std::string& filePath) const;
+
+    /// Keeps the stage times of all frames from the current one on, e.g., for benchmarks (@see PlaybackScript).
+    void startRecording();
+    [[nodiscard]] inline size_t getNumRecordedFrames() const { return recordedFrames.size(); }
+    /// Writes one CSV line per recorded frame with the frame time and all stage times in milliseconds.
+    bool writeRecordedFramesCsv(const std::string& filePath, size_t numFrames) const;
+
+private:
+    bool isEnabled = true;
+    std::chrono::steady_clock::time_point startTime;
+    uint64_t frameIndex = 0;
+    FrameEventRing eventRing;
+    uint64_t historyReadIndex = 0;
+    std::vector<FrameEvent> newEvents;
+    std::array<std::array<float, HISTORY_SIZE>, NUM_FRAME_STAGES> stageHistories{};
+    std::array<float, HISTORY_SIZE> frameTimeHistory{};
+    GpuTimerVk gpuTimerVk;
+
+    // Frames kept since startRecording; the last entry is the current frame.
+    struct RecordedFrame {
+        float frameTimeMs = 0.0f; //< CPU time between the end of the previous and this frame.
+        std::array<float, NUM_FRAME_STAGES> stageTimesMs{};
+    };
+    bool isRecording = false;
+    uint64_t recordingStartFrame = 0;
+    std::vector<RecordedFrame> recordedFrames;
+    int64_t lastEndFrameNs = 0;
+};
+
+/// Records the CPU time between construction and destruction as an event of the passed stage.
+class FrameProfilerScope {
+public:
+    inline FrameProfilerScope(FrameProfiler* profiler, FrameStage stage)
+            : profiler(profiler && profiler->getIsEnabled() ? profiler : nullptr), stage(stage) {
+        if (this->profiler) {
+            startNs = this->profiler->getTimeNs();
+        }
+    }
+    inline ~FrameProfilerScope() {
+        if (profiler) {
+            profiler->recordCpuEvent(stage, startNs, profiler->getTimeNs());
+        }
+    }
+    FrameProfilerScope(const FrameProfilerScope&) = delete;
+    FrameProfilerScope& operator=(const FrameProfilerScope&) = delete;
+
+private:
+    FrameProfiler* profiler;
+    FrameStage stage;
+    int64_t startNs = 0;
+};
+
+#endif //FRAMEPROFILER_HPP
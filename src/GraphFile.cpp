@@ -0,0 +1,504 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ChordDiagramModel.hpp"
+#include "GraphFile.hpp"
+
+MappedFile::MappedFile(const std::string& filePath) {
+#ifdef _WIN32
+    HANDLE fileHandle = CreateFileA(
+            filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Error in MappedFile::MappedFile: Could not open \"" + filePath + "\".");
+    }
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        CloseHandle(fileHandle);
+        throw std::runtime_error("Error in MappedFile::MappedFile: Could not query the size of \"" + filePath + "\".");
+    }
+    size = size_t(fileSize.QuadPart);
+    if (size > 0) {
+        fileMappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (fileMappingHandle) {
+            data = static_cast<const uint8_t*>(MapViewOfFile(fileMappingHandle, FILE_MAP_READ, 0, 0, 0));
+        }
+    }
+    CloseHandle(fileHandle);
+    if (size > 0 && !data) {
+        if (fileMappingHandle) {
+            CloseHandle(fileMappingHandle);
+        }
+        throw std::runtime_error("Error in MappedFile::MappedFile: Could not map \"" + filePath + "\".");
+    }
+#else
+    int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        throw std::runtime_error("Error in MappedFile::MappedFile: Could not open \"" + filePath + "\".");
+    }
+    struct stat fileStat{};
+    if (fstat(fileDescriptor, &fileStat) != 0) {
+        close(fileDescriptor);
+        throw std::runtime_error("Error in MappedFile::MappedFile: Could not query the size of \"" + filePath + "\".");
+    }
+    size = size_t(fileStat.st_size);
+    if (size > 0) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        if (mapping == MAP_FAILED) {
+            close(fileDescriptor);
+            throw std::runtime_error("Error in MappedFile::MappedFile: Could not map \"" + filePath + "\".");
+        }
+        data = static_cast<const uint8_t*>(mapping);
+    }
+    // The mapping keeps a reference to the file.
+    close(fileDescriptor);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+    if (data) {
+        UnmapViewOfFile(data);
+    }
+    if (fileMappingHandle) {
+        CloseHandle(fileMappingHandle);
+    }
+#else
+    if (data) {
+        munmap(const_cast<uint8_t*>(data), size);
+    }
+#endif
+}
+
+void MappedFile::adviseSequential() {
+#ifndef _WIN32
+    if (data) {
+        posix_madvise(const_cast<uint8_t*>(data), size, POSIX_MADV_SEQUENTIAL);
+    }
+#endif
+}
+
+void MappedFile::releasePages(size_t offset, size_t length) {
+#ifndef _WIN32
+    // madvise only accepts page-aligned ranges; partially covered pages are kept.
+    auto pageSize = size_t(sysconf(_SC_PAGESIZE));
+    auto base = reinterpret_cast<uintptr_t>(data);
+    uintptr_t begin = (base + offset + pageSize - 1) / pageSize * pageSize;
+    uintptr_t end = (base + std::min(offset + length, size)) / pageSize * pageSize;
+    if (data && begin < end) {
+        madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+    }
+#endif
+}
+
+static bool getIsRangeInFile(uint64_t offset, uint64_t numElements, uint64_t elementSize, size_t fileSize) {
+    return offset <= fileSize && numElements <= (uint64_t(fileSize) - offset) / elementSize;
+}
+
+GraphFile::GraphFile(const std::string& filePath) : mappedFile(filePath) {
+    if (mappedFile.getSize() < sizeof(GraphFileHeader)) {
+        throw std::runtime_error("Error in GraphFile::GraphFile: \"" + filePath + "\" is not a graph file.");
+    }
+    std::memcpy(&header, mappedFile.getData(), sizeof(GraphFileHeader));
+    if (std::memcmp(header.magic, "HEBG", 4) != 0) {
+        throw std::runtime_error("Error in GraphFile::GraphFile: \"" + filePath + "\" is not a graph file.");
+    }
+    if (header.version != GRAPH_FILE_VERSION) {
+        throw std::runtime_error(
+                "Error in GraphFile::GraphFile: Unsupported version " + std::to_string(header.version)
+                + " in \"" + filePath + "\".");
+    }
+    size_t fileSize = mappedFile.getSize();
+    if (header.edgeStride < sizeof(GraphFileEdge) || header.numNodes > std::numeric_limits<uint32_t>::max()
+            || !getIsRangeInFile(header.edgeTableOffset, header.numEdges, header.edgeStride, fileSize)
+            || !getIsRangeInFile(header.nodeTableOffset, header.numNodes, sizeof(GraphFileNode), fileSize)
+            || !getIsRangeInFile(header.stringTableOffset, header.stringTableSize, 1, fileSize)) {
+        throw std::runtime_error("Error in GraphFile::GraphFile: Corrupt header in \"" + filePath + "\".");
+    }
+}
+
+std::string_view GraphFile::getNodeName(uint32_t nodeIdx) const {
+    if (nodeIdx >= header.numNodes) {
+        throw std::runtime_error("Error in GraphFile::getNodeName: Node index out of range.");
+    }
+    GraphFileNode node{};
+    std::memcpy(
+            &node, mappedFile.getData() + header.nodeTableOffset + size_t(nodeIdx) * sizeof(GraphFileNode),
+            sizeof(GraphFileNode));
+    if (node.nameOffset > header.stringTableSize || node.nameLength > header.stringTableSize - node.nameOffset) {
+        throw std::runtime_error("Error in GraphFile::getNodeName: Name out of range.");
+    }
+    return {
+        reinterpret_cast<const char*>(mappedFile.getData() + header.stringTableOffset + node.nameOffset),
+        size_t(node.nameLength) };
+}
+
+void GraphFile::loadIntoModel(ChordDiagramModel& model, int branchingFactor) {
+    if (header.numNodes > uint64_t(std::numeric_limits<int>::max())) {
+        throw std::runtime_error("Error in GraphFile::loadIntoModel: Too many nodes.");
+    }
+    mappedFile.adviseSequential();
+    model.buildRadialHierarchy(int(header.numNodes), branchingFactor);
+    float weightScale = header.maxWeight > 1.0f ? 1.0f / header.maxWeight : 1.0f;
+    model.setEdgesFromRecords(getEdgeRecords(), getNumEdges(), getEdgeStride(), weightScale);
+}
+
+/// Append-only storage for node names. Views stay valid, as blocks are never reallocated.
+class StringArena {
+public:
+    std::string_view store(std::string_view str) {
+        if (blocks.empty() || blockUsed + str.size() > blockSize) {
+            blockSize = std::max(BLOCK_SIZE, str.size());
+            blocks.emplace_back(new char[blockSize]);
+            blockUsed = 0;
+        }
+        char* dst = blocks.back().get() + blockUsed;
+        std::memcpy(dst, str.data(), str.size());
+        blockUsed += str.size();
+        return { dst, str.size() };
+    }
+
+private:
+    static constexpr size_t BLOCK_SIZE = size_t(1) << 20;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    size_t blockSize = 0;
+    size_t blockUsed = 0;
+};
+
+/**
+ * Maps node names to indices in order of first appearance. Open addressing with linear probing; the slots cache the
+ * hash and the name so that a lookup usually touches a single cache line of the table and one of the name arena.
+ * Node-based hash maps spend most of the import time on cache misses for graphs with many nodes.
+ */
+class NodeNameTable {
+public:
+    NodeNameTable() : slots(MIN_NUM_SLOTS) {}
+
+    [[nodiscard]] inline const std::vector<std::string_view>& getNodeNames() const { return nodeNames; }
+
+    uint32_t getNodeIdx(std::string_view name) {
+        uint64_t hash = hashName(name);
+        auto hashTag = uint32_t(hash >> 32);
+        auto mask = slots.size() - 1;
+        for (size_t slotIdx = size_t(hash) & mask; ; slotIdx = (slotIdx + 1) & mask) {
+            Slot& slot = slots[slotIdx];
+            if (!slot.name) {
+                return insert(slot, name, hashTag);
+            }
+            if (slot.hashTag == hashTag && slot.nameLength == name.size()
+                    && std::memcmp(slot.name, name.data(), name.size()) == 0) {
+                return slot.nodeIdx;
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        const char* name = nullptr; //< Points into the arena; null for empty slots.
+        uint32_t nameLength = 0;
+        uint32_t hashTag = 0; //< Upper bits of the name hash.
+        uint32_t nodeIdx = 0;
+    };
+    static constexpr size_t MIN_NUM_SLOTS = 1024;
+
+    static inline uint64_t hashName(std::string_view name) {
+        // FNV-1a on eight bytes at a time, followed by a final mix so that the low bits depend on all bytes.
+        uint64_t hash = 0xcbf29ce484222325ull;
+        size_t pos = 0;
+        for (; pos + 8 <= name.size(); pos += 8) {
+            uint64_t word;
+            std::memcpy(&word, name.data() + pos, 8);
+            hash = (hash ^ word) * 0x100000001b3ull;
+        }
+        for (; pos < name.size(); pos++) {
+            hash = (hash ^ uint8_t(name[pos])) * 0x100000001b3ull;
+        }
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        return hash ^ (hash >> 33);
+    }
+
+    uint32_t insert(Slot& slot, std::string_view name, uint32_t hashTag) {
+        if (nodeNames.size() >= size_t(std::numeric_limits<int>::max())) {
+            throw std::runtime_error("Error in importCsvGraph: Too many nodes.");
+        }
+        auto nodeIdx = uint32_t(nodeNames.size());
+        nodeNames.push_back(nameArena.store(name));
+        slot = { nodeNames.back().data(), uint32_t(name.size()), hashTag, nodeIdx };
+        // Keep the load factor below 1/2.
+        if (2 * nodeNames.size() > slots.size()) {
+            std::vector<Slot> oldSlots(slots.size() * 2);
+            oldSlots.swap(slots);
+            auto mask = slots.size() - 1;
+            for (const Slot& oldSlot : oldSlots) {
+                if (oldSlot.name) {
+                    size_t slotIdx = size_t(hashName({ oldSlot.name, oldSlot.nameLength })) & mask;
+                    while (slots[slotIdx].name) {
+                        slotIdx = (slotIdx + 1) & mask;
+                    }
+                    slots[slotIdx] = oldSlot;
+                }
+            }
+        }
+        return nodeIdx;
+    }
+
+    StringArena nameArena;
+    std::vector<std::string_view> nodeNames;
+    std::vector<Slot> slots;
+};
+
+static inline bool isCsvWhitespace(char c, char separator) {
+    return (c == ' ' || c == '\t') && c != separator;
+}
+
+int splitCsvRow(std::string_view row, char separator, std::string_view* fields, int maxNumFields) {
+    int numFields = 0;
+    size_t pos = 0;
+    while (numFields < maxNumFields) {
+        while (pos < row.size() && isCsvWhitespace(row[pos], separator)) {
+            pos++;
+        }
+        size_t separatorPos;
+        if (pos < row.size() && row[pos] == '"') {
+            size_t quotePos = row.find('"', pos + 1);
+            if (quotePos == std::string_view::npos) {
+                return -1;
+            }
+            fields[numFields++] = row.substr(pos + 1, quotePos - pos - 1);
+            separatorPos = row.find(separator, quotePos + 1);
+        } else {
+            separatorPos = row.find(separator, pos);
+            size_t fieldEnd = separatorPos == std::string_view::npos ? row.size() : separatorPos;
+            while (fieldEnd > pos && isCsvWhitespace(row[fieldEnd - 1], separator)) {
+                fieldEnd--;
+            }
+            fields[numFields++] = row.substr(pos, fieldEnd - pos);
+        }
+        if (separatorPos == std::string_view::npos) {
+            break;
+        }
+        pos = separatorPos + 1;
+    }
+    return numFields;
+}
+
+bool parseCsvWeight(std::string_view field, float& weight) {
+    // Fast path for plain decimals like "0.25", which are exact in double precision up to 15 significant digits.
+    size_t pos = field.size() > 0 && (field[0] == '-' || field[0] == '+') ? 1 : 0;
+    uint64_t mantissa = 0;
+    int numDigits = 0, numFractionDigits = 0;
+    bool hasDecimalPoint = false;
+    for (; pos < field.size() && numDigits <= 15; pos++) {
+        char c = field[pos];
+        if (c >= '0' && c <= '9') {
+            mantissa = mantissa * 10 + uint64_t(c - '0');
+            numDigits++;
+            numFractionDigits += hasDecimalPoint ? 1 : 0;
+        } else if (c == '.' && !hasDecimalPoint) {
+            hasDecimalPoint = true;
+        } else {
+            break;
+        }
+    }
+    if (pos == field.size() && numDigits > 0 && numDigits <= 15) {
+        static const double POWERS_OF_TEN[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+        double value = double(mantissa) / POWERS_OF_TEN[numFractionDigits];
+        weight = float(field[0] == '-' ? -value : value);
+        return true;
+    }
+
+    // General case, e.g., exponents; strtof needs a terminated string, and longer fields are rejected.
+    char buffer[64];
+    if (field.empty() || field.size() >= sizeof(buffer)) {
+        return false;
+    }
+    std::memcpy(buffer, field.data(), field.size());
+    buffer[field.size()] = '\0';
+    char* end = nullptr;
+    weight = std::strtof(buffer, &end);
+    return end == buffer + field.size() && std::isfinite(weight);
+}
+
+CsvImportStatistics importCsvGraph(
+        const std::string& csvFilePath, const std::string& graphFilePath, const CsvImportSettings& settings) {
+    const int maxColumn = std::max({ settings.sourceColumn, settings.targetColumn, settings.weightColumn });
+    if (settings.sourceColumn < 0 || settings.targetColumn < 0 || settings.sourceColumn == settings.targetColumn
+            || maxColumn >= 64) {
+        throw std::runtime_error("Error in importCsvGraph: Invalid column indices.");
+    }
+    MappedFile csvFile(csvFilePath);
+    csvFile.adviseSequential();
+    std::ofstream file(graphFilePath, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Error in importCsvGraph: Could not open \"" + graphFilePath + "\" for writing.");
+    }
+
+    // The header is written last, when the table offsets are known. Until then, the zeroed placeholder makes sure that
+    // files of failed imports are not accepted as graph files.
+    GraphFileHeader header{};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(GraphFileHeader));
+    std::memcpy(header.magic, "HEBG", 4);
+    header.version = GRAPH_FILE_VERSION;
+    header.edgeTableOffset = sizeof(GraphFileHeader);
+    header.edgeStride = uint32_t(sizeof(GraphFileEdge));
+
+    CsvImportStatistics statistics;
+    NodeNameTable nodeNameTable;
+
+    constexpr size_t EDGE_BUFFER_SIZE = size_t(1) << 16;
+    std::vector<GraphFileEdge> edgeBuffer;
+    edgeBuffer.reserve(EDGE_BUFFER_SIZE);
+    auto flushEdges = [&]() {
+        file.write(
+                reinterpret_cast<const char*>(edgeBuffer.data()),
+                std::streamsize(edgeBuffer.size() * sizeof(GraphFileEdge)));
+        edgeBuffer.clear();
+    };
+
+    // Node names are copied to the arena, so the parsed part of the CSV file can be dropped from memory regularly.
+    constexpr size_t RELEASE_INTERVAL = size_t(64) << 20;
+    const auto* csvData = reinterpret_cast<const char*>(csvFile.getData());
+    const size_t csvSize = csvFile.getSize();
+    size_t lineStart = csvSize >= 3 && std::memcmp(csvData, "\xEF\xBB\xBF", 3) == 0 ? 3 : 0;
+    size_t releasedEnd = 0;
+    size_t lineNumber = 0;
+    bool skipHeader = settings.hasHeader;
+    float maxWeight = 0.0f;
+    std::string_view fields[64];
+    while (lineStart < csvSize) {
+        const auto* newline = static_cast<const char*>(std::memchr(csvData + lineStart, '\n', csvSize - lineStart));
+        size_t lineEnd = newline ? size_t(newline - csvData) : csvSize;
+        std::string_view row(csvData + lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+        lineNumber++;
+        if (!row.empty() && row.back() == '\r') {
+            row.remove_suffix(1);
+        }
+        if (row.empty() || row.front() == '#') {
+            continue;
+        }
+        if (skipHeader) {
+            skipHeader = false;
+            continue;
+        }
+
+        int numFields = splitCsvRow(row, settings.separator, fields, maxColumn + 1);
+        if (numFields <= std::max(settings.sourceColumn, settings.targetColumn)
+                || fields[settings.sourceColumn].empty() || fields[settings.targetColumn].empty()) {
+            throw std::runtime_error(
+                    "Error in importCsvGraph: Malformed row in line " + std::to_string(lineNumber) + ".");
+        }
+        float weight = 1.0f;
+        if (settings.weightColumn >= 0 && numFields > settings.weightColumn
+                && !parseCsvWeight(fields[settings.weightColumn], weight)) {
+            throw std::runtime_error(
+                    "Error in importCsvGraph: Invalid weight in line " + std::to_string(lineNumber) + ".");
+        }
+        uint32_t nodeIdx0 = nodeNameTable.getNodeIdx(fields[settings.sourceColumn]);
+        uint32_t nodeIdx1 = nodeNameTable.getNodeIdx(fields[settings.targetColumn]);
+        if (nodeIdx0 == nodeIdx1) {
+            statistics.numSelfLoops++;
+            continue;
+        }
+        edgeBuffer.push_back({ nodeIdx0, nodeIdx1, weight });
+        maxWeight = std::max(maxWeight, weight);
+        statistics.numEdges++;
+        if (edgeBuffer.size() == EDGE_BUFFER_SIZE) {
+            flushEdges();
+        }
+        if (lineStart - releasedEnd >= RELEASE_INTERVAL) {
+            csvFile.releasePages(releasedEnd, lineStart - releasedEnd);
+            releasedEnd = lineStart;
+        }
+    }
+    flushEdges();
+
+    // Node table (8-byte aligned) and string table.
+    const std::vector<std::string_view>& nodeNames = nodeNameTable.getNodeNames();
+    uint64_t edgeTableEnd = header.edgeTableOffset + statistics.numEdges * sizeof(GraphFileEdge);
+    header.nodeTableOffset = (edgeTableEnd + 7) / 8 * 8;
+    const char padding[8] = {};
+    file.write(padding, std::streamsize(header.nodeTableOffset - edgeTableEnd));
+    uint64_t nameOffset = 0;
+    std::vector<GraphFileNode> nodeBuffer;
+    nodeBuffer.reserve(std::min(nodeNames.size(), EDGE_BUFFER_SIZE));
+    for (size_t nodeIdx = 0; nodeIdx < nodeNames.size(); nodeIdx++) {
+        nodeBuffer.push_back({ nameOffset, uint32_t(nodeNames[nodeIdx].size()), 0 });
+        nameOffset += nodeNames[nodeIdx].size();
+        if (nodeBuffer.size() == EDGE_BUFFER_SIZE || nodeIdx + 1 == nodeNames.size()) {
+            file.write(
+                    reinterpret_cast<const char*>(nodeBuffer.data()),
+                    std::streamsize(nodeBuffer.size() * sizeof(GraphFileNode)));
+            nodeBuffer.clear();
+        }
+    }
+    header.stringTableOffset = header.nodeTableOffset + nodeNames.size() * sizeof(GraphFileNode);
+    header.stringTableSize = nameOffset;
+    for (const std::string_view& name : nodeNames) {
+        file.write(name.data(), std::streamsize(name.size()));
+    }
+
+    header.numNodes = nodeNames.size();
+    header.numEdges = statistics.numEdges;
+    header.maxWeight = maxWeight;
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(GraphFileHeader));
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Error in importCsvGraph: Could not write \"" + graphFilePath + "\".");
+    }
+    statistics.numNodes = nodeNames.size();
+    return statistics;
+}
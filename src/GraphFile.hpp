@@ -0,0 +1,155 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GRAPHFILE_HPP
+#define GRAPHFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+class ChordDiagramModel;
+
+/**
+ * Binary graph file format (".hebg", little-endian). The layout is designed for memory-mapped loading and streaming
+ * import: the header is followed by the fixed-stride edge table, and the node and string tables are written after the
+ * edges, when all node names are known.
+ */
+struct GraphFileHeader {
+    char magic[4]; //< "HEBG".
+    uint32_t version;
+    uint64_t numNodes;
+    uint64_t numEdges;
+    uint64_t edgeTableOffset; //< Array of numEdges records of edgeStride bytes; aligned to 4 bytes.
+    uint64_t nodeTableOffset; //< Array of numNodes GraphFileNode entries; aligned to 8 bytes.
+    uint64_t stringTableOffset; //< UTF-8 node names without null terminators.
+    uint64_t stringTableSize;
+    uint32_t edgeStride; //< At least sizeof(GraphFileEdge); larger strides allow for additional per-edge attributes.
+    float maxWeight; //< Maximum edge weight; weights are divided by it on load if it is larger than one.
+};
+static_assert(sizeof(GraphFileHeader) == 64, "Unexpected GraphFileHeader size.");
+
+struct GraphFileNode {
+    uint64_t nameOffset; //< Relative to the string table.
+    uint32_t nameLength;
+    uint32_t reserved;
+};
+static_assert(sizeof(GraphFileNode) == 16, "Unexpected GraphFileNode size.");
+
+struct GraphFileEdge {
+    uint32_t nodeIdx0; //< Leaf indices of the end points.
+    uint32_t nodeIdx1;
+    float weight;
+};
+static_assert(sizeof(GraphFileEdge) == 12, "Unexpected GraphFileEdge size.");
+
+const uint32_t GRAPH_FILE_VERSION = 1;
+const char* const GRAPH_FILE_EXTENSION = ".hebg";
+
+/// Read-only memory mapping of a whole file. Throws std::runtime_error if the file cannot be mapped.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filePath);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] inline const uint8_t* getData() const { return data; }
+    [[nodiscard]] inline size_t getSize() const { return size; }
+    /// Hints the OS to read ahead aggressively; the file is expected to be read front to back.
+    void adviseSequential();
+    /// Drops the pages of the range from the resident set where supported; they are read again from the file on access.
+    void releasePages(size_t offset, size_t length);
+
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* fileMappingHandle = nullptr;
+#endif
+};
+
+/**
+ * A memory-mapped graph file. Only the header is read on construction, which validates that all tables lie within the
+ * file; the edges are streamed from the mapping into the model by @see loadIntoModel.
+ */
+class GraphFile {
+public:
+    /// Throws std::runtime_error if the file cannot be mapped or is not a valid graph file.
+    explicit GraphFile(const std::string& filePath);
+
+    [[nodiscard]] inline uint32_t getNumNodes() const { return uint32_t(header.numNodes); }
+    [[nodiscard]] inline size_t getNumEdges() const { return size_t(header.numEdges); }
+    [[nodiscard]] inline size_t getEdgeStride() const { return size_t(header.edgeStride); }
+    [[nodiscard]] inline float getMaxWeight() const { return header.maxWeight; }
+    [[nodiscard]] inline const uint8_t* getEdgeRecords() const { return mappedFile.getData() + header.edgeTableOffset; }
+    /// The returned view points into the mapping; throws std::runtime_error if the name lies outside the string table.
+    [[nodiscard]] std::string_view getNodeName(uint32_t nodeIdx) const;
+
+    /// Builds a radial hierarchy with one leaf per node and streams the edges into the model.
+    void loadIntoModel(ChordDiagramModel& model, int branchingFactor);
+
+private:
+    MappedFile mappedFile;
+    GraphFileHeader header{};
+};
+
+struct CsvImportSettings {
+    char separator = ',';
+    bool hasHeader = true; //< Skips the first non-comment line.
+    int sourceColumn = 0;
+    int targetColumn = 1;
+    int weightColumn = 2; //< Negative or missing: all weights are one.
+};
+
+struct CsvImportStatistics {
+    uint64_t numNodes = 0;
+    uint64_t numEdges = 0;
+    uint64_t numSelfLoops = 0; //< Skipped, as they have no visual representation in the diagram.
+};
+
+/**
+ * Converts an edge list in CSV format (one "source,target[,weight]" row per edge; nodes are identified by name and
+ * lines starting with '#' are ignored) to a graph file. The CSV file is memory-mapped and the edges are written as
+ * they are parsed, so the memory usage only depends on the number of distinct nodes. Fields may be enclosed in
+ * double quotes. Throws std::runtime_error on I/O errors or malformed rows.
+ */
+CsvImportStatistics importCsvGraph(
+        const std::string& csvFilePath, const std::string& graphFilePath, const CsvImportSettings& settings = {});
+
+/**
+ * Splits a row into at most maxNumFields fields without copying, i.e., the fields point into row. Spaces and tabs
+ * around unquoted fields are trimmed (unless they are the separator); quoted fields are returned without the quotes.
+ * Returns the number of fields, or -1 for unterminated quotes.
+ */
+int splitCsvRow(std::string_view row, char separator, std::string_view* fields, int maxNumFields);
+/// Parses a finite floating-point number; returns false if the field is not a number as a whole.
+bool parseCsvWeight(std::string_view field, float& weight);
+
+#endif //GRAPHFILE_HPP
@@ -0,0 +1,251 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "HEBTree.hpp"
+
+void HEBTree::buildRadialHierarchy(
+        int numLeaves, int branchingFactor, std::vector<HEBNode>& nodes, uint32_t& leafIdxOffset) {
+    branchingFactor = std::max(branchingFactor, 2);
+
+    // Compute the level sizes bottom-up; levelSizes.front() is the root level.
+    std::vector<uint32_t> levelSizes;
+    uint32_t levelSize = uint32_t(std::max(numLeaves, 1));
+    levelSizes.push_back(levelSize);
+    while (levelSize > 1) {
+        levelSize = (levelSize + uint32_t(branchingFactor) - 1) / uint32_t(branchingFactor);
+        levelSizes.push_back(levelSize);
+    }
+    std::reverse(levelSizes.begin(), levelSizes.end());
+    auto maxDepth = uint32_t(levelSizes.size() - 1);
+    if (2 * maxDepth + 1 > uint32_t(HEB_MAX_CONTROL_POINTS)) {
+        throw std::runtime_error("Error in HEBTree::buildRadialHierarchy: The hierarchy is too deep.");
+    }
+
+    std::vector<uint32_t> levelOffsets(levelSizes.size());
+    uint32_t numNodes = 0;
+    for (size_t level = 0; level < levelSizes.size(); level++) {
+        levelOffsets[level] = numNodes;
+        numNodes += levelSizes[level];
+    }
+    nodes.clear();
+    nodes.resize(numNodes);
+    leafIdxOffset = levelOffsets.back();
+
+    // Leaves in angular order.
+    for (uint32_t leafIdx = 0; leafIdx < uint32_t(numLeaves); leafIdx++) {
+        HEBNode& leaf = nodes[leafIdxOffset + leafIdx];
+        leaf.angle = 6.28318530718f * float(leafIdx) / float(numLeaves);
+        leaf.normalizedPosition = glm::vec2(std::cos(leaf.angle), std::sin(leaf.angle));
+        leaf.depth = maxDepth;
+    }
+
+    // Group consecutive nodes of each level; an inner node lies at the mean angle of its first and last leaf.
+    std::vector<uint32_t> firstLeaf(numNodes), lastLeaf(numNodes);
+    for (uint32_t leafIdx = 0; leafIdx < uint32_t(numLeaves); leafIdx++) {
+        firstLeaf[leafIdxOffset + leafIdx] = lastLeaf[leafIdxOffset + leafIdx] = leafIdx;
+    }
+    for (auto level = uint32_t(levelSizes.size() - 1); level > 0; level--) {
+        for (uint32_t i = 0; i < levelSizes[level]; i++) {
+            uint32_t childIdx = levelOffsets[level] + i;
+            uint32_t parentIdx = levelOffsets[level - 1] + i / uint32_t(branchingFactor);
+            nodes[childIdx].parentIdx = parentIdx;
+            if (i % uint32_t(branchingFactor) == 0) {
+                firstLeaf[parentIdx] = firstLeaf[childIdx];
+            }
+            lastLeaf[parentIdx] = lastLeaf[childIdx];
+        }
+        for (uint32_t i = 0; i < levelSizes[level - 1]; i++) {
+            uint32_t nodeIdx = levelOffsets[level - 1] + i;
+            HEBNode& node = nodes[nodeIdx];
+            node.depth = level - 1;
+            node.angle = 0.5f * (nodes[leafIdxOffset + firstLeaf[nodeIdx]].angle
+                    + nodes[leafIdxOffset + lastLeaf[nodeIdx]].angle);
+            float radius = float(node.depth) / float(maxDepth);
+            node.normalizedPosition = radius * glm::vec2(std::cos(node.angle), std::sin(node.angle));
+        }
+    }
+}
+
+void HEBTree::validateHierarchy(const std::vector<HEBNode>& nodes, uint32_t leafIdxOffset) {
+    if (size_t(leafIdxOffset) > nodes.size()) {
+        throw std::runtime_error("Error in HEBTree::validateHierarchy: The leaf offset is out of range.");
+    }
+    if (nodes.empty()) {
+        return;
+    }
+    if (nodes[0].parentIdx != std::numeric_limits<uint32_t>::max() || nodes[0].depth != 0) {
+        throw std::runtime_error("Error in HEBTree::validateHierarchy: Node 0 is not the root.");
+    }
+    // Control points are stored in fixed-size buffers, so the path length between two leaves is bounded.
+    const auto maxDepth = uint32_t(HEB_MAX_CONTROL_POINTS - 1) / 2;
+    for (size_t nodeIdx = 1; nodeIdx < nodes.size(); nodeIdx++) {
+        const HEBNode& node = nodes[nodeIdx];
+        if (size_t(node.parentIdx) >= nodeIdx) {
+            throw std::runtime_error("Error in HEBTree::validateHierarchy: A parent does not precede its child.");
+        }
+        if (node.depth != nodes[node.parentIdx].depth + 1) {
+            throw std::runtime_error("Error in HEBTree::validateHierarchy: Inconsistent node depth.");
+        }
+        if (node.depth > maxDepth) {
+            throw std::runtime_error("Error in HEBTree::validateHierarchy: The hierarchy is too deep.");
+        }
+    }
+}
+
+void HEBTree::build(const std::vector<HEBNode>& nodes, uint32_t _leafIdxOffset) {
+    validateHierarchy(nodes, _leafIdxOffset);
+    leafIdxOffset = _leafIdxOffset;
+    auto numNodes = uint32_t(nodes.size());
+    nodeDepths.resize(numNodes);
+    parentIndices.resize(numNodes);
+    for (uint32_t nodeIdx = 0; nodeIdx < numNodes; nodeIdx++) {
+        nodeDepths[nodeIdx] = nodes[nodeIdx].depth;
+        parentIndices[nodeIdx] = nodes[nodeIdx].parentIdx;
+    }
+    if (numNodes == 0) {
+        eulerTour.clear();
+        return;
+    }
+
+    // Children in compressed sparse row format.
+    std::vector<uint32_t> childOffsets(numNodes + 1, 0);
+    for (uint32_t nodeIdx = 1; nodeIdx < numNodes; nodeIdx++) {
+        childOffsets[parentIndices[nodeIdx] + 1]++;
+    }
+    for (uint32_t nodeIdx = 0; nodeIdx < numNodes; nodeIdx++) {
+        childOffsets[nodeIdx + 1] += childOffsets[nodeIdx];
+    }
+    std::vector<uint32_t> children(numNodes > 0 ? numNodes - 1 : 0);
+    std::vector<uint32_t> childFill(childOffsets.begin(), childOffsets.end() - 1);
+    for (uint32_t nodeIdx = 1; nodeIdx < numNodes; nodeIdx++) {
+        children[childFill[parentIndices[nodeIdx]]++] = nodeIdx;
+    }
+
+    // Iterative DFS for the Euler tour.
+    eulerTour.clear();
+    eulerTour.reserve(2 * numNodes - 1);
+    firstOccurrence.resize(numNodes);
+    std::vector<std::pair<uint32_t, uint32_t>> stack; // (node, next child position)
+    stack.emplace_back(0, childOffsets[0]);
+    firstOccurrence[0] = 0;
+    eulerTour.push_back(0);
+    while (!stack.empty()) {
+        auto& [nodeIdx, childPos] = stack.back();
+        if (childPos < childOffsets[nodeIdx + 1]) {
+            uint32_t childIdx = children[childPos++];
+            firstOccurrence[childIdx] = uint32_t(eulerTour.size());
+            eulerTour.push_back(childIdx);
+            stack.emplace_back(childIdx, childOffsets[childIdx]);
+        } else {
+            stack.pop_back();
+            if (!stack.empty()) {
+                eulerTour.push_back(stack.back().first);
+            }
+        }
+    }
+
+    // Sparse table over the node depths of the Euler tour.
+    auto tourSize = uint32_t(eulerTour.size());
+    log2Table.resize(tourSize + 1);
+    log2Table[1] = 0;
+    for (uint32_t i = 2; i <= tourSize; i++) {
+        log2Table[i] = uint8_t(log2Table[i / 2] + 1);
+    }
+    int numLevels = log2Table[tourSize] + 1;
+    sparseTable.resize(numLevels);
+    sparseTable[0] = eulerTour;
+    for (int j = 1; j < numLevels; j++) {
+        uint32_t width = 1u << j;
+        uint32_t halfWidth = width >> 1;
+        auto& prev = sparseTable[j - 1];
+        auto& curr = sparseTable[j];
+        curr.resize(tourSize - width + 1);
+        for (uint32_t i = 0; i + width <= tourSize; i++) {
+            uint32_t a = prev[i], b = prev[i + halfWidth];
+            curr[i] = nodeDepths[a] <= nodeDepths[b] ? a : b;
+        }
+    }
+}
+
+uint32_t HEBTree::getLowestCommonAncestor(uint32_t nodeIdx0, uint32_t nodeIdx1) const {
+    uint32_t l = firstOccurrence[nodeIdx0];
+    uint32_t r = firstOccurrence[nodeIdx1];
+    if (l > r) {
+        std::swap(l, r);
+    }
+    int j = log2Table[r - l + 1];
+    uint32_t a = sparseTable[j][l];
+    uint32_t b = sparseTable[j][r - (1u << j) + 1];
+    return nodeDepths[a] <= nodeDepths[b] ? a : b;
+}
+
+void HEBTree::updateEdgePaths(std::vector<HEBEdge>& edges) const {
+    updateEdgePaths(edges.data(), edges.size());
+}
+
+void HEBTree::updateEdgePaths(HEBEdge* edges, size_t numEdges) const {
+    for (size_t edgeIdx = 0; edgeIdx < numEdges; edgeIdx++) {
+        HEBEdge& edge = edges[edgeIdx];
+        uint32_t nodeIdx0 = leafIdxOffset + edge.pointIdx0;
+        uint32_t nodeIdx1 = leafIdxOffset + edge.pointIdx1;
+        edge.lcaIdx = getLowestCommonAncestor(nodeIdx0, nodeIdx1);
+        edge.numControlPoints = getPathLength(nodeIdx0, nodeIdx1, edge.lcaIdx);
+    }
+}
+
+void HEBTree::getControlPoints(
+        const std::vector<HEBNode>& nodes, const HEBEdge& edge, float beta, glm::vec2* controlPoints) const {
+    uint32_t nodeIdx0 = leafIdxOffset + edge.pointIdx0;
+    uint32_t nodeIdx1 = leafIdxOffset + edge.pointIdx1;
+    auto n = int(edge.numControlPoints);
+
+    // Walk up from both leaves to the LCA; the second half is written back to front.
+    int idxFront = 0;
+    for (uint32_t nodeIdx = nodeIdx0; nodeIdx != edge.lcaIdx; nodeIdx = parentIndices[nodeIdx]) {
+        controlPoints[idxFront++] = nodes[nodeIdx].normalizedPosition;
+    }
+    controlPoints[idxFront] = nodes[edge.lcaIdx].normalizedPosition;
+    int idxBack = n - 1;
+    for (uint32_t nodeIdx = nodeIdx1; nodeIdx != edge.lcaIdx; nodeIdx = parentIndices[nodeIdx]) {
+        controlPoints[idxBack--] = nodes[nodeIdx].normalizedPosition;
+    }
+
+    if (beta < 1.0f && n > 1) {
+        glm::vec2 p0 = controlPoints[0];
+        glm::vec2 p1 = controlPoints[n - 1];
+        for (int i = 1; i < n - 1; i++) {
+            float t = float(i) / float(n - 1);
+            controlPoints[i] = beta * controlPoints[i] + (1.0f - beta) * (p0 + t * (p1 - p0));
+        }
+    }
+}
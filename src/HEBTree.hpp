@@ -0,0 +1,108 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HEBTREE_HPP
+#define HEBTREE_HPP
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <glm/vec2.hpp>
+
+struct HEBNode {
+    glm::vec2 normalizedPosition;
+    float angle = 0.0f;
+    uint32_t parentIdx = std::numeric_limits<uint32_t>::max();
+    uint32_t depth = 0;
+};
+
+/// An edge between two leaves. The LCA and control point count are cached by @see HEBTree::updateEdgePaths.
+struct HEBEdge {
+    uint32_t pointIdx0 = 0; //< Leaf index relative to the leaf offset.
+    uint32_t pointIdx1 = 0;
+    uint32_t lcaIdx = 0; //< Node index of the lowest common ancestor.
+    uint32_t numControlPoints = 0;
+    float weight = 1.0f; //< Importance in [0, 1]; scales the opacity of the curve.
+};
+
+/// Upper bound for the number of control points of an edge, i.e., 2 * max. tree depth + 1.
+const int HEB_MAX_CONTROL_POINTS = 64;
+
+/**
+ * Hierarchy used for hierarchical edge bundling (D. Holten, "Hierarchical Edge Bundles: Visualization of Adjacency
+ * Relations in Hierarchical Data", IEEE TVCG, 2006). The control polygon of an edge is the tree path from one leaf to
+ * the other via their lowest common ancestor (LCA). LCA queries use an Euler tour with a sparse table for range
+ * minimum queries, i.e., O(n log n) preprocessing and O(1) per query.
+ */
+class HEBTree {
+public:
+    /**
+     * Builds a balanced radial hierarchy over numLeaves leaves on the unit circle. Every inner node has up to
+     * branchingFactor children. The nodes are stored top-down by level, i.e., the root is nodes[0] and the leaves are
+     * stored starting at leafIdxOffset in angular order. Inner nodes lie at radius depth / maxDepth at the mean angle
+     * of their leaves.
+     */
+    static void buildRadialHierarchy(
+            int numLeaves, int branchingFactor, std::vector<HEBNode>& nodes, uint32_t& leafIdxOffset);
+
+    /**
+     * Throws std::runtime_error unless nodes[0] is the root, every other node has a parent with a smaller index and a
+     * depth one higher than its parent, leafIdxOffset <= nodes.size(), and the longest path between two leaves via
+     * the root has at most HEB_MAX_CONTROL_POINTS nodes.
+     */
+    static void validateHierarchy(const std::vector<HEBNode>& nodes, uint32_t leafIdxOffset);
+    /// Builds the LCA data structures for the passed nodes; throws like @see validateHierarchy for invalid nodes.
+    void build(const std::vector<HEBNode>& nodes, uint32_t leafIdxOffset);
+    [[nodiscard]] uint32_t getLowestCommonAncestor(uint32_t nodeIdx0, uint32_t nodeIdx1) const;
+    /// Number of nodes on the tree path between two nodes via their (precomputed) LCA.
+    [[nodiscard]] inline uint32_t getPathLength(uint32_t nodeIdx0, uint32_t nodeIdx1, uint32_t lcaIdx) const {
+        return nodeDepths[nodeIdx0] + nodeDepths[nodeIdx1] - 2 * nodeDepths[lcaIdx] + 1;
+    }
+
+    /// Caches the LCA and the number of control points of all edges.
+    void updateEdgePaths(std::vector<HEBEdge>& edges) const;
+    void updateEdgePaths(HEBEdge* edges, size_t numEdges) const;
+
+    /**
+     * Writes the beta-straightened control points of the edge to controlPoints (of size edge.numControlPoints).
+     * beta = 1 results in the tree path, beta = 0 in the straight line between the two leaves.
+     */
+    void getControlPoints(
+            const std::vector<HEBNode>& nodes, const HEBEdge& edge, float beta, glm::vec2* controlPoints) const;
+
+private:
+    uint32_t leafIdxOffset = 0;
+    std::vector<uint32_t> nodeDepths;
+    std::vector<uint32_t> parentIndices;
+    std::vector<uint32_t> eulerTour; //< Node indices in DFS visiting order (size 2 * numNodes - 1).
+    std::vector<uint32_t> firstOccurrence; //< First index of each node in eulerTour.
+    std::vector<std::vector<uint32_t>> sparseTable; //< sparseTable[j][i]: min. depth node in eulerTour[i, i + 2^j).
+    std::vector<uint8_t> log2Table;
+};
+
+#endif //HEBTREE_HPP
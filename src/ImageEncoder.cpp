@@ -0,0 +1,358 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "ImageEncoder.hpp"
+
+ImageFileFormat getImageFileFormatFromPath(const std::string& filePath) {
+    size_t dotPos = filePath.find_last_of('.');
+    if (dotPos == std::string::npos) {
+        return ImageFileFormat::PNG;
+    }
+    std::string extension = filePath.substr(dotPos);
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {
+        return char(std::tolower(c));
+    });
+    return extension == IMAGE_FILE_FORMAT_EXTENSIONS[int(ImageFileFormat::EXR)]
+            ? ImageFileFormat::EXR : ImageFileFormat::PNG;
+}
+
+// Both formats store multi-byte values with a fixed byte order independent of the host.
+static inline void appendUint32BE(std::vector<uint8_t>& data, uint32_t value) {
+    data.push_back(uint8_t(value >> 24));
+    data.push_back(uint8_t(value >> 16));
+    data.push_back(uint8_t(value >> 8));
+    data.push_back(uint8_t(value));
+}
+
+static inline void appendUint16LE(std::vector<uint8_t>& data, uint16_t value) {
+    data.push_back(uint8_t(value));
+    data.push_back(uint8_t(value >> 8));
+}
+
+static inline void appendUint32LE(std::vector<uint8_t>& data, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        data.push_back(uint8_t(value >> (8 * i)));
+    }
+}
+
+static inline void appendUint64LE(std::vector<uint8_t>& data, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        data.push_back(uint8_t(value >> (8 * i)));
+    }
+}
+
+static inline void appendFloatLE(std::vector<uint8_t>& data, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(float));
+    appendUint32LE(data, bits);
+}
+
+/// Converts a premultiplied 8-bit color value to straight alpha.
+static inline uint8_t unpremultiply(uint32_t value, uint32_t alpha) {
+    return alpha == 0 ? 0 : uint8_t(std::min((value * 255u + alpha / 2u) / alpha, 255u));
+}
+
+static inline void appendString(std::vector<uint8_t>& data, const char* str) {
+    data.insert(data.end(), str, str + std::strlen(str) + 1);
+}
+
+
+// ---------------------------------------------------------------- PNG ------------------------------------------------
+
+static const std::array<uint32_t, 256>& getCrc32Table() {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> values{};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1u) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            values[i] = c;
+        }
+        return values;
+    }();
+    return table;
+}
+
+static uint32_t computeCrc32(const uint8_t* data, size_t size) {
+    const std::array<uint32_t, 256>& table = getCrc32Table();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static void appendPngChunk(std::vector<uint8_t>& png, const char* type, const uint8_t* data, size_t size) {
+    appendUint32BE(png, uint32_t(size));
+    size_t typeOffset = png.size();
+    png.insert(png.end(), type, type + 4);
+    png.insert(png.end(), data, data + size);
+    appendUint32BE(png, computeCrc32(png.data() + typeOffset, size + 4));
+}
+
+#ifndef USE_ZLIB
+/// zlib stream of uncompressed deflate blocks.
+static std::vector<uint8_t> storeZlib(const std::vector<uint8_t>& data) {
+    const size_t maxBlockSize = 65535;
+    std::vector<uint8_t> stream;
+    stream.reserve(data.size() + (data.size() / maxBlockSize + 1) * 5 + 6);
+    stream.push_back(0x78);
+    stream.push_back(0x01);
+    size_t offset = 0;
+    do {
+        auto blockSize = uint16_t(std::min(data.size() - offset, maxBlockSize));
+        bool isFinal = offset + blockSize == data.size();
+        stream.push_back(isFinal ? 1 : 0);
+        appendUint16LE(stream, blockSize);
+        appendUint16LE(stream, uint16_t(~blockSize));
+        stream.insert(stream.end(), data.begin() + ptrdiff_t(offset), data.begin() + ptrdiff_t(offset + blockSize));
+        offset += blockSize;
+    } while (offset < data.size());
+
+    // Adler-32 checksum; the sums are reduced before they can overflow.
+    uint32_t a = 1, b = 0;
+    for (size_t blockStart = 0; blockStart < data.size(); blockStart += 5552) {
+        size_t blockEnd = std::min(blockStart + 5552, data.size());
+        for (size_t i = blockStart; i < blockEnd; i++) {
+            a += data[i];
+            b += a;
+        }
+        a %= 65521u;
+        b %= 65521u;
+    }
+    appendUint32BE(stream, (b << 16) | a);
+    return stream;
+}
+#endif
+
+std::vector<uint8_t> encodeImagePng(int width, int height, const uint8_t* rgbaPremul) {
+    // Filtered scanlines with straight alpha. The "Sub" filter (difference to the pixel on the left) makes the large
+    // uniform areas of diagrams compress well; it is only worth it if the data is compressed at all.
+#ifdef USE_ZLIB
+    const uint8_t filterType = 1;
+#else
+    const uint8_t filterType = 0;
+#endif
+    const size_t rowSize = size_t(width) * 4;
+    std::vector<uint8_t> scanlines((rowSize + 1) * size_t(height));
+    std::vector<uint8_t> straightRow(rowSize);
+    for (int y = 0; y < height; y++) {
+        const uint8_t* inRow = rgbaPremul + size_t(y) * rowSize;
+        for (size_t i = 0; i < rowSize; i += 4) {
+            uint32_t alpha = inRow[i + 3];
+            for (size_t c = 0; c < 3; c++) {
+                straightRow[i + c] = unpremultiply(inRow[i + c], alpha);
+            }
+            straightRow[i + 3] = uint8_t(alpha);
+        }
+        uint8_t* outRow = scanlines.data() + size_t(y) * (rowSize + 1);
+        outRow[0] = filterType;
+        for (size_t i = 0; i < rowSize; i++) {
+            outRow[i + 1] = filterType == 1 && i >= 4 ? uint8_t(straightRow[i] - straightRow[i - 4]) : straightRow[i];
+        }
+    }
+
+#ifdef USE_ZLIB
+    uLongf compressedSize = compressBound(uLong(scanlines.size()));
+    std::vector<uint8_t> idat(compressedSize);
+    if (compress2(idat.data(), &compressedSize, scanlines.data(), uLong(scanlines.size()), 6) != Z_OK) {
+        throw std::runtime_error("Error in encodeImagePng: zlib compression failed.");
+    }
+    idat.resize(compressedSize);
+#else
+    std::vector<uint8_t> idat = storeZlib(scanlines);
+#endif
+
+    std::vector<uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    std::vector<uint8_t> header;
+    appendUint32BE(header, uint32_t(width));
+    appendUint32BE(header, uint32_t(height));
+    header.insert(header.end(), {
+            8, //< Bit depth.
+            6, //< Color type RGBA.
+            0, 0, 0 //< Compression, filter and interlace method.
+    });
+    appendPngChunk(png, "IHDR", header.data(), header.size());
+    appendPngChunk(png, "IDAT", idat.data(), idat.size());
+    appendPngChunk(png, "IEND", nullptr, 0);
+    return png;
+}
+
+
+// ---------------------------------------------------------------- EXR ------------------------------------------------
+
+/// Conversion to IEEE 754 half precision with rounding to the nearest even value.
+static uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(float));
+    const auto sign = uint16_t((bits >> 16) & 0x8000u);
+    const uint32_t exponentBits = (bits >> 23) & 0xFFu;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+    if (exponentBits == 0xFFu) {
+        return uint16_t(sign | 0x7C00u | (mantissa != 0 ? 0x200u : 0u)); // Infinity or NaN.
+    }
+    const int exponent = int(exponentBits) - 127 + 15;
+    if (exponent >= 31) {
+        return uint16_t(sign | 0x7C00u); // Overflow to infinity.
+    }
+    uint32_t half, remainder, halfway;
+    if (exponent <= 0) {
+        // Subnormal half or zero.
+        if (exponent < -10) {
+            return sign;
+        }
+        mantissa |= 0x800000u;
+        const auto shift = uint32_t(14 - exponent);
+        half = mantissa >> shift;
+        remainder = mantissa & ((1u << shift) - 1u);
+        halfway = 1u << (shift - 1u);
+    } else {
+        half = (uint32_t(exponent) << 10) | (mantissa >> 13);
+        remainder = mantissa & 0x1FFFu;
+        halfway = 0x1000u;
+    }
+    // A carry out of the mantissa correctly increments the exponent.
+    if (remainder > halfway || (remainder == halfway && (half & 1u) != 0)) {
+        half++;
+    }
+    return uint16_t(sign | half);
+}
+
+static float srgbToLinear(float value) {
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+static void appendExrAttribute(
+        std::vector<uint8_t>& exr, const char* name, const char* type, const std::vector<uint8_t>& value) {
+    appendString(exr, name);
+    appendString(exr, type);
+    appendUint32LE(exr, uint32_t(value.size()));
+    exr.insert(exr.end(), value.begin(), value.end());
+}
+
+std::vector<uint8_t> encodeImageExr(int width, int height, const uint8_t* rgbaPremul) {
+    // OpenEXR readers expect the channels in alphabetical order.
+    const char* const channelNames[] = { "A", "B", "G", "R" };
+    const int channelOffsets[] = { 3, 2, 1, 0 };
+    const uint32_t pixelTypeHalf = 1;
+
+    std::vector<uint8_t> exr = { 0x76, 0x2F, 0x31, 0x01, 2, 0, 0, 0 }; // Magic number and version 2 (scanlines).
+    std::vector<uint8_t> value;
+    for (const char* channelName : channelNames) {
+        appendString(value, channelName);
+        appendUint32LE(value, pixelTypeHalf);
+        value.insert(value.end(), { 0, 0, 0, 0 }); // pLinear and reserved bytes.
+        appendUint32LE(value, 1); // x sampling.
+        appendUint32LE(value, 1); // y sampling.
+    }
+    value.push_back(0);
+    appendExrAttribute(exr, "channels", "chlist", value);
+    appendExrAttribute(exr, "compression", "compression", { 0 }); // NO_COMPRESSION.
+    value.clear();
+    appendUint32LE(value, 0);
+    appendUint32LE(value, 0);
+    appendUint32LE(value, uint32_t(width - 1));
+    appendUint32LE(value, uint32_t(height - 1));
+    appendExrAttribute(exr, "dataWindow", "box2i", value);
+    appendExrAttribute(exr, "displayWindow", "box2i", value);
+    appendExrAttribute(exr, "lineOrder", "lineOrder", { 0 }); // INCREASING_Y.
+    value.clear();
+    appendFloatLE(value, 1.0f);
+    appendExrAttribute(exr, "pixelAspectRatio", "float", value);
+    appendExrAttribute(exr, "screenWindowWidth", "float", value);
+    value.clear();
+    appendFloatLE(value, 0.0f);
+    appendFloatLE(value, 0.0f);
+    appendExrAttribute(exr, "screenWindowCenter", "v2f", value);
+    exr.push_back(0); // End of the header.
+
+    // Offset table with one chunk per scanline, followed by the chunks: y, data size and the channels one by one.
+    const size_t rowDataSize = size_t(width) * 4 * sizeof(uint16_t);
+    const size_t chunkSize = 8 + rowDataSize;
+    const size_t firstChunkOffset = exr.size() + size_t(height) * sizeof(uint64_t);
+    exr.reserve(firstChunkOffset + size_t(height) * chunkSize);
+    for (int y = 0; y < height; y++) {
+        appendUint64LE(exr, uint64_t(firstChunkOffset + size_t(y) * chunkSize));
+    }
+
+    // Linearized colors of the 256 possible straight alpha values are looked up; alpha itself is linear.
+    std::array<float, 256> linearValues{};
+    for (int i = 0; i < 256; i++) {
+        linearValues[i] = srgbToLinear(float(i) / 255.0f);
+    }
+    std::vector<float> linearRow(size_t(width) * 4);
+    for (int y = 0; y < height; y++) {
+        const uint8_t* inRow = rgbaPremul + size_t(y) * size_t(width) * 4;
+        for (size_t i = 0; i < size_t(width) * 4; i += 4) {
+            uint32_t alpha = inRow[i + 3];
+            for (size_t c = 0; c < 3; c++) {
+                linearRow[i + c] = linearValues[unpremultiply(inRow[i + c], alpha)] * float(alpha) / 255.0f;
+            }
+            linearRow[i + 3] = float(alpha) / 255.0f;
+        }
+        appendUint32LE(exr, uint32_t(y));
+        appendUint32LE(exr, uint32_t(rowDataSize));
+        for (int channelOffset : channelOffsets) {
+            for (int x = 0; x < width; x++) {
+                appendUint16LE(exr, floatToHalf(linearRow[size_t(x) * 4 + size_t(channelOffset)]));
+            }
+        }
+    }
+    return exr;
+}
+
+
+void writeImageFile(
+        const std::string& filePath, ImageFileFormat format, int width, int height, const uint8_t* rgbaPremul) {
+    if (width <= 0 || height <= 0) {
+        throw std::runtime_error("Error in writeImageFile: Invalid image size for \"" + filePath + "\".");
+    }
+    std::vector<uint8_t> data = format == ImageFileFormat::EXR
+            ? encodeImageExr(width, height, rgbaPremul) : encodeImagePng(width, height, rgbaPremul);
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Error in writeImageFile: Could not open \"" + filePath + "\" for writing.");
+    }
+    file.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+    if (!file) {
+        throw std::runtime_error("Error in writeImageFile: Could not write \"" + filePath + "\".");
+    }
+}
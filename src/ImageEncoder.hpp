@@ -0,0 +1,60 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef IMAGEENCODER_HPP
+#define IMAGEENCODER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class ImageFileFormat {
+    PNG, EXR
+};
+const char* const IMAGE_FILE_FORMAT_EXTENSIONS[] = {
+        ".png", ".exr"
+};
+
+/// Returns the format matching the file extension of the path (case-insensitive); unknown extensions use PNG.
+ImageFileFormat getImageFileFormatFromPath(const std::string& filePath);
+
+/*
+ * Encoders for premultiplied RGBA8 images with the top row first, i.e., the output of @see RasterizerCpu. They only
+ * depend on the standard library (and optionally zlib), so they can be used without a window or GPU.
+ * - PNG: 8-bit straight alpha, as required by PNG. The image data is compressed with zlib if it was found at build
+ *   time (USE_ZLIB); otherwise, it is stored in uncompressed deflate blocks, which any PNG decoder can read.
+ * - EXR: Uncompressed scanlines with half float RGBA channels. As is conventional for OpenEXR, the colors are linear
+ *   and premultiplied, so the sRGB values are linearized before premultiplication.
+ */
+std::vector<uint8_t> encodeImagePng(int width, int height, const uint8_t* rgbaPremul);
+std::vector<uint8_t> encodeImageExr(int width, int height, const uint8_t* rgbaPremul);
+/// Encodes the image in the passed format and writes it to the file; throws std::runtime_error on failure.
+void writeImageFile(
+        const std::string& filePath, ImageFileFormat format, int width, int height, const uint8_t* rgbaPremul);
+
+#endif //IMAGEENCODER_HPP
@@ -0,0 +1,220 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+
+#include <Graphics/Vulkan/Buffers/Buffer.hpp>
+#include <Graphics/Vulkan/Render/Data.hpp>
+#include <Graphics/Vulkan/Render/Renderer.hpp>
+#include <Graphics/Vulkan/Shader/ShaderManager.hpp>
+
+#include "ChordDiagramModel.hpp"
+#include "InstancedCurvePass.hpp"
+
+void getModelControlPolygons(
+        const ChordDiagramModel& model, std::vector<glm::vec2>& controlPoints, std::vector<glm::uvec2>& curves) {
+    const std::vector<HEBEdge>& edges = model.getEdges();
+    curves.resize(edges.size());
+    size_t numControlPointsTotal = 0;
+    for (size_t lineIdx = 0; lineIdx < edges.size(); lineIdx++) {
+        curves[lineIdx] = glm::uvec2(uint32_t(numControlPointsTotal), edges[lineIdx].numControlPoints);
+        numControlPointsTotal += edges[lineIdx].numControlPoints;
+    }
+    controlPoints.resize(numControlPointsTotal);
+    for (size_t lineIdx = 0; lineIdx < edges.size(); lineIdx++) {
+        model.getHEBTree().getControlPoints(
+                model.getNodes(), edges[lineIdx], 1.0f, controlPoints.data() + curves[lineIdx].x);
+    }
+}
+
+/// Storage buffers must not be empty, so at least one element is allocated.
+template<class T>
+static sgl::vk::BufferPtr createStorageBuffer(sgl::vk::Device* device, const std::vector<T>& data) {
+    T dummyElement{};
+    return std::make_shared<sgl::vk::Buffer>(
+            device, sizeof(T) * std::max(data.size(), size_t(1)), data.empty() ? &dummyElement : data.data(),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+}
+
+InstancedCurvePass::InstancedCurvePass(sgl::vk::Renderer* renderer) : RasterPass(renderer) {
+}
+
+void InstancedCurvePass::setOutputImage(const sgl::vk::ImageViewPtr& _outputImageView) {
+    outputImageView = _outputImageView;
+}
+
+void InstancedCurvePass::setClearColor(const glm::vec4& _clearColor) {
+    if (clearColor != _clearColor) {
+        clearColor = _clearColor;
+        if (outputImageView) {
+            recreateSwapchain(framebuffer ? framebuffer->getWidth() : 1, framebuffer ? framebuffer->getHeight() : 1);
+        }
+    }
+}
+
+void InstancedCurvePass::recreateSwapchain(uint32_t width, uint32_t height) {
+    framebuffer = std::make_shared<sgl::vk::Framebuffer>(device, width, height);
+    sgl::vk::AttachmentState attachmentState;
+    attachmentState.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachmentState.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachmentState.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    framebuffer->setColorAttachment(outputImageView, 0, attachmentState, clearColor);
+    framebufferDirty = true;
+    dataDirty = true;
+}
+
+void InstancedCurvePass::updateModel(const ChordDiagramModel* model) {
+    if (model && model->getModelId() == uploadedModelId
+            && model->getControlPolygonsVersion() == uploadedControlPolygonsVersion) {
+        return;
+    }
+    std::vector<glm::vec2> controlPoints;
+    std::vector<glm::uvec2> curves;
+    if (model) {
+        getModelControlPolygons(*model, controlPoints, curves);
+        uploadedControlPolygonsVersion = model->getControlPolygonsVersion();
+    }
+    uploadedModelId = model ? model->getModelId() : 0;
+    controlPointBuffer = createStorageBuffer(device, controlPoints);
+    curveBuffer = createStorageBuffer(device, curves);
+    dataDirty = true;
+}
+
+void InstancedCurvePass::updateDrawList(
+        const std::vector<InstancedCurveDraw>& curveDraws, uint64_t drawListVersion) {
+    if (curveDrawBuffer && drawListVersion == uploadedDrawListVersion) {
+        return;
+    }
+    uploadedDrawListVersion = drawListVersion;
+    numCurveDraws = uint32_t(curveDraws.size());
+    curveDrawBuffer = createStorageBuffer(device, curveDraws);
+    dataDirty = true;
+}
+
+void InstancedCurvePass::setPushConstants(const InstancedCurvePushConstants& _pushConstants) {
+    if (pushConstants.numSamples != _pushConstants.numSamples) {
+        // The number of vertices per instance depends on the number of samples.
+        dataDirty = true;
+    }
+    pushConstants = _pushConstants;
+}
+
+void InstancedCurvePass::loadShader() {
+    shaderStages = sgl::vk::ShaderManager->getShaderStages({
+            "InstancedCurves.Vertex.Curve", "InstancedCurves.Fragment.Curve" });
+}
+
+void InstancedCurvePass::setGraphicsPipelineInfo(sgl::vk::GraphicsPipelineInfo& pipelineInfo) {
+    pipelineInfo.setInputAssemblyTopology(sgl::vk::PrimitiveTopology::TRIANGLE_STRIP);
+    pipelineInfo.setCullMode(sgl::vk::CullMode::CULL_NONE);
+    pipelineInfo.setDepthTestEnabled(false);
+    pipelineInfo.setDepthWriteEnabled(false);
+    pipelineInfo.setBlendMode(sgl::vk::BlendMode::BACK_TO_FRONT_STRAIGHT_ALPHA);
+}
+
+void InstancedCurvePass::createRasterData(sgl::vk::Renderer* renderer, sgl::vk::GraphicsPipelinePtr& graphicsPipeline) {
+    rasterData = std::make_shared<sgl::vk::RasterData>(renderer, graphicsPipeline);
+    rasterData->setStaticBuffer(controlPointBuffer, "ControlPointBuffer");
+    rasterData->setStaticBuffer(curveBuffer, "CurveBuffer");
+    rasterData->setStaticBuffer(curveDrawBuffer, "CurveDrawBuffer");
+    rasterData->setNumVertices(2 * size_t(std::max(pushConstants.numSamples, 2)));
+    rasterData->setNumInstances(numCurveDraws);
+}
+
+void InstancedCurvePass::_render() {
+    renderer->pushConstants(
+            rasterData->getGraphicsPipeline(), VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+            0, pushConstants);
+    RasterPass::_render();
+}
+
+
+InstancedNodePass::InstancedNodePass(sgl::vk::Renderer* renderer) : RasterPass(renderer) {
+}
+
+void InstancedNodePass::setOutputImage(const sgl::vk::ImageViewPtr& _outputImageView) {
+    outputImageView = _outputImageView;
+}
+
+void InstancedNodePass::recreateSwapchain(uint32_t width, uint32_t height) {
+    // Draws on top of the curves.
+    framebuffer = std::make_shared<sgl::vk::Framebuffer>(device, width, height);
+    sgl::vk::AttachmentState attachmentState;
+    attachmentState.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    attachmentState.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    attachmentState.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    framebuffer->setColorAttachment(outputImageView, 0, attachmentState);
+    framebufferDirty = true;
+    dataDirty = true;
+}
+
+void InstancedNodePass::updateModel(const ChordDiagramModel* model) {
+    if (model && model->getModelId() == uploadedModelId
+            && model->getControlPolygonsVersion() == uploadedControlPolygonsVersion) {
+        return;
+    }
+    std::vector<glm::vec2> nodePositions;
+    if (model) {
+        const std::vector<HEBNode>& nodes = model->getNodes();
+        for (size_t nodeIdx = model->getLeafIdxOffset(); nodeIdx < nodes.size(); nodeIdx++) {
+            nodePositions.push_back(nodes[nodeIdx].normalizedPosition);
+        }
+        uploadedControlPolygonsVersion = model->getControlPolygonsVersion();
+    }
+    uploadedModelId = model ? model->getModelId() : 0;
+    numNodes = uint32_t(nodePositions.size());
+    nodePositionBuffer = createStorageBuffer(device, nodePositions);
+    dataDirty = true;
+}
+
+void InstancedNodePass::loadShader() {
+    shaderStages = sgl::vk::ShaderManager->getShaderStages({
+            "InstancedCurves.Vertex.Node", "InstancedCurves.Fragment.Node" });
+}
+
+void InstancedNodePass::setGraphicsPipelineInfo(sgl::vk::GraphicsPipelineInfo& pipelineInfo) {
+    pipelineInfo.setInputAssemblyTopology(sgl::vk::PrimitiveTopology::TRIANGLE_STRIP);
+    pipelineInfo.setCullMode(sgl::vk::CullMode::CULL_NONE);
+    pipelineInfo.setDepthTestEnabled(false);
+    pipelineInfo.setDepthWriteEnabled(false);
+    pipelineInfo.setBlendMode(sgl::vk::BlendMode::BACK_TO_FRONT_STRAIGHT_ALPHA);
+}
+
+void InstancedNodePass::createRasterData(sgl::vk::Renderer* renderer, sgl::vk::GraphicsPipelinePtr& graphicsPipeline) {
+    rasterData = std::make_shared<sgl::vk::RasterData>(renderer, graphicsPipeline);
+    rasterData->setStaticBuffer(nodePositionBuffer, "NodePositionBuffer");
+    rasterData->setNumVertices(4);
+    rasterData->setNumInstances(numNodes);
+}
+
+void InstancedNodePass::_render() {
+    renderer->pushConstants(
+            rasterData->getGraphicsPipeline(), VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+            0, pushConstants);
+    RasterPass::_render();
+}
@@ -0,0 +1,133 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef INSTANCEDCURVEPASS_HPP
+#define INSTANCEDCURVEPASS_HPP
+
+#include <cstdint>
+#include <vector>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include <Graphics/Vulkan/Render/Passes/Pass.hpp>
+
+class ChordDiagramModel;
+
+/// Packs the bundled control polygons of all lines of the model for @see InstancedCurvePass.
+void getModelControlPolygons(
+        const ChordDiagramModel& model, std::vector<glm::vec2>& controlPoints, std::vector<glm::uvec2>& curves);
+
+/// Entry of the draw list of @see InstancedCurvePass; matches CurveDraw in InstancedCurves.glsl.
+struct InstancedCurveDraw {
+    uint32_t curveIdx;
+    float alpha;
+};
+
+struct InstancedCurvePushConstants {
+    glm::vec4 color;
+    glm::vec4 selectedColor;
+    glm::vec2 center; //< In pixels.
+    glm::vec2 viewportSize;
+    float radius; //< Chart radius in pixels.
+    float halfWidth;
+    float beta;
+    int32_t numSamples;
+    int32_t maxOrder;
+    int32_t selectedCurveIdx;
+};
+
+/**
+ * Renders the curves of a chord diagram with one instanced draw call. The control polygons are only uploaded when they
+ * change; the curves are evaluated and extruded in the vertex shader (see Data/Shaders/InstancedCurves.glsl), so
+ * beta, thickness and radius changes do not require any CPU-side tessellation. One instance is drawn per entry of the
+ * draw list, which holds the curves that were not culled and their alpha values.
+ */
+class InstancedCurvePass : public sgl::vk::RasterPass {
+public:
+    explicit InstancedCurvePass(sgl::vk::Renderer* renderer);
+    void setOutputImage(const sgl::vk::ImageViewPtr& _outputImageView);
+    void setClearColor(const glm::vec4& _clearColor);
+    void recreateSwapchain(uint32_t width, uint32_t height) override;
+    /// Uploads the control polygons if the model or its control polygons changed since the last upload.
+    void updateModel(const ChordDiagramModel* model);
+    /// Uploads the draw list if drawListVersion differs from the version of the last upload.
+    void updateDrawList(const std::vector<InstancedCurveDraw>& curveDraws, uint64_t drawListVersion);
+    void setPushConstants(const InstancedCurvePushConstants& _pushConstants);
+
+protected:
+    void loadShader() override;
+    void setGraphicsPipelineInfo(sgl::vk::GraphicsPipelineInfo& pipelineInfo) override;
+    void createRasterData(sgl::vk::Renderer* renderer, sgl::vk::GraphicsPipelinePtr& graphicsPipeline) override;
+    void _render() override;
+
+private:
+    sgl::vk::ImageViewPtr outputImageView;
+    glm::vec4 clearColor{};
+    uint64_t uploadedModelId = 0;
+    uint64_t uploadedControlPolygonsVersion = 0;
+    uint64_t uploadedDrawListVersion = 0;
+    uint32_t numCurveDraws = 0;
+    sgl::vk::BufferPtr controlPointBuffer;
+    sgl::vk::BufferPtr curveBuffer;
+    sgl::vk::BufferPtr curveDrawBuffer;
+    InstancedCurvePushConstants pushConstants{};
+};
+
+struct InstancedNodePushConstants {
+    glm::vec4 color;
+    glm::vec2 center;
+    glm::vec2 viewportSize;
+    float radius;
+    float pointRadius;
+};
+
+/// Renders the leaves of a chord diagram as anti-aliased circles with one instanced draw call.
+class InstancedNodePass : public sgl::vk::RasterPass {
+public:
+    explicit InstancedNodePass(sgl::vk::Renderer* renderer);
+    void setOutputImage(const sgl::vk::ImageViewPtr& _outputImageView);
+    void recreateSwapchain(uint32_t width, uint32_t height) override;
+    void updateModel(const ChordDiagramModel* model);
+    inline void setPushConstants(const InstancedNodePushConstants& _pushConstants) { pushConstants = _pushConstants; }
+
+protected:
+    void loadShader() override;
+    void setGraphicsPipelineInfo(sgl::vk::GraphicsPipelineInfo& pipelineInfo) override;
+    void createRasterData(sgl::vk::Renderer* renderer, sgl::vk::GraphicsPipelinePtr& graphicsPipeline) override;
+    void _render() override;
+
+private:
+    sgl::vk::ImageViewPtr outputImageView;
+    uint64_t uploadedModelId = 0;
+    uint64_t uploadedControlPolygonsVersion = 0;
+    uint32_t numNodes = 0;
+    sgl::vk::BufferPtr nodePositionBuffer;
+    InstancedNodePushConstants pushConstants{};
+};
+
+#endif //INSTANCEDCURVEPASS_HPP
@@ -26,7 +26,13 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <Utils/AppSettings.hpp>
 #include <Utils/File/FileUtils.hpp>
 #include <Utils/File/Logfile.hpp>
@@ -39,10 +45,58 @@
 #include <Graphics/OpenGL/Context/DeviceSelectionWGLGlobals.hpp>
 #endif
 
+#include "GraphFile.hpp"
 #include "MainApp.hpp"
 
 int main(int argc, char *argv[]) {
     sgl::FileUtils::get()->initialize("TestInteropVKGL", argc, argv);
+
+    // Offline playback mode for benchmarks; the script format is described in PlaybackScript.hpp.
+    PlaybackSettings playbackSettings;
+    std::string graphFilePath;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--playback") == 0 && hasValue) {
+            playbackSettings.scriptPath = argv[++i];
+        } else if (strcmp(argv[i], "--frames") == 0 && hasValue) {
+            playbackSettings.numFrames = std::max(std::atoi(argv[++i]), 1);
+        } else if (strcmp(argv[i], "--output") == 0 && hasValue) {
+            playbackSettings.outputPath = argv[++i];
+        } else if (strcmp(argv[i], "--renderer") == 0 && hasValue) {
+            i++;
+            playbackSettings.useGpuCurveRenderer = strcmp(argv[i], "curves") == 0;
+            playbackSettings.useCpuRasterizer = strcmp(argv[i], "cpu") == 0;
+        } else if (strcmp(argv[i], "--interop-depth") == 0 && hasValue) {
+            playbackSettings.interopRingDepth = std::max(std::atoi(argv[++i]), 0);
+        } else if (strcmp(argv[i], "--interop-sharing") == 0 && hasValue) {
+            playbackSettings.useInteropPboCopy = strcmp(argv[++i], "copy") == 0;
+        } else if (strcmp(argv[i], "--graph") == 0 && hasValue) {
+            graphFilePath = argv[++i];
+        } else {
+            std::cerr << "Unknown or incomplete argument: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    std::unique_ptr<PlaybackScript> playbackScript;
+    bool usePlayback = !playbackSettings.scriptPath.empty();
+    if (usePlayback) {
+        playbackScript = std::make_unique<PlaybackScript>();
+        try {
+            playbackScript->loadFromFile(playbackSettings.scriptPath);
+        } catch (const std::runtime_error& exception) {
+            std::cerr << exception.what() << std::endl;
+            return 1;
+        }
+    }
+    if (!graphFilePath.empty()) {
+        // Only the header is validated here; the edges are loaded asynchronously by the diagram.
+        try {
+            GraphFile graphFile(graphFilePath);
+        } catch (const std::runtime_error& exception) {
+            std::cerr << exception.what() << std::endl;
+            return 1;
+        }
+    }
 #ifdef DATA_PATH
     if (!sgl::FileUtils::get()->directoryExists("Data") && !sgl::FileUtils::get()->directoryExists("../Data")) {
         sgl::AppSettings::get()->setDataDirectory(DATA_PATH);
@@ -54,7 +108,8 @@ int main(int argc, char *argv[]) {
     sgl::AppSettings::get()->loadSettings(settingsFile.c_str());
     sgl::AppSettings::get()->getSettings().addKeyValue("window-multisamples", 0);
     sgl::AppSettings::get()->getSettings().addKeyValue("window-debugContext", true);
-    sgl::AppSettings::get()->getSettings().addKeyValue("window-vSync", true);
+    // Frame timings of the playback mode would be capped by the display refresh rate otherwise.
+    sgl::AppSettings::get()->getSettings().addKeyValue("window-vSync", !usePlayback);
     sgl::AppSettings::get()->getSettings().addKeyValue("window-resizable", true);
     sgl::AppSettings::get()->getSettings().addKeyValue("window-savePosition", true);
     sgl::AppSettings::get()->setLoadGUI(nullptr, true, false);
@@ -109,11 +164,15 @@ int main(int argc, char *argv[]) {
     sgl::AppSettings::get()->setPrimaryDevice(device);
     sgl::AppSettings::get()->initializeSubsystems();
 
-    auto app = new MainApp();
+    auto app = new MainApp(graphFilePath);
+    if (usePlayback) {
+        app->setPlayback(std::move(playbackScript), playbackSettings);
+    }
     app->run();
+    bool playbackFailed = app->getPlaybackFailed();
     delete app;
 
     sgl::AppSettings::get()->release();
 
-    return 0;
+    return playbackFailed ? 1 : 0;
 }
@@ -26,19 +26,28 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <cstdio>
+#include <iostream>
+
+#include <Utils/AppSettings.hpp>
+#include <Utils/File/FileUtils.hpp>
 #include <Graphics/Vulkan/Utils/Device.hpp>
 #include <Graphics/Vulkan/Utils/DeviceSelectionVulkan.hpp>
 #include <Graphics/Vulkan/Image/Image.hpp>
+#include <Graphics/Vulkan/Render/Renderer.hpp>
 
 #include "DiagramBase.hpp"
 #include "MainApp.hpp"
 
-MainApp::MainApp() {
+MainApp::MainApp(const std::string& graphFilePath) {
     useDockSpaceMode = false;
     useLinearRGB = false;
     deviceSelector = device->getDeviceSelector();
     diagram = new DiagramBase;
+    frameProfiler.initializeVk(device);
     diagram->setRendererVk(rendererVk);
+    diagram->setFrameProfiler(&frameProfiler);
+    diagram->setGraphFilePath(graphFilePath);
     diagram->initialize();
     diagram->onWindowSizeChanged();
     resolutionChanged(sgl::EventPtr());
@@ -47,20 +56,137 @@ MainApp::MainApp() {
 MainApp::~MainApp() {
     device->waitIdle();
     delete diagram;
+    frameProfiler.destroyVk();
 }
 
 void MainApp::render() {
     SciVisApp::preRender();
-    SciVisApp::prepareReRender();
-    diagram->render();
-    diagram->setBlitTargetSupersamplingFactor(1);
-    diagram->blitToTargetVk();
+    // getNeedsReRender resets the flag, so it is queried in every frame.
+    bool diagramNeedsReRender = diagram->getNeedsReRender();
+    bool isDiagramRendered = !useRenderOnDemand || diagramNeedsReRender || forceDiagramReRender;
+    // The pipelined backend composites frames later with PBO copies; the newest ones are shown once the diagram idles.
+    bool hasPendingDiagramFrames = !isDiagramRendered && diagram->getHasPendingFrames();
+    if (isDiagramRendered || hasPendingDiagramFrames) {
+        SciVisApp::prepareReRender();
+        if (isDiagramRendered) {
+            FrameProfilerScope profilerScope(&frameProfiler, FrameStage::WIDGET_RENDER);
+            diagram->render();
+        } else {
+            diagram->compositePendingFrames();
+        }
+        diagram->setBlitTargetSupersamplingFactor(1);
+        {
+            FrameProfilerScope profilerScope(&frameProfiler, FrameStage::BLIT_TO_TARGET_VK);
+            frameProfiler.beginGpuStageVk(FrameStage::GPU_BLIT_VK, rendererVk->getVkCommandBuffer());
+            diagram->blitToTargetVk();
+            frameProfiler.endGpuStageVk(FrameStage::GPU_BLIT_VK, rendererVk->getVkCommandBuffer());
+        }
+        forceDiagramReRender = false;
+        if (isDiagramRendered) {
+            numDiagramFramesRendered++;
+        }
+    } else {
+        numDiagramFramesSkipped++;
+    }
     SciVisApp::postRender();
+    frameProfiler.endFrame();
+    if (!diagram->getUseGpuCurveRenderer() && !diagram->getUseCpuRasterizer()) {
+        int depth = diagram->getInteropRingDepth();
+        size_t modeIdx = depth > 0 ? size_t(diagram->getInteropSharingMode()) : 0;
+        InteropDepthStats& stats = interopDepthStats.at(modeIdx).at(size_t(depth));
+        stats.frameTimeMs = frameProfiler.getFrameTimeAverageMs();
+        stats.beginStallMs = frameProfiler.getStageAverageMs(FrameStage::NANOVG_BEGIN_INTEROP);
+        stats.latencyMs = frameProfiler.getStageAverageMs(FrameStage::INTEROP_LATENCY);
+        stats.copyMs = frameProfiler.getStageAverageMs(FrameStage::INTEROP_COPY);
+    }
+    if (isPlaybackRunning) {
+        finishPlaybackFrame();
+    }
 }
 
 void MainApp::renderGui() {
     if (ImGui::Begin("Info")) {
         renderGuiFpsCounter();
+        if (diagram->getIsBuildingAsync()) {
+            ImGui::TextUnformatted("Building diagram...");
+        } else if (!diagram->getAsyncBuildErrorMessage().empty()) {
+            ImGui::TextWrapped("Building the diagram failed: %s", diagram->getAsyncBuildErrorMessage().c_str());
+        }
+        float beta = diagram->getBeta();
+        if (ImGui::SliderFloat("Bundling Strength", &beta, 0.0f, 1.0f)) {
+            diagram->setBeta(beta);
+        }
+        float curveOpacity = diagram->getCurveOpacity();
+        if (ImGui::SliderFloat("Curve Opacity", &curveOpacity, 0.0f, 1.0f)) {
+            diagram->setCurveOpacity(curveOpacity);
+        }
+        float curveThickness = diagram->getCurveThickness();
+        if (ImGui::SliderFloat("Curve Thickness", &curveThickness, 0.1f, 4.0f)) {
+            diagram->setCurveThickness(curveThickness);
+        }
+        float curveTimeBudgetMs = diagram->getCurveTimeBudgetMs();
+        if (ImGui::SliderFloat("Curve Time Budget (ms)", &curveTimeBudgetMs, 0.0f, 50.0f)) {
+            diagram->setCurveTimeBudgetMs(curveTimeBudgetMs);
+        }
+        bool useGpuCurveRenderer = diagram->getUseGpuCurveRenderer();
+        if (ImGui::Checkbox("GPU Curve Renderer", &useGpuCurveRenderer)) {
+            diagram->setUseGpuCurveRenderer(useGpuCurveRenderer);
+        }
+        bool useCpuRasterizer = diagram->getUseCpuRasterizer();
+        if (ImGui::Checkbox("CPU Rasterizer", &useCpuRasterizer)) {
+            diagram->setUseCpuRasterizer(useCpuRasterizer);
+        }
+        int interopRingDepth = diagram->getInteropRingDepth();
+        if (ImGui::SliderInt(
+                "Interop Ring Depth", &interopRingDepth, 0, VectorBackendNanoVGPipelined::MAX_RING_DEPTH)) {
+            diagram->setInteropRingDepth(interopRingDepth);
+            frameProfiler.resetHistories();
+            forceDiagramReRender = true;
+        }
+        if (interopRingDepth > 0) {
+            int sharingModeIdx = int(diagram->getInteropSharingMode());
+            if (ImGui::Combo(
+                    "Interop Sharing", &sharingModeIdx, INTEROP_SHARING_MODE_NAMES,
+                    IM_ARRAYSIZE(INTEROP_SHARING_MODE_NAMES))) {
+                diagram->setInteropSharingMode(InteropSharingMode(sharingModeIdx));
+                frameProfiler.resetHistories();
+                forceDiagramReRender = true;
+            }
+        }
+        bool useBatchedCurveStrokes = diagram->getUseBatchedCurveStrokes();
+        if (ImGui::Checkbox("Batched Curve Strokes", &useBatchedCurveStrokes)) {
+            diagram->setUseBatchedCurveStrokes(useBatchedCurveStrokes);
+        }
+        ImGui::Text(
+                "Curve paths: %d, stroke calls: %d",
+                diagram->getNumCurvePathsSubmitted(), diagram->getNumCurveStrokeCalls());
+        if (!diagram->getIsLodActive()) {
+            ImGui::Text(
+                    "Curves culled: %d (opacity), %d (time budget)",
+                    diagram->getNumCulledCurves(), diagram->getNumBudgetCulledCurves());
+        }
+        bool useLod = diagram->getUseLod();
+        if (ImGui::Checkbox("Level of Detail", &useLod)) {
+            diagram->setUseLod(useLod);
+        }
+        if (diagram->getIsLodActive()) {
+            ImGui::Text(
+                    "LOD: %d sectors, %d super-edges",
+                    diagram->getNumLodSectors(), diagram->getNumLodSuperEdges());
+        }
+        bool useHoverPicking = diagram->getUseHoverPicking();
+        if (ImGui::Checkbox("Hover Picking", &useHoverPicking)) {
+            diagram->setUseHoverPicking(useHoverPicking);
+        }
+        ImGui::Text("Last pick: %.3f ms", diagram->getLastPickTimeMs());
+        if (ImGui::Checkbox("Render on Demand", &useRenderOnDemand)) {
+            forceDiagramReRender = true;
+        }
+        ImGui::Text(
+                "Diagram frames rendered: %llu, skipped: %llu",
+                static_cast<unsigned long long>(numDiagramFramesRendered),
+                static_cast<unsigned long long>(numDiagramFramesSkipped));
+        renderGuiFrameProfiler();
         deviceSelector->renderGui();
         ImGui::End();
     }
@@ -70,17 +196,142 @@ void MainApp::renderGui() {
     }
 }
 
+void MainApp::renderGuiFrameProfiler() {
+    if (!ImGui::CollapsingHeader("Frame Timings")) {
+        return;
+    }
+    bool isProfilerEnabled = frameProfiler.getIsEnabled();
+    if (ImGui::Checkbox("Enable Profiling", &isProfilerEnabled)) {
+        frameProfiler.setEnabled(isProfilerEnabled);
+    }
+    char overlayText[64];
+    for (size_t stageIdx = 0; stageIdx < NUM_FRAME_STAGES; stageIdx++) {
+        auto stage = FrameStage(stageIdx);
+        float maxMs = frameProfiler.getStageMaxMs(stage);
+        if (maxMs <= 0.0f) {
+            // Not used by the selected backend.
+            continue;
+        }
+        snprintf(
+                overlayText, sizeof(overlayText), "avg %.3f ms, max %.3f ms",
+                frameProfiler.getStageAverageMs(stage), maxMs);
+        ImGui::PlotHistogram(
+                FRAME_STAGE_NAMES[stageIdx], frameProfiler.getStageHistory(stage), FrameProfiler::HISTORY_SIZE,
+                frameProfiler.getHistoryOffset(), overlayText, 0.0f, maxMs, ImVec2(0.0f, 40.0f));
+    }
+    // Depth zero is sgl's NanoVG backend without pipelining.
+    for (size_t modeIdx = 0; modeIdx < interopDepthStats.size(); modeIdx++) {
+        for (size_t depth = 0; depth < interopDepthStats.at(modeIdx).size(); depth++) {
+            const InteropDepthStats& stats = interopDepthStats.at(modeIdx).at(depth);
+            if (stats.frameTimeMs <= 0.0f) {
+                continue;
+            }
+            ImGui::Text(
+                    "Interop depth %d (%s): %.3f ms/frame (%.1f FPS), begin stall %.3f ms, latency %.3f ms, "
+                    "copy %.3f ms", int(depth), depth > 0 ? INTEROP_SHARING_MODE_NAMES[modeIdx] : "sgl",
+                    stats.frameTimeMs, 1000.0f / stats.frameTimeMs, stats.beginStallMs, stats.latencyMs,
+                    stats.copyMs);
+        }
+    }
+    if (ImGui::Button("Export Chrome Trace")) {
+        std::string filePath = sgl::FileUtils::get()->getConfigDirectory() + "frame_trace.json";
+        if (frameProfiler.exportChromeTrace(filePath)) {
+            traceExportStatus = "Saved trace to " + filePath;
+        } else {
+            traceExportStatus = "Could not write " + filePath;
+        }
+    }
+    if (!traceExportStatus.empty()) {
+        ImGui::TextUnformatted(traceExportStatus.c_str());
+    }
+}
+
 void MainApp::update(float dt) {
     sgl::SciVisApp::update(dt);
     int mouseHoverWindowIndex = -1;
     ImGuiIO &io = ImGui::GetIO();
     bool hasGrabbedMouse = io.WantCaptureMouse && mouseHoverWindowIndex < 0;
     diagram->setIsMouseGrabbedByParent(hasGrabbedMouse);
+    if (playbackScript) {
+        updatePlayback();
+    }
     diagram->update(dt);
 }
 
+void MainApp::setPlayback(std::unique_ptr<PlaybackScript> script, const PlaybackSettings& settings) {
+    playbackScript = std::move(script);
+    playbackSettings = settings;
+    if (settings.interopRingDepth >= 0) {
+        diagram->setInteropRingDepth(settings.interopRingDepth);
+    }
+    if (settings.useInteropPboCopy) {
+        diagram->setInteropSharingMode(InteropSharingMode::PBO_COPY);
+    }
+    diagram->setUseGpuCurveRenderer(settings.useGpuCurveRenderer);
+    if (settings.useCpuRasterizer) {
+        diagram->setUseCpuRasterizer(true);
+    }
+    // Every frame is rendered, so the timings do not depend on the input changes.
+    useRenderOnDemand = false;
+}
+
+void MainApp::updatePlayback() {
+    if (!isPlaybackRunning) {
+        if (!diagram->getAsyncBuildErrorMessage().empty()) {
+            // The diagram would never become ready.
+            playbackFailed = true;
+            playbackScript = {};
+            quit();
+            return;
+        }
+        if (!diagram->getModel() || diagram->getIsBuildingAsync()) {
+            return;
+        }
+        isPlaybackRunning = true;
+        frameProfiler.setEnabled(true);
+        frameProfiler.startRecording();
+    }
+
+    const PlaybackFrame& frame = playbackScript->getFrame(playbackFrameIdx);
+    sgl::Window* window = sgl::AppSettings::get()->getMainWindow();
+    if (frame.windowSize.x > 0 && (frame.windowSize.x != window->getWidth()
+            || frame.windowSize.y != window->getHeight())) {
+        window->setWindowSize(frame.windowSize.x, frame.windowSize.y);
+    }
+    DiagramMouseState mouseState;
+    mouseState.positionPx = frame.mousePositionPx;
+    mouseState.isButtonDown = frame.isButtonDown;
+    mouseState.buttonPressed = frame.isButtonDown && !lastPlaybackFrame.isButtonDown;
+    mouseState.buttonReleased = !frame.isButtonDown && lastPlaybackFrame.isButtonDown;
+    mouseState.moved = playbackFrameIdx == 0 || frame.mousePositionPx != lastPlaybackFrame.mousePositionPx;
+    lastPlaybackFrame = frame;
+    diagram->setIsMouseGrabbedByParent(false);
+    diagram->setScriptedMouseState(&mouseState);
+}
+
+void MainApp::finishPlaybackFrame() {
+    playbackFrameIdx++;
+    if (playbackFrameIdx < size_t(playbackSettings.numFrames) + GpuTimerVk::NUM_QUERY_FRAMES) {
+        return;
+    }
+    device->waitIdle();
+    frameProfiler.endFrame();
+    if (frameProfiler.writeRecordedFramesCsv(playbackSettings.outputPath, size_t(playbackSettings.numFrames))) {
+        std::cout << "Wrote the timings of " << playbackSettings.numFrames << " frames to \""
+                  << playbackSettings.outputPath << "\"." << std::endl;
+    } else {
+        std::cerr << "Error: Could not write \"" << playbackSettings.outputPath << "\"." << std::endl;
+        playbackFailed = true;
+    }
+    isPlaybackRunning = false;
+    playbackScript = {};
+    diagram->setScriptedMouseState(nullptr);
+    quit();
+}
+
 void MainApp::resolutionChanged(sgl::EventPtr event) {
     SciVisApp::resolutionChanged(event);
+    forceDiagramReRender = true;
     diagram->setBlitTargetVk(
             sceneTextureVk->getImageView(),
             VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
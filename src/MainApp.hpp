@@ -29,8 +29,17 @@
 #ifndef MAINAPP_HPP
 #define MAINAPP_HPP
 
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+
 #include <Utils/SciVis/SciVisApp.hpp>
 
+#include "FrameProfiler.hpp"
+#include "PlaybackScript.hpp"
+#include "VectorBackendNanoVGPipelined.hpp"
+
 namespace sgl {
     class DeviceSelectorVulkan;
 }
@@ -39,20 +48,63 @@ class DiagramBase;
 
 class MainApp : public sgl::SciVisApp {
 public:
-    MainApp();
+    /// Loads the graph file if graphFilePath is not empty, and otherwise shows a test graph.
+    explicit MainApp(const std::string& graphFilePath = "");
     ~MainApp() override;
     void render() override;
     void renderGui() override;
     void update(float dt) override;
     void resolutionChanged(sgl::EventPtr event) override;
 
+    /// Replays the script instead of the user input and quits after writing the timings of settings.numFrames frames.
+    void setPlayback(std::unique_ptr<PlaybackScript> script, const PlaybackSettings& settings);
+    [[nodiscard]] inline bool getPlaybackFailed() const { return playbackFailed; }
+
 private:
     void reloadDataSet() override {}
+    void updatePlayback();
+    void finishPlaybackFrame();
+    void renderGuiFrameProfiler();
 
     // Vulkan device selector.
     sgl::DeviceSelectorVulkan* deviceSelector = nullptr;
 
     DiagramBase* diagram = nullptr;
+
+    /*
+     * Render on demand: The diagram is only rendered and blitted to the scene texture if it changed; otherwise, the
+     * last rendered scene texture is reused.
+     */
+    bool useRenderOnDemand = true;
+    bool forceDiagramReRender = true; //< E.g., after the scene texture was recreated.
+    uint64_t numDiagramFramesRendered = 0;
+    uint64_t numDiagramFramesSkipped = 0;
+
+    // CPU and GPU timings of the frame stages.
+    FrameProfiler frameProfiler;
+    std::string traceExportStatus;
+    /**
+     * Throughput and latency last measured per interop sharing mode and ring depth
+     * (@see DiagramBase::setInteropRingDepth and DiagramBase::setInteropSharingMode).
+     */
+    struct InteropDepthStats {
+        float frameTimeMs = 0.0f;
+        float beginStallMs = 0.0f; //< Time until OpenGL may render into the image.
+        float latencyMs = 0.0f;
+        float copyMs = 0.0f; //< Readback wait and copy to the staging buffer; PBO copy mode only.
+    };
+    std::array<std::array<InteropDepthStats, VectorBackendNanoVGPipelined::MAX_RING_DEPTH + 1>, 2> interopDepthStats{};
+
+    /*
+     * Offline playback: The recording starts once the diagram is built. GpuTimerVk::NUM_QUERY_FRAMES additional frames
+     * are rendered, so the GPU times of the last recorded frames are available.
+     */
+    std::unique_ptr<PlaybackScript> playbackScript;
+    PlaybackSettings playbackSettings;
+    bool isPlaybackRunning = false;
+    bool playbackFailed = false;
+    size_t playbackFrameIdx = 0;
+    PlaybackFrame lastPlaybackFrame;
 };
 
 #endif //MAINAPP_HPP
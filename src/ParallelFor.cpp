@@ -0,0 +1,197 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#endif
+
+#include "ParallelFor.hpp"
+
+/// Index of the thread currently executing a chunk of parallelForChunks, or -1 outside of a parallel region.
+static thread_local int currentParallelThreadIdx = -1;
+
+static void runChunk(
+        int threadIdx, int begin, int end, const std::function<void(int threadIdx, int begin, int end)>& func) {
+    currentParallelThreadIdx = threadIdx;
+    try {
+        func(threadIdx, begin, end);
+    } catch (...) {
+        currentParallelThreadIdx = -1;
+        throw;
+    }
+    currentParallelThreadIdx = -1;
+}
+
+#ifndef _OPENMP
+/**
+ * Persistent pool of worker threads. The calling thread participates as thread 0, so the pool owns
+ * hardware_concurrency() - 1 workers. Concurrent calls to run from different threads are serialized; nested calls
+ * never reach the pool, as parallelForChunks runs them inline.
+ */
+class WorkerThreadPool {
+public:
+    static WorkerThreadPool& get() {
+        static WorkerThreadPool threadPool;
+        return threadPool;
+    }
+    [[nodiscard]] inline int getNumThreads() const { return int(workers.size()) + 1; }
+    void run(int _numChunks, const std::function<void(int threadIdx, int chunkIdx)>& func);
+
+private:
+    WorkerThreadPool();
+    ~WorkerThreadPool();
+    void workerLoop(int threadIdx);
+    void processChunks(int threadIdx);
+
+    std::vector<std::thread> workers;
+    std::mutex runMutex; //< Serializes calls to run.
+    std::mutex mutex;
+    std::condition_variable cvStart;
+    std::condition_variable cvDone;
+    const std::function<void(int, int)>* job = nullptr;
+    uint64_t jobGeneration = 0;
+    int numChunks = 0;
+    std::atomic<int> nextChunkIdx{};
+    int numWorkersBusy = 0;
+    bool shallQuit = false;
+};
+
+WorkerThreadPool::WorkerThreadPool() {
+    int numThreads = std::max(int(std::thread::hardware_concurrency()), 1);
+    for (int threadIdx = 1; threadIdx < numThreads; threadIdx++) {
+        workers.emplace_back(&WorkerThreadPool::workerLoop, this, threadIdx);
+    }
+}
+
+WorkerThreadPool::~WorkerThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        shallQuit = true;
+    }
+    cvStart.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkerThreadPool::processChunks(int threadIdx) {
+    int chunkIdx;
+    while ((chunkIdx = nextChunkIdx.fetch_add(1)) < numChunks) {
+        (*job)(threadIdx, chunkIdx);
+    }
+}
+
+void WorkerThreadPool::workerLoop(int threadIdx) {
+    uint64_t lastGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cvStart.wait(lock, [&] { return shallQuit || jobGeneration != lastGeneration; });
+            if (shallQuit) {
+                return;
+            }
+            lastGeneration = jobGeneration;
+        }
+        processChunks(threadIdx);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            numWorkersBusy--;
+        }
+        cvDone.notify_one();
+    }
+}
+
+void WorkerThreadPool::run(int _numChunks, const std::function<void(int threadIdx, int chunkIdx)>& func) {
+    std::lock_guard<std::mutex> runLock(runMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &func;
+        numChunks = _numChunks;
+        nextChunkIdx = 0;
+        numWorkersBusy = int(workers.size());
+        jobGeneration++;
+    }
+    cvStart.notify_all();
+    processChunks(0);
+    std::unique_lock<std::mutex> lock(mutex);
+    cvDone.wait(lock, [this] { return numWorkersBusy == 0; });
+    job = nullptr;
+}
+#endif
+
+int getMaxNumParallelThreads() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return WorkerThreadPool::get().getNumThreads();
+#endif
+}
+
+void parallelForChunks(int numItems, int chunkSize, const std::function<void(int threadIdx, int begin, int end)>& func) {
+    if (numItems <= 0) {
+        return;
+    }
+    chunkSize = std::max(chunkSize, 1);
+    int numChunks = (numItems - 1) / chunkSize + 1;
+    if (currentParallelThreadIdx >= 0) {
+        // Nested call from inside a chunk: run all chunks on the calling thread. This avoids a deadlock on the
+        // non-recursive pool mutex and keeps threadIdx unique among the threads running concurrently.
+        int threadIdx = currentParallelThreadIdx;
+        for (int chunkIdx = 0; chunkIdx < numChunks; chunkIdx++) {
+            int begin = chunkIdx * chunkSize;
+            func(threadIdx, begin, std::min(begin + chunkSize, numItems));
+        }
+        return;
+    }
+    if (numChunks == 1) {
+        runChunk(0, 0, numItems, func);
+        return;
+    }
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) default(none) shared(func, numChunks, chunkSize, numItems)
+    for (int chunkIdx = 0; chunkIdx < numChunks; chunkIdx++) {
+        int begin = chunkIdx * chunkSize;
+        int end = std::min(begin + chunkSize, numItems);
+        runChunk(omp_get_thread_num(), begin, end, func);
+    }
+#else
+    WorkerThreadPool::get().run(numChunks, [&](int threadIdx, int chunkIdx) {
+        int begin = chunkIdx * chunkSize;
+        int end = std::min(begin + chunkSize, numItems);
+        runChunk(threadIdx, begin, end, func);
+    });
+#endif
+}
@@ -0,0 +1,50 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PARALLELFOR_HPP
+#define PARALLELFOR_HPP
+
+#include <functional>
+
+/**
+ * Returns the maximum number of threads that may call the function passed to @see parallelForChunks concurrently.
+ * Thread indices passed to the function are in range [0, getMaxNumParallelThreads()).
+ */
+int getMaxNumParallelThreads();
+
+/**
+ * Splits the range [0, numItems) into chunks of at most chunkSize items and calls func(threadIdx, begin, end) for each
+ * chunk, distributing the chunks over all cores. OpenMP is used if available, and a persistent std::thread pool
+ * otherwise. The chunk boundaries do not depend on the number of threads, so results written to per-item slots are
+ * deterministic. threadIdx can be used for indexing per-thread scratch buffers.
+ * Nested calls from inside func are allowed and run all their chunks inline on the calling thread, passing on the
+ * threadIdx of the enclosing chunk.
+ */
+void parallelForChunks(int numItems, int chunkSize, const std::function<void(int threadIdx, int begin, int end)>& func);
+
+#endif //PARALLELFOR_HPP
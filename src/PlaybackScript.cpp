@@ -0,0 +1,133 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "PlaybackScript.hpp"
+
+void PlaybackScript::loadFromFile(const std::string& filePath) {
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Error in PlaybackScript::loadFromFile: Could not open \"" + filePath + "\".");
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    loadFromString(buffer.str());
+}
+
+void PlaybackScript::loadFromString(const std::string& script) {
+    frames.clear();
+    currentFrame = {};
+    std::istringstream scriptStream(script);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(scriptStream, line)) {
+        lineNumber++;
+        size_t commentPos = line.find('#');
+        if (commentPos != std::string::npos) {
+            line.resize(commentPos);
+        }
+        std::istringstream lineStream(line);
+        std::string command;
+        if (!(lineStream >> command)) {
+            continue;
+        }
+
+        bool isValid = true;
+        if (command == "window_size") {
+            glm::ivec2 windowSize;
+            isValid = bool(lineStream >> windowSize.x >> windowSize.y) && windowSize.x > 0 && windowSize.y > 0;
+            if (isValid) {
+                PlaybackFrame frame = currentFrame;
+                frame.windowSize = windowSize;
+                frames.push_back(frame);
+            }
+        } else if (command == "mouse_move") {
+            glm::ivec2 positionPx;
+            int numFrames = 0;
+            isValid = bool(lineStream >> positionPx.x >> positionPx.y >> numFrames) && numFrames > 0;
+            if (isValid) {
+                addFrames(positionPx, numFrames);
+            }
+        } else if (command == "select") {
+            glm::ivec2 positionPx;
+            isValid = bool(lineStream >> positionPx.x >> positionPx.y);
+            if (isValid) {
+                addFrames(positionPx, 1);
+            }
+        } else if (command == "drag") {
+            glm::ivec2 startPositionPx, endPositionPx;
+            int numFrames = 0;
+            isValid = bool(lineStream >> startPositionPx.x >> startPositionPx.y >> endPositionPx.x >> endPositionPx.y
+                    >> numFrames) && numFrames > 0;
+            if (isValid) {
+                currentFrame.mousePositionPx = startPositionPx;
+                currentFrame.isButtonDown = true;
+                frames.push_back(currentFrame);
+                addFrames(endPositionPx, numFrames);
+                currentFrame.isButtonDown = false;
+                frames.push_back(currentFrame);
+            }
+        } else if (command == "wait") {
+            int numFrames = 0;
+            isValid = bool(lineStream >> numFrames) && numFrames > 0;
+            if (isValid) {
+                frames.insert(frames.end(), size_t(numFrames), currentFrame);
+            }
+        } else {
+            isValid = false;
+        }
+        if (!isValid) {
+            throw std::runtime_error(
+                    "Error in PlaybackScript::loadFromString: Invalid command in line " + std::to_string(lineNumber)
+                    + ": \"" + line + "\".");
+        }
+    }
+
+    if (frames.empty()) {
+        throw std::runtime_error("Error in PlaybackScript::loadFromString: The script contains no frames.");
+    }
+}
+
+void PlaybackScript::addFrames(const glm::ivec2& targetPositionPx, int numFrames) {
+    glm::vec2 startPositionPx(currentFrame.mousePositionPx);
+    glm::vec2 endPositionPx(targetPositionPx);
+    for (int i = 1; i <= numFrames; i++) {
+        float t = float(i) / float(numFrames);
+        glm::vec2 positionPx = startPositionPx + t * (endPositionPx - startPositionPx);
+        currentFrame.mousePositionPx = glm::ivec2(std::lround(positionPx.x), std::lround(positionPx.y));
+        frames.push_back(currentFrame);
+    }
+}
+
+const PlaybackFrame& PlaybackScript::getFrame(size_t frameIdx) const {
+    return frames.at(frameIdx % frames.size());
+}
@@ -0,0 +1,81 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLAYBACKSCRIPT_HPP
+#define PLAYBACKSCRIPT_HPP
+
+#include <string>
+#include <vector>
+#include <glm/vec2.hpp>
+
+/// Command line settings of the offline playback mode.
+struct PlaybackSettings {
+    std::string scriptPath;
+    std::string outputPath = "playback_timings.csv";
+    int numFrames = 1000;
+    bool useGpuCurveRenderer = false;
+    bool useCpuRasterizer = false;
+    int interopRingDepth = -1; //< Negative values keep the default.
+    bool useInteropPboCopy = false; //< @see InteropSharingMode.
+};
+
+/// Input state of one frame of a @see PlaybackScript.
+struct PlaybackFrame {
+    glm::ivec2 mousePositionPx{};
+    bool isButtonDown = false; //< Left mouse button.
+    glm::ivec2 windowSize{}; //< Size the main window is set to before the frame; zero if unchanged.
+};
+
+/**
+ * Scripted input sequence for benchmarking the app without user interaction. The script is expanded into one
+ * @see PlaybackFrame per rendered frame and repeats after its end. Each line contains one of the following commands;
+ * positions are in pixels of the main window, and '#' starts a comment.
+ *
+ * window_size <width> <height>          Resizes the main window.
+ * mouse_move <x> <y> <frames>           Moves the mouse linearly to (x, y), e.g., for hover picking.
+ * select <x> <y>                        Moves the mouse to (x, y) at once, selecting the curve or node below it.
+ * drag <x0> <y0> <x1> <y1> <frames>     Presses the left button at (x0, y0), moves to (x1, y1) and releases it. This
+ *                                       moves the diagram, or resizes it if (x0, y0) lies on its border.
+ * wait <frames>                         Keeps the input unchanged.
+ */
+class PlaybackScript {
+public:
+    /// Throws std::runtime_error if the file cannot be read or contains invalid commands.
+    void loadFromFile(const std::string& filePath);
+    void loadFromString(const std::string& script);
+    [[nodiscard]] inline size_t getNumFrames() const { return frames.size(); }
+    /// Frame frameIdx modulo the script length.
+    [[nodiscard]] const PlaybackFrame& getFrame(size_t frameIdx) const;
+
+private:
+    void addFrames(const glm::ivec2& targetPositionPx, int numFrames);
+    std::vector<PlaybackFrame> frames;
+    PlaybackFrame currentFrame;
+};
+
+#endif //PLAYBACKSCRIPT_HPP
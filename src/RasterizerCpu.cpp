@@ -0,0 +1,663 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RASTERIZER_SIMD_X86
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+// The kernels need vsqrtq_f32 and vrndnq_f32, which only exist on AArch64.
+#define RASTERIZER_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+// Allows compiling the AVX2 kernels without raising the minimum instruction set of the whole program. FMA is left out
+// on purpose, so the kernels round exactly like the scalar code.
+#if defined(__GNUC__) || defined(__clang__)
+#define RASTERIZER_TARGET(x) __attribute__((target(x)))
+#else
+#define RASTERIZER_TARGET(x)
+#endif
+
+#include "ParallelFor.hpp"
+#include "RasterizerCpu.hpp"
+
+static const int TILE_PLANE_SIZE = RasterizerCpu::TILE_SIZE * RasterizerCpu::TILE_SIZE;
+static_assert(RasterizerCpu::TILE_SIZE % 8 == 0, "Tile rows need to consist of whole vectors of the kernels.");
+
+static inline float clampCoverage(float coverage) {
+    return std::min(std::max(coverage, 0.0f), 1.0f);
+}
+
+/// Clips the bounding box to the tile; the pixel range [px0, px1) x [py0, py1) is empty if nothing overlaps.
+static inline void getTilePixelRange(
+        const glm::vec2& bbMin, const glm::vec2& bbMax, int x0, int y0, int x1, int y1,
+        int& px0, int& py0, int& px1, int& py1) {
+    px0 = std::max(x0, int(std::floor(bbMin.x)));
+    py0 = std::max(y0, int(std::floor(bbMin.y)));
+    px1 = std::min(x1, int(std::ceil(bbMax.x)));
+    py1 = std::min(y1, int(std::ceil(bbMax.y)));
+}
+
+/// Returns the inclusive range of tiles with pixels in the bounding box, or false if it is outside of the target.
+static inline bool getTileRange(
+        const glm::vec2& bbMin, const glm::vec2& bbMax, int width, int height,
+        int& tx0, int& ty0, int& tx1, int& ty1) {
+    const float fx0 = std::floor(bbMin.x), fy0 = std::floor(bbMin.y);
+    const float fx1 = std::ceil(bbMax.x), fy1 = std::ceil(bbMax.y);
+    // Negated comparisons, so NaN coordinates are rejected as well.
+    if (!(fx0 < float(width) && fy0 < float(height) && fx1 > 0.0f && fy1 > 0.0f)) {
+        return false;
+    }
+    tx0 = int(std::max(fx0, 0.0f)) / RasterizerCpu::TILE_SIZE;
+    ty0 = int(std::max(fy0, 0.0f)) / RasterizerCpu::TILE_SIZE;
+    tx1 = (int(std::min(fx1, float(width))) - 1) / RasterizerCpu::TILE_SIZE;
+    ty1 = (int(std::min(fy1, float(height))) - 1) / RasterizerCpu::TILE_SIZE;
+    return true;
+}
+
+/// Segment a + t * ab and the center of the current pixel row in pixels.
+struct SegmentRow {
+    float ax, abx, aby;
+    float apy; //< Distance of the row center to a in y direction.
+    float lengthSqInv; //< 1 / |ab|^2, or zero for degenerate segments.
+    float extent; //< Half width plus the half pixel of the anti-aliasing ramp.
+};
+
+/// Keeps the maximum of the old coverage and the one of the segment for the tile row pixels [xBegin, xEnd).
+static void accumulateSegmentCoverageScalar(
+        const SegmentRow& seg, int x0, int xBegin, int xEnd, float* coverageRow) {
+    const float apyAby = seg.apy * seg.aby;
+    for (int x = xBegin; x < xEnd; x++) {
+        const float apx = float(x0 + x) + 0.5f - seg.ax;
+        float t = std::min(std::max((apx * seg.abx + apyAby) * seg.lengthSqInv, 0.0f), 1.0f);
+        float dx = apx - t * seg.abx, dy = seg.apy - t * seg.aby;
+        float coverage = clampCoverage(seg.extent - std::sqrt(dx * dx + dy * dy));
+        coverageRow[x] = std::max(coverageRow[x], coverage);
+    }
+}
+
+/**
+ * Blends src (straight color in [0, 255], alpha = 255) with the alpha alpha * coverage over the premultiplied planes of
+ * the tile row, rounds to the 8-bit grid and resets the coverage. This is the fixed-function blending of the curve
+ * pipeline, i.e., src * a + dst * (1 - a) for all channels, evaluated on an 8-bit target.
+ */
+static void blendCoverageRowScalar(
+        const float* src, float alpha, int xBegin, int xEnd, float* coverageRow, float* colorRow) {
+    for (int x = xBegin; x < xEnd; x++) {
+        const float a = alpha * coverageRow[x];
+        const float oneMinusA = 1.0f - a;
+        for (int c = 0; c < 4; c++) {
+            float& dst = colorRow[c * TILE_PLANE_SIZE + x];
+            dst = std::nearbyint(src[c] * a + dst * oneMinusA);
+        }
+        coverageRow[x] = 0.0f;
+    }
+}
+
+#ifdef RASTERIZER_SIMD_X86
+RASTERIZER_TARGET("avx2")
+static void accumulateSegmentCoverageAvx2(
+        const SegmentRow& seg, int x0, int xBegin, int xEnd, float* coverageRow) {
+    const __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), half = _mm256_set1_ps(0.5f);
+    const __m256 ax = _mm256_set1_ps(seg.ax), abx = _mm256_set1_ps(seg.abx), aby = _mm256_set1_ps(seg.aby);
+    const __m256 apy = _mm256_set1_ps(seg.apy), apyAby = _mm256_set1_ps(seg.apy * seg.aby);
+    const __m256 lengthSqInv = _mm256_set1_ps(seg.lengthSqInv), extent = _mm256_set1_ps(seg.extent);
+    for (int x = xBegin; x < xEnd; x += 8) {
+        __m256 px = _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(x0 + x), laneOffsets));
+        __m256 apx = _mm256_sub_ps(_mm256_add_ps(px, half), ax);
+        __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(apx, abx), apyAby), lengthSqInv);
+        t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+        __m256 dx = _mm256_sub_ps(apx, _mm256_mul_ps(t, abx));
+        __m256 dy = _mm256_sub_ps(apy, _mm256_mul_ps(t, aby));
+        __m256 dist = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+        __m256 coverage = _mm256_min_ps(_mm256_max_ps(_mm256_sub_ps(extent, dist), zero), one);
+        _mm256_storeu_ps(coverageRow + x, _mm256_max_ps(_mm256_loadu_ps(coverageRow + x), coverage));
+    }
+}
+
+RASTERIZER_TARGET("avx2")
+static void blendCoverageRowAvx2(
+        const float* src, float alpha, int xBegin, int xEnd, float* coverageRow, float* colorRow) {
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), alphaVec = _mm256_set1_ps(alpha);
+    const __m256 srcVec[4] = {
+            _mm256_set1_ps(src[0]), _mm256_set1_ps(src[1]), _mm256_set1_ps(src[2]), _mm256_set1_ps(src[3])
+    };
+    for (int x = xBegin; x < xEnd; x += 8) {
+        __m256 a = _mm256_mul_ps(alphaVec, _mm256_loadu_ps(coverageRow + x));
+        __m256 oneMinusA = _mm256_sub_ps(one, a);
+        for (int c = 0; c < 4; c++) {
+            float* dst = colorRow + c * TILE_PLANE_SIZE + x;
+            __m256 blended = _mm256_add_ps(_mm256_mul_ps(srcVec[c], a), _mm256_mul_ps(_mm256_loadu_ps(dst), oneMinusA));
+            _mm256_storeu_ps(dst, _mm256_round_ps(blended, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+        }
+        _mm256_storeu_ps(coverageRow + x, zero);
+    }
+}
+#endif
+
+#ifdef RASTERIZER_SIMD_NEON
+static void accumulateSegmentCoverageNeon(
+        const SegmentRow& seg, int x0, int xBegin, int xEnd, float* coverageRow) {
+    static const int32_t laneOffsetValues[4] = { 0, 1, 2, 3 };
+    const int32x4_t laneOffsets = vld1q_s32(laneOffsetValues);
+    const float32x4_t zero = vdupq_n_f32(0.0f), one = vdupq_n_f32(1.0f), half = vdupq_n_f32(0.5f);
+    const float32x4_t ax = vdupq_n_f32(seg.ax), abx = vdupq_n_f32(seg.abx), aby = vdupq_n_f32(seg.aby);
+    const float32x4_t apy = vdupq_n_f32(seg.apy), apyAby = vdupq_n_f32(seg.apy * seg.aby);
+    const float32x4_t lengthSqInv = vdupq_n_f32(seg.lengthSqInv), extent = vdupq_n_f32(seg.extent);
+    for (int x = xBegin; x < xEnd; x += 4) {
+        float32x4_t px = vcvtq_f32_s32(vaddq_s32(vdupq_n_s32(x0 + x), laneOffsets));
+        float32x4_t apx = vsubq_f32(vaddq_f32(px, half), ax);
+        float32x4_t t = vmulq_f32(vaddq_f32(vmulq_f32(apx, abx), apyAby), lengthSqInv);
+        t = vminq_f32(vmaxq_f32(t, zero), one);
+        float32x4_t dx = vsubq_f32(apx, vmulq_f32(t, abx));
+        float32x4_t dy = vsubq_f32(apy, vmulq_f32(t, aby));
+        float32x4_t dist = vsqrtq_f32(vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy)));
+        float32x4_t coverage = vminq_f32(vmaxq_f32(vsubq_f32(extent, dist), zero), one);
+        vst1q_f32(coverageRow + x, vmaxq_f32(vld1q_f32(coverageRow + x), coverage));
+    }
+}
+
+static void blendCoverageRowNeon(
+        const float* src, float alpha, int xBegin, int xEnd, float* coverageRow, float* colorRow) {
+    const float32x4_t zero = vdupq_n_f32(0.0f), one = vdupq_n_f32(1.0f), alphaVec = vdupq_n_f32(alpha);
+    const float32x4_t srcVec[4] = {
+            vdupq_n_f32(src[0]), vdupq_n_f32(src[1]), vdupq_n_f32(src[2]), vdupq_n_f32(src[3])
+    };
+    for (int x = xBegin; x < xEnd; x += 4) {
+        float32x4_t a = vmulq_f32(alphaVec, vld1q_f32(coverageRow + x));
+        float32x4_t oneMinusA = vsubq_f32(one, a);
+        for (int c = 0; c < 4; c++) {
+            float* dst = colorRow + c * TILE_PLANE_SIZE + x;
+            float32x4_t blended = vaddq_f32(vmulq_f32(srcVec[c], a), vmulq_f32(vld1q_f32(dst), oneMinusA));
+            vst1q_f32(dst, vrndnq_f32(blended));
+        }
+        vst1q_f32(coverageRow + x, zero);
+    }
+}
+#endif
+
+static void accumulateSegmentCoverage(
+        SimdLevel simdLevel, const SegmentRow& seg, int x0, int xBegin, int xEnd, float* coverageRow) {
+    switch (simdLevel) {
+#ifdef RASTERIZER_SIMD_X86
+        case SimdLevel::AVX512:
+        case SimdLevel::AVX2:
+            accumulateSegmentCoverageAvx2(seg, x0, xBegin, xEnd, coverageRow);
+            return;
+#endif
+#ifdef RASTERIZER_SIMD_NEON
+        case SimdLevel::NEON:
+            accumulateSegmentCoverageNeon(seg, x0, xBegin, xEnd, coverageRow);
+            return;
+#endif
+        default:
+            accumulateSegmentCoverageScalar(seg, x0, xBegin, xEnd, coverageRow);
+            return;
+    }
+}
+
+static void blendCoverageRow(
+        SimdLevel simdLevel, const float* src, float alpha, int xBegin, int xEnd, float* coverageRow,
+        float* colorRow) {
+    switch (simdLevel) {
+#ifdef RASTERIZER_SIMD_X86
+        case SimdLevel::AVX512:
+        case SimdLevel::AVX2:
+            blendCoverageRowAvx2(src, alpha, xBegin, xEnd, coverageRow, colorRow);
+            return;
+#endif
+#ifdef RASTERIZER_SIMD_NEON
+        case SimdLevel::NEON:
+            blendCoverageRowNeon(src, alpha, xBegin, xEnd, coverageRow, colorRow);
+            return;
+#endif
+        default:
+            blendCoverageRowScalar(src, alpha, xBegin, xEnd, coverageRow, colorRow);
+            return;
+    }
+}
+
+/// Number of pixels processed per iteration of the kernels used for the passed instruction set.
+static int getKernelWidth(SimdLevel simdLevel) {
+    switch (simdLevel) {
+#ifdef RASTERIZER_SIMD_X86
+        case SimdLevel::AVX512:
+        case SimdLevel::AVX2:
+            return 8;
+#endif
+#ifdef RASTERIZER_SIMD_NEON
+        case SimdLevel::NEON:
+            return 4;
+#endif
+        default:
+            return 1;
+    }
+}
+
+RasterizerCpu::RasterizerCpu() {
+    setSimdLevel(getBestSupportedSimdLevel());
+}
+
+void RasterizerCpu::setSimdLevel(SimdLevel _simdLevel) {
+    simdLevel = getIsSimdLevelSupported(_simdLevel) ? _simdLevel : SimdLevel::SCALAR;
+    kernelWidth = getKernelWidth(simdLevel);
+}
+
+void RasterizerCpu::beginFrame(int _width, int _height, float _scale, const glm::vec4& _clearColor) {
+    width = _width;
+    height = _height;
+    scale = _scale;
+    clearColor = _clearColor;
+    primitives.clear();
+}
+
+void RasterizerCpu::strokePolyline(
+        const glm::vec2* points, uint32_t numPoints, float strokeWidth, const glm::vec4& color) {
+    if (numPoints < 2 || color.w <= 0.0f || strokeWidth <= 0.0f) {
+        return;
+    }
+    Primitive primitive{};
+    primitive.type = PrimitiveType::POLYLINE;
+    primitive.color = color;
+    primitive.points = points;
+    primitive.numPoints = numPoints;
+    float strokeWidthPx = strokeWidth * scale;
+    primitive.halfWidth = 0.5f * std::max(strokeWidthPx, 1.0f);
+    primitive.alphaScale = std::min(strokeWidthPx, 1.0f);
+
+    glm::vec2 pointsMin = points[0], pointsMax = points[0];
+    for (uint32_t ptIdx = 1; ptIdx < numPoints; ptIdx++) {
+        pointsMin.x = std::min(pointsMin.x, points[ptIdx].x);
+        pointsMin.y = std::min(pointsMin.y, points[ptIdx].y);
+        pointsMax.x = std::max(pointsMax.x, points[ptIdx].x);
+        pointsMax.y = std::max(pointsMax.y, points[ptIdx].y);
+    }
+    float extent = primitive.halfWidth + 0.5f;
+    primitive.bbMin = glm::vec2(pointsMin.x * scale - extent, pointsMin.y * scale - extent);
+    primitive.bbMax = glm::vec2(pointsMax.x * scale + extent, pointsMax.y * scale + extent);
+    primitives.push_back(primitive);
+}
+
+void RasterizerCpu::fillCircle(const glm::vec2& center, float radius, const glm::vec4& color) {
+    if (color.w <= 0.0f || radius <= 0.0f) {
+        return;
+    }
+    Primitive primitive{};
+    primitive.type = PrimitiveType::CIRCLE;
+    primitive.color = color;
+    primitive.center = glm::vec2(center.x * scale, center.y * scale);
+    primitive.radius = radius * scale;
+    float extent = primitive.radius + 0.5f;
+    primitive.bbMin = glm::vec2(primitive.center.x - extent, primitive.center.y - extent);
+    primitive.bbMax = glm::vec2(primitive.center.x + extent, primitive.center.y + extent);
+    primitives.push_back(primitive);
+}
+
+void RasterizerCpu::drawRoundedRect(
+        const glm::vec2& rectMin, const glm::vec2& rectMax, float cornerRadius, const glm::vec4& fillColor,
+        const glm::vec4& strokeColor, float strokeWidth) {
+    Primitive primitive{};
+    primitive.type = PrimitiveType::ROUNDED_RECT;
+    primitive.color = fillColor;
+    primitive.center = glm::vec2(0.5f * (rectMin.x + rectMax.x) * scale, 0.5f * (rectMin.y + rectMax.y) * scale);
+    primitive.halfExtent = glm::vec2(
+            0.5f * std::abs(rectMax.x - rectMin.x) * scale, 0.5f * std::abs(rectMax.y - rectMin.y) * scale);
+    primitive.radius = std::clamp(
+            cornerRadius * scale, 0.0f, std::min(primitive.halfExtent.x, primitive.halfExtent.y));
+    primitive.strokeColor = strokeColor;
+    primitive.strokeHalfWidth = strokeColor.w > 0.0f ? 0.5f * std::max(strokeWidth, 0.0f) * scale : 0.0f;
+    float extent = primitive.strokeHalfWidth + 0.5f;
+    primitive.bbMin = glm::vec2(
+            primitive.center.x - primitive.halfExtent.x - extent, primitive.center.y - primitive.halfExtent.y - extent);
+    primitive.bbMax = glm::vec2(
+            primitive.center.x + primitive.halfExtent.x + extent, primitive.center.y + primitive.halfExtent.y + extent);
+    primitives.push_back(primitive);
+}
+
+void RasterizerCpu::render(uint8_t* rgbaOut) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    numTilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    numTilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    threadScratch.resize(size_t(getMaxNumParallelThreads()));
+    for (TileScratch& scratch : threadScratch) {
+        scratch.colors.resize(4 * TILE_PLANE_SIZE);
+        scratch.coverage.resize(TILE_PLANE_SIZE, 0.0f);
+        scratch.dirtyRowX0.resize(TILE_SIZE, TILE_SIZE);
+        scratch.dirtyRowX1.resize(TILE_SIZE, 0);
+    }
+
+    binPrimitives();
+    parallelForChunks(numTilesX * numTilesY, 1, [&](int threadIdx, int begin, int end) {
+        for (int tileIdx = begin; tileIdx < end; tileIdx++) {
+            rasterizeTile(tileIdx % numTilesX, tileIdx / numTilesX, threadScratch[threadIdx], rgbaOut);
+        }
+    });
+}
+
+template<class Visitor>
+void RasterizerCpu::forEachOverlappedTile(uint32_t primitiveIdx, Visitor visit) const {
+    const Primitive& primitive = primitives[primitiveIdx];
+    int tx0, ty0, tx1, ty1;
+    if (primitive.type != PrimitiveType::POLYLINE) {
+        if (getTileRange(primitive.bbMin, primitive.bbMax, width, height, tx0, ty0, tx1, ty1)) {
+            for (int ty = ty0; ty <= ty1; ty++) {
+                for (int tx = tx0; tx <= tx1; tx++) {
+                    visit(ty * numTilesX + tx, 0u);
+                }
+            }
+        }
+        return;
+    }
+
+    const float extent = primitive.halfWidth + 0.5f;
+    // Segments spanning multiple tiles only overlap the tiles whose center is closer than half of the tile diagonal
+    // plus the extent of the stroke.
+    const float maxCenterDist = 0.5f * std::sqrt(2.0f) * float(TILE_SIZE) + extent;
+    const float maxCenterDistSq = maxCenterDist * maxCenterDist;
+    for (uint32_t segmentIdx = 0; segmentIdx + 1 < primitive.numPoints; segmentIdx++) {
+        const float ax = primitive.points[segmentIdx].x * scale, ay = primitive.points[segmentIdx].y * scale;
+        const float bx = primitive.points[segmentIdx + 1].x * scale, by = primitive.points[segmentIdx + 1].y * scale;
+        glm::vec2 bbMin(std::min(ax, bx) - extent, std::min(ay, by) - extent);
+        glm::vec2 bbMax(std::max(ax, bx) + extent, std::max(ay, by) + extent);
+        if (!getTileRange(bbMin, bbMax, width, height, tx0, ty0, tx1, ty1)) {
+            continue;
+        }
+        if (tx0 == tx1 && ty0 == ty1) {
+            visit(ty0 * numTilesX + tx0, segmentIdx);
+            continue;
+        }
+        const float abx = bx - ax, aby = by - ay;
+        const float lengthSq = abx * abx + aby * aby;
+        const float lengthSqInv = lengthSq > 0.0f ? 1.0f / lengthSq : 0.0f;
+        for (int ty = ty0; ty <= ty1; ty++) {
+            const float apy = (float(ty) + 0.5f) * float(TILE_SIZE) - ay;
+            for (int tx = tx0; tx <= tx1; tx++) {
+                const float apx = (float(tx) + 0.5f) * float(TILE_SIZE) - ax;
+                float t = std::min(std::max((apx * abx + apy * aby) * lengthSqInv, 0.0f), 1.0f);
+                float dx = apx - t * abx, dy = apy - t * aby;
+                if (dx * dx + dy * dy <= maxCenterDistSq) {
+                    visit(ty * numTilesX + tx, segmentIdx);
+                }
+            }
+        }
+    }
+}
+
+void RasterizerCpu::binPrimitives() {
+    const int numTiles = numTilesX * numTilesY;
+    const int numPrimitives = int(primitives.size());
+    // All entries of a primitive are created by the same chunk, so the chunk size does not change the tile lists.
+    const int numChunksTarget = int(threadScratch.size()) * 8;
+    const int chunkSize = std::max((numPrimitives + numChunksTarget - 1) / numChunksTarget, 64);
+    const int numChunks = (numPrimitives + chunkSize - 1) / chunkSize;
+    binChunkOffsets.assign(size_t(numChunks) * size_t(numTiles), 0);
+    binOffsets.assign(size_t(numTiles) + 1, 0);
+
+    // Both passes visit the same (tile, segment) pairs and merge consecutive segments of a polyline in a tile into one
+    // entry. The first pass counts the entries per chunk and tile, the second one writes them.
+    auto binChunks = [&](bool writeEntries) {
+        for (TileScratch& scratch : threadScratch) {
+            scratch.lastPrimitiveIdx.assign(size_t(numTiles), std::numeric_limits<uint32_t>::max());
+            scratch.lastSegmentEnd.resize(size_t(numTiles));
+            scratch.lastEntryIdx.resize(size_t(numTiles));
+        }
+        parallelForChunks(numChunks, 1, [&](int threadIdx, int begin, int end) {
+            TileScratch& scratch = threadScratch[threadIdx];
+            for (int chunkIdx = begin; chunkIdx < end; chunkIdx++) {
+                size_t* chunkOffsets = binChunkOffsets.data() + size_t(chunkIdx) * size_t(numTiles);
+                const auto primitiveEnd = uint32_t(std::min((chunkIdx + 1) * chunkSize, numPrimitives));
+                for (auto primitiveIdx = uint32_t(chunkIdx * chunkSize); primitiveIdx < primitiveEnd; primitiveIdx++) {
+                    forEachOverlappedTile(primitiveIdx, [&](int tileIdx, uint32_t segmentIdx) {
+                        if (scratch.lastPrimitiveIdx[tileIdx] == primitiveIdx
+                                && scratch.lastSegmentEnd[tileIdx] == segmentIdx) {
+                            scratch.lastSegmentEnd[tileIdx] = segmentIdx + 1;
+                            if (writeEntries) {
+                                binEntries[scratch.lastEntryIdx[tileIdx]].segmentEnd = segmentIdx + 1;
+                            }
+                            return;
+                        }
+                        scratch.lastPrimitiveIdx[tileIdx] = primitiveIdx;
+                        scratch.lastSegmentEnd[tileIdx] = segmentIdx + 1;
+                        if (writeEntries) {
+                            size_t entryIdx = binOffsets[tileIdx] + chunkOffsets[tileIdx]++;
+                            binEntries[entryIdx] = BinEntry{ primitiveIdx, segmentIdx, segmentIdx + 1 };
+                            scratch.lastEntryIdx[tileIdx] = entryIdx;
+                        } else {
+                            chunkOffsets[tileIdx]++;
+                        }
+                    });
+                }
+            }
+        });
+    };
+
+    binChunks(false);
+    // Converts the counts to offsets: first over the chunks of each tile, then over the tiles.
+    parallelForChunks(numTiles, 64, [&](int threadIdx, int begin, int end) {
+        for (int tileIdx = begin; tileIdx < end; tileIdx++) {
+            size_t numEntries = 0;
+            for (int chunkIdx = 0; chunkIdx < numChunks; chunkIdx++) {
+                size_t& chunkOffset = binChunkOffsets[size_t(chunkIdx) * size_t(numTiles) + size_t(tileIdx)];
+                size_t numChunkEntries = chunkOffset;
+                chunkOffset = numEntries;
+                numEntries += numChunkEntries;
+            }
+            binOffsets[tileIdx + 1] = numEntries;
+        }
+    });
+    for (int tileIdx = 0; tileIdx < numTiles; tileIdx++) {
+        binOffsets[tileIdx + 1] += binOffsets[tileIdx];
+    }
+    binEntries.resize(binOffsets[numTiles]);
+    binChunks(true);
+}
+
+void RasterizerCpu::rasterizeTile(int tileX, int tileY, TileScratch& scratch, uint8_t* rgbaOut) const {
+    const int x0 = tileX * TILE_SIZE, y0 = tileY * TILE_SIZE;
+    const int x1 = std::min(x0 + TILE_SIZE, width), y1 = std::min(y0 + TILE_SIZE, height);
+    const float clearAlpha = clampCoverage(clearColor.w);
+    const float clearValues[4] = {
+            std::nearbyint(clampCoverage(clearColor.x) * clearAlpha * 255.0f),
+            std::nearbyint(clampCoverage(clearColor.y) * clearAlpha * 255.0f),
+            std::nearbyint(clampCoverage(clearColor.z) * clearAlpha * 255.0f),
+            std::nearbyint(clearAlpha * 255.0f)
+    };
+    for (int c = 0; c < 4; c++) {
+        float* plane = scratch.colors.data() + c * TILE_PLANE_SIZE;
+        std::fill(plane, plane + TILE_PLANE_SIZE, clearValues[c]);
+    }
+
+    const size_t tileIdx = size_t(tileY) * size_t(numTilesX) + size_t(tileX);
+    const size_t entryEnd = binOffsets[tileIdx + 1];
+    for (size_t entryIdx = binOffsets[tileIdx]; entryIdx < entryEnd; entryIdx++) {
+        const BinEntry& entry = binEntries[entryIdx];
+        const Primitive& primitive = primitives[entry.primitiveIdx];
+        if (primitive.type == PrimitiveType::POLYLINE) {
+            rasterizePolylineSegments(primitive, entry.segmentStart, entry.segmentEnd, x0, y0, scratch);
+            // A stroke leaving and re-entering the tile has multiple entries, which are blended together.
+            if (entryIdx + 1 == entryEnd || binEntries[entryIdx + 1].primitiveIdx != entry.primitiveIdx) {
+                blendCoverage(primitive.color, primitive.alphaScale, scratch);
+            }
+        } else if (primitive.type == PrimitiveType::CIRCLE) {
+            rasterizeCircle(primitive, x0, y0, scratch);
+        } else {
+            rasterizeRoundedRect(primitive, x0, y0, scratch);
+        }
+    }
+
+    // The planes already hold premultiplied 8-bit values.
+    for (int y = y0; y < y1; y++) {
+        const float* colorRow = scratch.colors.data() + (y - y0) * TILE_SIZE;
+        uint8_t* outRow = rgbaOut + (size_t(y) * size_t(width) + size_t(x0)) * 4;
+        for (int x = 0; x < x1 - x0; x++) {
+            outRow[x * 4 + 0] = uint8_t(colorRow[x]);
+            outRow[x * 4 + 1] = uint8_t(colorRow[TILE_PLANE_SIZE + x]);
+            outRow[x * 4 + 2] = uint8_t(colorRow[2 * TILE_PLANE_SIZE + x]);
+            outRow[x * 4 + 3] = uint8_t(colorRow[3 * TILE_PLANE_SIZE + x]);
+        }
+    }
+}
+
+void RasterizerCpu::markDirtySpan(int y, int& spanX0, int& spanX1, TileScratch& scratch) const {
+    spanX0 = spanX0 / kernelWidth * kernelWidth;
+    spanX1 = (spanX1 + kernelWidth - 1) / kernelWidth * kernelWidth;
+    scratch.dirtyY0 = std::min(scratch.dirtyY0, y);
+    scratch.dirtyY1 = std::max(scratch.dirtyY1, y + 1);
+    scratch.dirtyRowX0[y] = std::min(scratch.dirtyRowX0[y], spanX0);
+    scratch.dirtyRowX1[y] = std::max(scratch.dirtyRowX1[y], spanX1);
+}
+
+void RasterizerCpu::blendCoverage(const glm::vec4& color, float alphaScale, TileScratch& scratch) const {
+    const float src[4] = {
+            clampCoverage(color.x) * 255.0f, clampCoverage(color.y) * 255.0f, clampCoverage(color.z) * 255.0f, 255.0f
+    };
+    const float alpha = clampCoverage(color.w) * alphaScale;
+    for (int y = scratch.dirtyY0; y < scratch.dirtyY1; y++) {
+        if (scratch.dirtyRowX0[y] < scratch.dirtyRowX1[y]) {
+            blendCoverageRow(
+                    simdLevel, src, alpha, scratch.dirtyRowX0[y], scratch.dirtyRowX1[y],
+                    scratch.coverage.data() + y * TILE_SIZE, scratch.colors.data() + y * TILE_SIZE);
+        }
+        scratch.dirtyRowX0[y] = TILE_SIZE;
+        scratch.dirtyRowX1[y] = 0;
+    }
+    scratch.dirtyY0 = TILE_SIZE;
+    scratch.dirtyY1 = 0;
+}
+
+void RasterizerCpu::rasterizePolylineSegments(
+        const Primitive& primitive, uint32_t segmentStart, uint32_t segmentEnd, int x0, int y0,
+        TileScratch& scratch) const {
+    const int x1 = std::min(x0 + TILE_SIZE, width), y1 = std::min(y0 + TILE_SIZE, height);
+    SegmentRow seg{};
+    seg.extent = primitive.halfWidth + 0.5f;
+    for (uint32_t ptIdx = segmentStart; ptIdx < segmentEnd; ptIdx++) {
+        const float ax = primitive.points[ptIdx].x * scale, ay = primitive.points[ptIdx].y * scale;
+        const float bx = primitive.points[ptIdx + 1].x * scale, by = primitive.points[ptIdx + 1].y * scale;
+        glm::vec2 bbMin(std::min(ax, bx) - seg.extent, std::min(ay, by) - seg.extent);
+        glm::vec2 bbMax(std::max(ax, bx) + seg.extent, std::max(ay, by) + seg.extent);
+        int px0, py0, px1, py1;
+        getTilePixelRange(bbMin, bbMax, x0, y0, x1, y1, px0, py0, px1, py1);
+        if (px0 >= px1 || py0 >= py1) {
+            continue;
+        }
+
+        seg.ax = ax;
+        seg.abx = bx - ax;
+        seg.aby = by - ay;
+        const float lengthSq = seg.abx * seg.abx + seg.aby * seg.aby;
+        seg.lengthSqInv = lengthSq > 0.0f ? 1.0f / lengthSq : 0.0f;
+        const float abyInv = std::abs(seg.aby) > 1e-6f ? 1.0f / seg.aby : 0.0f;
+        for (int y = py0; y < py1; y++) {
+            seg.apy = float(y) + 0.5f - ay;
+            // Only the part of the segment within extent of the row can cover it; this keeps the pixel span of steep
+            // segments narrow compared to their bounding box.
+            int spanX0 = px0, spanX1 = px1;
+            if (abyInv != 0.0f) {
+                float t0 = std::max(std::min((seg.apy - seg.extent) * abyInv, (seg.apy + seg.extent) * abyInv), 0.0f);
+                float t1 = std::min(std::max((seg.apy - seg.extent) * abyInv, (seg.apy + seg.extent) * abyInv), 1.0f);
+                if (t0 > t1) {
+                    continue;
+                }
+                float spanMin = ax + std::min(t0 * seg.abx, t1 * seg.abx) - seg.extent;
+                float spanMax = ax + std::max(t0 * seg.abx, t1 * seg.abx) + seg.extent;
+                spanX0 = std::max(px0, int(std::floor(spanMin)));
+                spanX1 = std::min(px1, int(std::ceil(spanMax)));
+            }
+            if (spanX0 >= spanX1) {
+                continue;
+            }
+            spanX0 -= x0;
+            spanX1 -= x0;
+            markDirtySpan(y - y0, spanX0, spanX1, scratch);
+            accumulateSegmentCoverage(
+                    simdLevel, seg, x0, spanX0, spanX1, scratch.coverage.data() + (y - y0) * TILE_SIZE);
+        }
+    }
+}
+
+void RasterizerCpu::rasterizeCircle(const Primitive& primitive, int x0, int y0, TileScratch& scratch) const {
+    const int x1 = std::min(x0 + TILE_SIZE, width), y1 = std::min(y0 + TILE_SIZE, height);
+    int px0, py0, px1, py1;
+    getTilePixelRange(primitive.bbMin, primitive.bbMax, x0, y0, x1, y1, px0, py0, px1, py1);
+    if (px0 >= px1 || py0 >= py1) {
+        return;
+    }
+    const float extent = primitive.radius + 0.5f;
+    for (int y = py0; y < py1; y++) {
+        float* coverageRow = scratch.coverage.data() + (y - y0) * TILE_SIZE - x0;
+        const float dy = float(y) + 0.5f - primitive.center.y;
+        int spanX0 = px0 - x0, spanX1 = px1 - x0;
+        markDirtySpan(y - y0, spanX0, spanX1, scratch);
+        for (int x = px0; x < px1; x++) {
+            const float dx = float(x) + 0.5f - primitive.center.x;
+            coverageRow[x] = clampCoverage(extent - std::sqrt(dx * dx + dy * dy));
+        }
+    }
+    blendCoverage(primitive.color, 1.0f, scratch);
+}
+
+void RasterizerCpu::rasterizeRoundedRect(const Primitive& primitive, int x0, int y0, TileScratch& scratch) const {
+    const int x1 = std::min(x0 + TILE_SIZE, width), y1 = std::min(y0 + TILE_SIZE, height);
+    int px0, py0, px1, py1;
+    getTilePixelRange(primitive.bbMin, primitive.bbMax, x0, y0, x1, y1, px0, py0, px1, py1);
+    if (px0 >= px1 || py0 >= py1) {
+        return;
+    }
+    const float innerX = primitive.halfExtent.x - primitive.radius;
+    const float innerY = primitive.halfExtent.y - primitive.radius;
+    // The fill is blended first, then the stroke with the same signed distance.
+    for (int pass = 0; pass < 2; pass++) {
+        const bool isStroke = pass == 1;
+        if (isStroke ? primitive.strokeHalfWidth <= 0.0f : primitive.color.w <= 0.0f) {
+            continue;
+        }
+        for (int y = py0; y < py1; y++) {
+            float* coverageRow = scratch.coverage.data() + (y - y0) * TILE_SIZE - x0;
+            const float qy = std::abs(float(y) + 0.5f - primitive.center.y) - innerY;
+            int spanX0 = px0 - x0, spanX1 = px1 - x0;
+            markDirtySpan(y - y0, spanX0, spanX1, scratch);
+            for (int x = px0; x < px1; x++) {
+                // Signed distance to the rounded rectangle.
+                const float qx = std::abs(float(x) + 0.5f - primitive.center.x) - innerX;
+                const float outsideX = std::max(qx, 0.0f), outsideY = std::max(qy, 0.0f);
+                float dist = std::sqrt(outsideX * outsideX + outsideY * outsideY) + std::min(std::max(qx, qy), 0.0f)
+                        - primitive.radius;
+                coverageRow[x] = isStroke
+                        ? clampCoverage(primitive.strokeHalfWidth + 0.5f - std::abs(dist)) : clampCoverage(0.5f - dist);
+            }
+        }
+        blendCoverage(isStroke ? primitive.strokeColor : primitive.color, 1.0f, scratch);
+    }
+}
@@ -0,0 +1,151 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RASTERIZERCPU_HPP
+#define RASTERIZERCPU_HPP
+
+#include <cstdint>
+#include <vector>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include "BSplineSimd.hpp"
+
+/**
+ * Multithreaded software rasterizer for the primitives of the chord diagram, i.e., anti-aliased polyline strokes,
+ * filled circles and rounded rectangles. It needs neither a window nor a GPU.
+ *
+ * The primitives are recorded between @see beginFrame and @see render and drawn in submission order. Rendering has two
+ * parallel passes: The binning pass sorts the polyline segments and the other primitives into lists per square screen
+ * tile, keeping the submission order. Afterwards, the tiles are rasterized in parallel, each only visiting the entries
+ * of its list. Coverage is computed analytically from the distance of the pixel center to the primitive with a one
+ * pixel wide linear ramp. The segments of a stroke are combined with the maximum of their coverages before blending,
+ * so joints are not blended twice.
+ *
+ * Blending follows the curve pipeline of the GPU backend (straight alpha source, premultiplied target): With the
+ * source alpha a = alpha * coverage, the target becomes rgb * a + dst * (1 - a). The target of the GPU is 8-bit, so the
+ * tile buffer stores premultiplied values in [0, 255] and rounds them after every blend; this reproduces the
+ * accumulation of the GPU for heavy overdraw with low opacity up to the rounding differences of the hardware. The
+ * coverage and blend loops have AVX2 and NEON kernels that produce the same results as the scalar code.
+ *
+ * Colors are passed with straight alpha. The output is premultiplied RGBA8 with the top row first, as expected by the
+ * blit of the vector widget.
+ */
+class RasterizerCpu {
+public:
+    static constexpr int TILE_SIZE = 64;
+
+    RasterizerCpu();
+    /// Instruction set of the coverage and blend kernels; unsupported levels fall back to the scalar code.
+    void setSimdLevel(SimdLevel _simdLevel);
+    [[nodiscard]] inline SimdLevel getSimdLevel() const { return simdLevel; }
+
+    /// Removes all primitives; the coordinates of the following primitives are scaled by scale to get pixels.
+    void beginFrame(int _width, int _height, float _scale, const glm::vec4& _clearColor = glm::vec4(0.0f));
+    /// The points are referenced, not copied, so they need to stay valid until @see render returns.
+    void strokePolyline(const glm::vec2* points, uint32_t numPoints, float strokeWidth, const glm::vec4& color);
+    void fillCircle(const glm::vec2& center, float radius, const glm::vec4& color);
+    /// Draws a rounded rectangle; strokeWidth <= 0 disables the stroke.
+    void drawRoundedRect(
+            const glm::vec2& rectMin, const glm::vec2& rectMax, float cornerRadius, const glm::vec4& fillColor,
+            const glm::vec4& strokeColor = glm::vec4(0.0f), float strokeWidth = 0.0f);
+    /// Rasterizes all primitives into rgbaOut with a row pitch of width * 4 bytes.
+    void render(uint8_t* rgbaOut);
+
+    [[nodiscard]] inline int getWidth() const { return width; }
+    [[nodiscard]] inline int getHeight() const { return height; }
+    [[nodiscard]] inline size_t getNumPrimitives() const { return primitives.size(); }
+    /// Number of tile list entries of the last call to @see render.
+    [[nodiscard]] inline size_t getNumBinEntries() const { return binEntries.size(); }
+
+private:
+    enum class PrimitiveType : uint32_t {
+        POLYLINE, CIRCLE, ROUNDED_RECT
+    };
+    /// All positions and sizes are in pixels, except for the referenced polyline points.
+    struct Primitive {
+        PrimitiveType type;
+        glm::vec4 color;
+        glm::vec2 bbMin, bbMax; //< Including the anti-aliasing ramp.
+        // Polylines.
+        const glm::vec2* points;
+        uint32_t numPoints;
+        float halfWidth; //< At least half a pixel; thinner strokes reduce alphaScale instead.
+        float alphaScale;
+        // Circles and rounded rectangles.
+        glm::vec2 center, halfExtent;
+        float radius;
+        // Stroke of rounded rectangles.
+        glm::vec4 strokeColor;
+        float strokeHalfWidth;
+    };
+    /// Consecutive polyline segments [segmentStart, segmentEnd) overlapping a tile; other primitives use [0, 1).
+    struct BinEntry {
+        uint32_t primitiveIdx;
+        uint32_t segmentStart;
+        uint32_t segmentEnd;
+    };
+    struct TileScratch {
+        std::vector<float> colors; //< Premultiplied R, G, B and A planes in [0, 255].
+        std::vector<float> coverage; //< Coverage of the current primitive; reset to zero after blending.
+        std::vector<int> dirtyRowX0, dirtyRowX1; //< Tile-local pixel span with coverage per row.
+        int dirtyY0 = TILE_SIZE, dirtyY1 = 0;
+        // Last entry per tile while binning, used for merging consecutive segments of the same polyline.
+        std::vector<uint32_t> lastPrimitiveIdx, lastSegmentEnd;
+        std::vector<size_t> lastEntryIdx;
+    };
+    template<class Visitor>
+    void forEachOverlappedTile(uint32_t primitiveIdx, Visitor visit) const;
+    void binPrimitives();
+    void rasterizeTile(int tileX, int tileY, TileScratch& scratch, uint8_t* rgbaOut) const;
+    void rasterizePolylineSegments(
+            const Primitive& primitive, uint32_t segmentStart, uint32_t segmentEnd, int x0, int y0,
+            TileScratch& scratch) const;
+    void rasterizeCircle(const Primitive& primitive, int x0, int y0, TileScratch& scratch) const;
+    void rasterizeRoundedRect(const Primitive& primitive, int x0, int y0, TileScratch& scratch) const;
+    /// Blends the color with the coverage of the tile and resets the coverage.
+    void blendCoverage(const glm::vec4& color, float alphaScale, TileScratch& scratch) const;
+    /// Widens the tile-local span [spanX0, spanX1) of row y to whole kernel vectors and marks it as covered.
+    void markDirtySpan(int y, int& spanX0, int& spanX1, TileScratch& scratch) const;
+
+    SimdLevel simdLevel;
+    int kernelWidth = 1; //< Number of pixels processed per iteration of the coverage and blend kernels.
+    int width = 0, height = 0;
+    int numTilesX = 0, numTilesY = 0;
+    float scale = 1.0f;
+    glm::vec4 clearColor{};
+    std::vector<Primitive> primitives;
+    std::vector<TileScratch> threadScratch;
+
+    // Tile lists: binEntries[binOffsets[tileIdx], binOffsets[tileIdx + 1]) in submission order.
+    std::vector<BinEntry> binEntries;
+    std::vector<size_t> binOffsets;
+    std::vector<size_t> binChunkOffsets; //< Write position per (primitive chunk, tile) while binning.
+};
+
+#endif //RASTERIZERCPU_HPP
@@ -0,0 +1,91 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <Utils/AppSettings.hpp>
+#include <Graphics/Vulkan/Utils/Device.hpp>
+#include <Graphics/Vulkan/Image/Image.hpp>
+#include <Graphics/Vulkan/Render/Renderer.hpp>
+#include <Graphics/Vector/VectorWidget.hpp>
+
+#include "ChordDiagramModel.hpp"
+#include "VectorBackendCurvesVk.hpp"
+
+bool VectorBackendCurvesVk::checkIsSupported() {
+    // Only core Vulkan 1.0 features are used.
+    return sgl::AppSettings::get()->getPrimaryDevice() != nullptr;
+}
+
+VectorBackendCurvesVk::VectorBackendCurvesVk(sgl::VectorWidget* vectorWidget) : VectorBackend(vectorWidget) {
+}
+
+void VectorBackendCurvesVk::initialize() {
+    curvePass = std::make_shared<InstancedCurvePass>(rendererVk);
+    nodePass = std::make_shared<InstancedNodePass>(rendererVk);
+}
+
+void VectorBackendCurvesVk::destroy() {
+    curvePass = {};
+    nodePass = {};
+    renderTargetTextureVk = {};
+}
+
+void VectorBackendCurvesVk::onResize() {
+    sgl::vk::Device* device = rendererVk->getDevice();
+    sgl::vk::ImageSettings imageSettings;
+    imageSettings.width = uint32_t(fboWidthInternal);
+    imageSettings.height = uint32_t(fboHeightInternal);
+    imageSettings.format = VK_FORMAT_R8G8B8A8_UNORM;
+    imageSettings.usage =
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    renderTargetTextureVk = std::make_shared<sgl::vk::Texture>(device, imageSettings);
+    curvePass->setOutputImage(renderTargetTextureVk->getImageView());
+    curvePass->recreateSwapchain(imageSettings.width, imageSettings.height);
+    nodePass->setOutputImage(renderTargetTextureVk->getImageView());
+    nodePass->recreateSwapchain(imageSettings.width, imageSettings.height);
+}
+
+void VectorBackendCurvesVk::renderStart() {
+}
+
+void VectorBackendCurvesVk::renderEnd() {
+}
+
+void VectorBackendCurvesVk::renderDiagram(
+        const ChordDiagramModel* model, const std::vector<InstancedCurveDraw>& curveDraws,
+        uint64_t drawListVersion, const glm::vec4& clearColor,
+        const InstancedCurvePushConstants& curvePushConstants,
+        const InstancedNodePushConstants& nodePushConstants) {
+    curvePass->setClearColor(clearColor);
+    curvePass->updateModel(model);
+    curvePass->updateDrawList(curveDraws, drawListVersion);
+    curvePass->setPushConstants(curvePushConstants);
+    curvePass->render();
+    nodePass->updateModel(model);
+    nodePass->setPushConstants(nodePushConstants);
+    nodePass->render();
+}
@@ -0,0 +1,76 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VECTORBACKENDCURVESVK_HPP
+#define VECTORBACKENDCURVESVK_HPP
+
+#include <memory>
+
+#include <Graphics/Vector/VectorBackend.hpp>
+
+#include "InstancedCurvePass.hpp"
+
+class ChordDiagramModel;
+
+/**
+ * Vector widget backend that renders the chord diagram directly with Vulkan instead of NanoVG. The curves are expanded
+ * on the GPU by @see InstancedCurvePass, so no per-frame CPU path expansion is necessary. The backend only supports
+ * the chord diagram, i.e., the widget's render function calls @see renderDiagram instead of issuing vector commands.
+ */
+class VectorBackendCurvesVk : public sgl::VectorBackend {
+public:
+    static constexpr const char* RENDER_BACKEND_ID = "Instanced Curves (Vulkan)";
+    static const char* getClassID() { return RENDER_BACKEND_ID; }
+    [[nodiscard]] const char* getID() const override { return RENDER_BACKEND_ID; }
+    static bool checkIsSupported();
+
+    explicit VectorBackendCurvesVk(sgl::VectorWidget* vectorWidget);
+    void initialize() override;
+    void destroy() override;
+    void onResize() override;
+    void renderStart() override;
+    void renderEnd() override;
+
+    /**
+     * Renders the curves in the draw list and the nodes of the model; all coordinates are in pixels of the internal
+     * render target. The draw list is only uploaded if drawListVersion changed.
+     */
+    void renderDiagram(
+            const ChordDiagramModel* model, const std::vector<InstancedCurveDraw>& curveDraws,
+            uint64_t drawListVersion, const glm::vec4& clearColor,
+            const InstancedCurvePushConstants& curvePushConstants,
+            const InstancedNodePushConstants& nodePushConstants);
+    [[nodiscard]] inline int getRenderTargetWidth() const { return fboWidthInternal; }
+    [[nodiscard]] inline int getRenderTargetHeight() const { return fboHeightInternal; }
+
+private:
+    std::shared_ptr<InstancedCurvePass> curvePass;
+    std::shared_ptr<InstancedNodePass> nodePass;
+};
+
+#endif //VECTORBACKENDCURVESVK_HPP
@@ -0,0 +1,410 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <GL/glew.h>
+
+#include <Utils/AppSettings.hpp>
+#include <Graphics/OpenGL/Texture.hpp>
+#include <Graphics/OpenGL/Context/OffscreenContext.hpp>
+#include <Graphics/Vulkan/Utils/Device.hpp>
+#include <Graphics/Vulkan/Utils/SyncObjects.hpp>
+#include <Graphics/Vulkan/Utils/InteropOpenGL.hpp>
+#include <Graphics/Vulkan/Buffers/Buffer.hpp>
+#include <Graphics/Vulkan/Image/Image.hpp>
+#include <Graphics/Vulkan/Render/Renderer.hpp>
+#include <Graphics/Vector/nanovg/nanovg.h>
+#define NANOVG_GL3
+#include <Graphics/Vector/nanovg/nanovg_gl.h>
+
+#include "VectorBackendNanoVGPipelined.hpp"
+
+bool VectorBackendNanoVGPipelined::checkIsSupported() {
+    sgl::AppSettings* appSettings = sgl::AppSettings::get();
+    return appSettings->getPrimaryDevice() != nullptr && appSettings->getOffscreenContext() != nullptr;
+}
+
+bool VectorBackendNanoVGPipelined::getIsExternalMemorySupported() {
+    sgl::AppSettings* appSettings = sgl::AppSettings::get();
+    sgl::vk::Device* device = appSettings->getPrimaryDevice();
+    if (!device || !appSettings->getInstanceSupportsVulkanOpenGLInterop()) {
+        return false;
+    }
+    for (const char* extensionName : appSettings->getVulkanOpenGLInteropDeviceExtensions()) {
+        if (!device->isDeviceExtensionSupported(extensionName)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+VectorBackendNanoVGPipelined::VectorBackendNanoVGPipelined(sgl::VectorWidget* vectorWidget)
+        : VectorBackend(vectorWidget) {
+}
+
+VectorBackendNanoVGPipelined::~VectorBackendNanoVGPipelined() {
+    destroy();
+}
+
+void VectorBackendNanoVGPipelined::initialize() {
+    if (!getIsExternalMemorySupported()) {
+        sharingMode = InteropSharingMode::PBO_COPY;
+    }
+    offscreenContext = sgl::AppSettings::get()->getOffscreenContext();
+    offscreenContext->makeCurrent();
+    vg = nvgCreateGL3(NVG_ANTIALIAS | NVG_STENCIL_STROKES);
+    sgl::vk::Device* device = rendererVk->getDevice();
+    compositeTimelineSemaphore = std::make_shared<sgl::vk::Semaphore>(device, 0, VK_SEMAPHORE_TYPE_TIMELINE, 0);
+    nextTimelineValue = 1;
+}
+
+void VectorBackendNanoVGPipelined::destroy() {
+    if (!offscreenContext) {
+        return;
+    }
+    offscreenContext->makeCurrent();
+    destroySlots();
+    gpuTimerGl.destroy();
+    if (vg) {
+        nvgDeleteGL3(vg);
+        vg = nullptr;
+    }
+    compositeTimelineSemaphore = {};
+    renderTargetTextureVk = {};
+    offscreenContext = nullptr;
+}
+
+void VectorBackendNanoVGPipelined::onResize() {
+    offscreenContext->makeCurrent();
+    destroySlots();
+    createSlots();
+}
+
+void VectorBackendNanoVGPipelined::setRingDepth(int _ringDepth) {
+    _ringDepth = std::clamp(_ringDepth, 1, MAX_RING_DEPTH);
+    if (ringDepth == _ringDepth) {
+        return;
+    }
+    ringDepth = _ringDepth;
+    if (!slots.empty()) {
+        offscreenContext->makeCurrent();
+        destroySlots();
+        createSlots();
+    }
+}
+
+void VectorBackendNanoVGPipelined::setSharingMode(InteropSharingMode _sharingMode) {
+    if (_sharingMode == InteropSharingMode::EXTERNAL_MEMORY && !getIsExternalMemorySupported()) {
+        _sharingMode = InteropSharingMode::PBO_COPY;
+    }
+    if (sharingMode == _sharingMode) {
+        return;
+    }
+    sharingMode = _sharingMode;
+    if (!slots.empty()) {
+        offscreenContext->makeCurrent();
+        destroySlots();
+        createSlots();
+    }
+}
+
+void VectorBackendNanoVGPipelined::setFrameProfiler(FrameProfiler* _frameProfiler) {
+    frameProfiler = _frameProfiler;
+    gpuTimerGl.setFrameProfiler(_frameProfiler);
+}
+
+void VectorBackendNanoVGPipelined::createSlots() {
+    sgl::vk::Device* device = rendererVk->getDevice();
+    bool useExternalMemory = sharingMode == InteropSharingMode::EXTERNAL_MEMORY;
+    sgl::vk::ImageSettings imageSettings;
+    imageSettings.width = uint32_t(fboWidthInternal);
+    imageSettings.height = uint32_t(fboHeightInternal);
+    imageSettings.format = VK_FORMAT_R8G8B8A8_UNORM;
+    imageSettings.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    if (useExternalMemory) {
+        imageSettings.usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        imageSettings.exportMemory = true;
+    } else {
+        imageSettings.usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    }
+    // RGBA8 rows are tightly packed, so the readback matches the layout expected by vkCmdCopyBufferToImage.
+    size_t imageSizeInBytes = size_t(fboWidthInternal) * size_t(fboHeightInternal) * 4;
+
+    slots.resize(size_t(ringDepth));
+    for (InteropSlot& slot : slots) {
+        slot.textureVk = std::make_shared<sgl::vk::Texture>(device, imageSettings);
+        GLuint textureId;
+        if (useExternalMemory) {
+            slot.textureGl = std::make_shared<sgl::TextureGLExternalMemoryVk>(slot.textureVk->getImage());
+            slot.renderFinishedSemaphore = std::make_shared<sgl::SemaphoreVkGlInterop>(device);
+            slot.compositeFinishedSemaphore = std::make_shared<sgl::SemaphoreVkGlInterop>(device);
+            textureId = static_cast<sgl::TextureGL*>(slot.textureGl.get())->getTexture();
+        } else {
+            glGenTextures(1, &slot.colorTextureGl);
+            glBindTexture(GL_TEXTURE_2D, slot.colorTextureGl);
+            glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, fboWidthInternal, fboHeightInternal);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            textureId = slot.colorTextureGl;
+
+            // Persistent coherent mapping: The CPU may read the pixels once the fence of the readback is signaled.
+            GLbitfield mapFlags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glGenBuffers(1, &slot.pixelPackBufferGl);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pixelPackBufferGl);
+            glBufferStorage(GL_PIXEL_PACK_BUFFER, GLsizeiptr(imageSizeInBytes), nullptr, mapFlags);
+            slot.pixelPackBufferMapped = glMapBufferRange(
+                    GL_PIXEL_PACK_BUFFER, 0, GLsizeiptr(imageSizeInBytes), mapFlags);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            if (!slot.pixelPackBufferMapped) {
+                throw std::runtime_error(
+                        "Error in VectorBackendNanoVGPipelined::createSlots: Could not map the pixel pack buffer.");
+            }
+
+            slot.stagingBuffer = std::make_shared<sgl::vk::Buffer>(
+                    device, imageSizeInBytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+            slot.stagingBufferMapped = slot.stagingBuffer->mapMemory();
+        }
+
+        glGenRenderbuffers(1, &slot.stencilRenderbufferGl);
+        glBindRenderbuffer(GL_RENDERBUFFER, slot.stencilRenderbufferGl);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_STENCIL_INDEX8, fboWidthInternal, fboHeightInternal);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        glGenFramebuffers(1, &slot.framebufferGl);
+        glBindFramebuffer(GL_FRAMEBUFFER, slot.framebufferGl);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureId, 0);
+        glFramebufferRenderbuffer(
+                GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, slot.stencilRenderbufferGl);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+    currentSlotIdx = 0;
+    hasCompositedSlot = false;
+    renderTargetTextureVk = slots.front().textureVk;
+}
+
+void VectorBackendNanoVGPipelined::destroySlots() {
+    if (slots.empty()) {
+        return;
+    }
+    // The slots may still be used by frames in flight on both APIs.
+    glFinish();
+    rendererVk->getDevice()->waitIdle();
+    for (InteropSlot& slot : slots) {
+        glDeleteFramebuffers(1, &slot.framebufferGl);
+        glDeleteRenderbuffers(1, &slot.stencilRenderbufferGl);
+        if (slot.readbackFenceGl) {
+            glDeleteSync(static_cast<GLsync>(slot.readbackFenceGl));
+        }
+        if (slot.pixelPackBufferGl) {
+            // Deleting the buffer also unmaps it.
+            glDeleteBuffers(1, &slot.pixelPackBufferGl);
+        }
+        if (slot.colorTextureGl) {
+            glDeleteTextures(1, &slot.colorTextureGl);
+        }
+        if (slot.stagingBufferMapped) {
+            slot.stagingBuffer->unmapMemory();
+        }
+    }
+    slots.clear();
+    renderTargetTextureVk = {};
+}
+
+void VectorBackendNanoVGPipelined::pollCompletedSlots() {
+    uint64_t completedValue = compositeTimelineSemaphore->getSemaphoreCounterValue();
+    int64_t timeNs = frameProfiler ? frameProfiler->getTimeNs() : 0;
+    for (InteropSlot& slot : slots) {
+        if (slot.isInFlight && slot.compositeTimelineValue <= completedValue) {
+            slot.isInFlight = false;
+            if (frameProfiler && frameProfiler->getIsEnabled()) {
+                frameProfiler->recordCpuEvent(FrameStage::INTEROP_LATENCY, slot.submitTimeNs, timeNs);
+            }
+        }
+    }
+}
+
+void VectorBackendNanoVGPipelined::waitForComposite(size_t slotIdx) {
+    InteropSlot& slot = slots.at(slotIdx);
+    if (slot.isInFlight) {
+        compositeTimelineSemaphore->waitSemaphoreVk(slot.compositeTimelineValue);
+    }
+    pollCompletedSlots();
+}
+
+void VectorBackendNanoVGPipelined::renderStart() {
+    FrameProfilerScope profilerScope(frameProfiler, FrameStage::NANOVG_BEGIN_INTEROP);
+    offscreenContext->makeCurrent();
+    if (slots.empty()) {
+        createSlots();
+    }
+    InteropSlot& slot = slots.at(currentSlotIdx);
+
+    // Frames in flight: The slot may only be reused once the frame compositing its last content finished. The PBO
+    // copy mode renders into a texture Vulkan never accesses and only waits before reusing the staging buffer.
+    if (sharingMode == InteropSharingMode::EXTERNAL_MEMORY) {
+        waitForComposite(currentSlotIdx);
+    } else {
+        pollCompletedSlots();
+    }
+    if (slot.isCompositeFinishedSignaled) {
+        slot.compositeFinishedSemaphore->waitSemaphoreGl(slot.textureGl, GL_LAYOUT_SHADER_READ_ONLY_EXT);
+        slot.isCompositeFinishedSignaled = false;
+    }
+
+    gpuTimerGl.resolve();
+    gpuTimerGl.begin(FrameStage::GPU_NANOVG_GL);
+    glBindFramebuffer(GL_FRAMEBUFFER, slot.framebufferGl);
+    glViewport(0, 0, fboWidthInternal, fboHeightInternal);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+}
+
+void VectorBackendNanoVGPipelined::beginFrame(float windowWidth, float windowHeight) {
+    float pixelRatio = windowWidth > 0.0f ? float(fboWidthInternal) / windowWidth : 1.0f;
+    nvgBeginFrame(vg, windowWidth, windowHeight, pixelRatio);
+}
+
+void VectorBackendNanoVGPipelined::endFrame() {
+    FrameProfilerScope profilerScope(frameProfiler, FrameStage::NANOVG_FLUSH_INTEROP);
+    nvgEndFrame(vg);
+}
+
+void VectorBackendNanoVGPipelined::renderEnd() {
+    InteropSlot& slot = slots.at(currentSlotIdx);
+    if (sharingMode == InteropSharingMode::PBO_COPY) {
+        // Asynchronous readback; the fence is waited for when the slot is composited.
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, slot.framebufferGl);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pixelPackBufferGl);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(0, 0, fboWidthInternal, fboHeightInternal, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        slot.readbackFenceGl = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gpuTimerGl.end(FrameStage::GPU_NANOVG_GL);
+    slot.renderEndTimeNs = frameProfiler ? frameProfiler->getTimeNs() : 0;
+
+    if (sharingMode == InteropSharingMode::EXTERNAL_MEMORY) {
+        submitExternalMemorySlot(currentSlotIdx);
+    } else {
+        // Composite the slot rendered ringDepth - 1 frames ago. While the ring is filling up, the first frame is
+        // composited right away and kept until the oldest slot has a pending readback.
+        glFlush();
+        size_t oldestSlotIdx = (currentSlotIdx + 1) % slots.size();
+        if (slots.at(oldestSlotIdx).readbackFenceGl) {
+            submitPboCopySlot(oldestSlotIdx);
+        } else if (!hasCompositedSlot) {
+            submitPboCopySlot(currentSlotIdx);
+        }
+    }
+
+    currentSlotIdx = (currentSlotIdx + 1) % slots.size();
+}
+
+bool VectorBackendNanoVGPipelined::getHasPendingFrames() const {
+    return std::any_of(slots.begin(), slots.end(), [](const InteropSlot& slot) { return slot.readbackFenceGl; });
+}
+
+void VectorBackendNanoVGPipelined::compositePendingFrames() {
+    if (!getHasPendingFrames()) {
+        return;
+    }
+    offscreenContext->makeCurrent();
+    // currentSlotIdx is the slot rendered next, i.e., the oldest one.
+    size_t newestSlotIdx = (currentSlotIdx + slots.size() - 1) % slots.size();
+    for (size_t slotIdx = 0; slotIdx < slots.size(); slotIdx++) {
+        InteropSlot& slot = slots.at(slotIdx);
+        if (slotIdx != newestSlotIdx && slot.readbackFenceGl) {
+            glDeleteSync(static_cast<GLsync>(slot.readbackFenceGl));
+            slot.readbackFenceGl = nullptr;
+        }
+    }
+    if (slots.at(newestSlotIdx).readbackFenceGl) {
+        submitPboCopySlot(newestSlotIdx);
+    }
+}
+
+void VectorBackendNanoVGPipelined::submitExternalMemorySlot(size_t slotIdx) {
+    InteropSlot& slot = slots.at(slotIdx);
+
+    // No glFinish: The Vulkan frame waits for the semaphore on the GPU, and OpenGL may continue with the next slot.
+    slot.renderFinishedSemaphore->signalSemaphoreGl(slot.textureGl, GL_LAYOUT_SHADER_READ_ONLY_EXT);
+    glFlush();
+    slot.textureVk->getImage()->overwriteImageLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    renderTargetTextureVk = slot.textureVk;
+
+    // The semaphores are signaled once the current Vulkan frame, which blits the slot, has finished.
+    sgl::vk::CommandBufferPtr commandBuffer = rendererVk->getCommandBuffer();
+    commandBuffer->pushWaitSemaphore(slot.renderFinishedSemaphore, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+    commandBuffer->pushSignalSemaphore(slot.compositeFinishedSemaphore);
+    slot.isCompositeFinishedSignaled = true;
+    signalComposite(slotIdx);
+}
+
+void VectorBackendNanoVGPipelined::submitPboCopySlot(size_t slotIdx) {
+    InteropSlot& slot = slots.at(slotIdx);
+    {
+        FrameProfilerScope profilerScope(frameProfiler, FrameStage::INTEROP_COPY);
+        // The staging buffer may still be read by the Vulkan frame that composited the slot last time.
+        waitForComposite(slotIdx);
+        auto readbackFence = static_cast<GLsync>(slot.readbackFenceGl);
+        GLenum waitResult;
+        do {
+            waitResult = glClientWaitSync(readbackFence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        } while (waitResult == GL_TIMEOUT_EXPIRED);
+        glDeleteSync(readbackFence);
+        slot.readbackFenceGl = nullptr;
+        if (waitResult == GL_WAIT_FAILED) {
+            throw std::runtime_error(
+                    "Error in VectorBackendNanoVGPipelined::submitPboCopySlot: glClientWaitSync failed.");
+        }
+        // OpenGL stores the bottom row first; as with external memory, no flip is needed.
+        memcpy(
+                slot.stagingBufferMapped, slot.pixelPackBufferMapped,
+                size_t(fboWidthInternal) * size_t(fboHeightInternal) * 4);
+    }
+
+    sgl::vk::ImagePtr image = slot.textureVk->getImage();
+    VkCommandBuffer commandBuffer = rendererVk->getVkCommandBuffer();
+    image->transitionImageLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, commandBuffer);
+    image->copyFromBuffer(slot.stagingBuffer, commandBuffer);
+    image->transitionImageLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, commandBuffer);
+    renderTargetTextureVk = slot.textureVk;
+    signalComposite(slotIdx);
+}
+
+void VectorBackendNanoVGPipelined::signalComposite(size_t slotIdx) {
+    InteropSlot& slot = slots.at(slotIdx);
+    slot.compositeTimelineValue = nextTimelineValue++;
+    compositeTimelineSemaphore->setSignalSemaphoreValue(slot.compositeTimelineValue);
+    rendererVk->getCommandBuffer()->pushSignalSemaphore(compositeTimelineSemaphore);
+    slot.isInFlight = true;
+    slot.submitTimeNs = slot.renderEndTimeNs;
+    hasCompositedSlot = true;
+}
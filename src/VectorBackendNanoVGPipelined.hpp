@@ -0,0 +1,178 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VECTORBACKENDNANOVGPIPELINED_HPP
+#define VECTORBACKENDNANOVGPIPELINED_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <Graphics/Vector/VectorBackend.hpp>
+
+#include "FrameProfiler.hpp"
+
+struct NVGcontext;
+typedef struct NVGcontext NVGcontext;
+
+namespace sgl {
+class OffscreenContext;
+class Texture;
+typedef std::shared_ptr<Texture> TexturePtr;
+class SemaphoreVkGlInterop;
+typedef std::shared_ptr<SemaphoreVkGlInterop> SemaphoreVkGlInteropPtr;
+namespace vk {
+class Texture;
+typedef std::shared_ptr<Texture> TexturePtr;
+class Buffer;
+typedef std::shared_ptr<Buffer> BufferPtr;
+class Semaphore;
+typedef std::shared_ptr<Semaphore> SemaphorePtr;
+}
+}
+
+/// How the OpenGL render target is shared with Vulkan (@see VectorBackendNanoVGPipelined).
+enum class InteropSharingMode {
+    EXTERNAL_MEMORY, //< OpenGL renders into Vulkan memory imported via an opaque FD or handle (zero-copy).
+    PBO_COPY //< Read back to persistently mapped PBOs and uploaded from a staging ring; no interop extensions needed.
+};
+const char* const INTEROP_SHARING_MODE_NAMES[] = {
+        "External Memory", "PBO Copy"
+};
+
+/**
+ * NanoVG backend rendering with OpenGL into a ring of render target slots, so OpenGL can render frame N + 1 while
+ * Vulkan still composites frame N. sgl's NanoVG backend uses a single image, so OpenGL has to wait until Vulkan is
+ * done with it in every frame.
+ *
+ * External memory: Each slot is a Vulkan image imported by OpenGL with a binary interop semaphore for each direction.
+ * OpenGL signals when it finished rendering, and the Vulkan frame that composites the slot waits for it and signals
+ * back when done.
+ *
+ * PBO copy: OpenGL renders into its own texture and reads it back asynchronously to a persistently mapped pixel pack
+ * buffer of the slot. The slot is composited ringDepth - 1 frames later, when the readback has usually finished: its
+ * pixels are copied to a host-visible staging buffer and uploaded to the Vulkan image of the slot. A depth of one waits
+ * for the readback in the same frame.
+ *
+ * As the newest frames are only composited in later frames, the widget needs to call @see compositePendingFrames in
+ * frames where it is not re-rendered as long as @see getHasPendingFrames returns true.
+ *
+ * In both modes, a Vulkan timeline semaphore is signaled with a new value by every compositing frame. The CPU waits
+ * for the value of a slot before reusing it, which limits the number of frames in flight to the ring depth.
+ *
+ * The diagram needs to call @see beginFrame and @see endFrame in its render callback.
+ */
+class VectorBackendNanoVGPipelined : public sgl::VectorBackend {
+public:
+    static constexpr const char* RENDER_BACKEND_ID = "NanoVG (OpenGL, Pipelined Interop)";
+    static const char* getClassID() { return RENDER_BACKEND_ID; }
+    [[nodiscard]] const char* getID() const override { return RENDER_BACKEND_ID; }
+    static bool checkIsSupported();
+    /// Whether the Vulkan instance and device support the extensions for sharing memory and semaphores with OpenGL.
+    static bool getIsExternalMemorySupported();
+    static constexpr int MAX_RING_DEPTH = 3;
+
+    explicit VectorBackendNanoVGPipelined(sgl::VectorWidget* vectorWidget);
+    ~VectorBackendNanoVGPipelined() override;
+    void initialize() override;
+    void destroy() override;
+    void onResize() override;
+    void renderStart() override;
+    void renderEnd() override;
+
+    /// Starts and ends the NanoVG frame in the coordinate system of the widget.
+    void beginFrame(float windowWidth, float windowHeight);
+    void endFrame();
+    [[nodiscard]] inline NVGcontext* getContext() { return vg; }
+
+    /// Number of interop images in [1, MAX_RING_DEPTH]; a depth of one serializes OpenGL and Vulkan.
+    void setRingDepth(int _ringDepth);
+    [[nodiscard]] inline int getRingDepth() const { return ringDepth; }
+    /// External memory falls back to PBO copies if not supported.
+    void setSharingMode(InteropSharingMode _sharingMode);
+    [[nodiscard]] inline InteropSharingMode getSharingMode() const { return sharingMode; }
+    void setFrameProfiler(FrameProfiler* _frameProfiler);
+
+    /// Whether rendered frames are still waiting for their readback to be composited (PBO copy mode only).
+    [[nodiscard]] bool getHasPendingFrames() const;
+    /**
+     * Composites the most recently rendered frame without rendering a new one and drops older pending frames. Needs
+     * to be called while recording the Vulkan frame, like @see renderEnd.
+     */
+    void compositePendingFrames();
+
+private:
+    void createSlots();
+    void destroySlots();
+    /// Records the latency of the slots whose compositing frame finished since the last call.
+    void pollCompletedSlots();
+    /// Blocks until the Vulkan frame that last composited the slot finished.
+    void waitForComposite(size_t slotIdx);
+    void submitExternalMemorySlot(size_t slotIdx);
+    void submitPboCopySlot(size_t slotIdx);
+    /// Adds the semaphores of the compositing frame to the current Vulkan command buffer.
+    void signalComposite(size_t slotIdx);
+
+    struct InteropSlot {
+        sgl::vk::TexturePtr textureVk;
+        uint32_t framebufferGl = 0;
+        uint32_t stencilRenderbufferGl = 0;
+        uint64_t compositeTimelineValue = 0; //< Signaled by the frame compositing the slot; 0 if never used.
+        bool isInFlight = false;
+        int64_t renderEndTimeNs = 0; //< When OpenGL finished recording the last frame in the slot.
+        int64_t submitTimeNs = 0; //< Render end time of the frame in flight; the start of its latency.
+
+        // External memory.
+        sgl::TexturePtr textureGl;
+        sgl::SemaphoreVkGlInteropPtr renderFinishedSemaphore; //< OpenGL -> Vulkan.
+        sgl::SemaphoreVkGlInteropPtr compositeFinishedSemaphore; //< Vulkan -> OpenGL.
+        bool isCompositeFinishedSignaled = false; //< Whether OpenGL needs to wait before rendering into the slot.
+
+        // PBO copy.
+        uint32_t colorTextureGl = 0;
+        uint32_t pixelPackBufferGl = 0;
+        void* pixelPackBufferMapped = nullptr;
+        void* readbackFenceGl = nullptr; //< GLsync of the readback; null if no readback is pending.
+        sgl::vk::BufferPtr stagingBuffer;
+        void* stagingBufferMapped = nullptr;
+    };
+    std::vector<InteropSlot> slots;
+    int ringDepth = 2;
+    InteropSharingMode sharingMode = InteropSharingMode::EXTERNAL_MEMORY;
+    size_t currentSlotIdx = 0;
+    bool hasCompositedSlot = false; //< Whether renderTargetTextureVk holds a rendered frame.
+    sgl::vk::SemaphorePtr compositeTimelineSemaphore;
+    uint64_t nextTimelineValue = 1;
+
+    sgl::OffscreenContext* offscreenContext = nullptr;
+    NVGcontext* vg = nullptr;
+    FrameProfiler* frameProfiler = nullptr;
+    GpuTimerGl gpuTimerGl{nullptr};
+};
+
+#endif //VECTORBACKENDNANOVGPIPELINED_HPP
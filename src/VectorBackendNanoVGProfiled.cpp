@@ -0,0 +1,54 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "VectorBackendNanoVGProfiled.hpp"
+
+void VectorBackendNanoVGProfiled::destroy() {
+    // The queries must be deleted while the OpenGL context still exists.
+    gpuTimerGl.destroy();
+    sgl::VectorBackendNanoVG::destroy();
+}
+
+void VectorBackendNanoVGProfiled::renderStart() {
+    {
+        FrameProfilerScope scope(frameProfiler, FrameStage::NANOVG_BEGIN_INTEROP);
+        sgl::VectorBackendNanoVG::renderStart();
+    }
+    // The OpenGL context is current from here on.
+    gpuTimerGl.resolve();
+    gpuTimerGl.begin(FrameStage::GPU_NANOVG_GL);
+}
+
+void VectorBackendNanoVGProfiled::renderEnd() {
+    {
+        FrameProfilerScope scope(frameProfiler, FrameStage::NANOVG_FLUSH_INTEROP);
+        sgl::VectorBackendNanoVG::renderEnd();
+    }
+    // Issued after the flush, as NanoVG only submits the draw calls at the end of the frame.
+    gpuTimerGl.end(FrameStage::GPU_NANOVG_GL);
+}
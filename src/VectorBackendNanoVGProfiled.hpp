@@ -0,0 +1,58 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VECTORBACKENDNANOVGPROFILED_HPP
+#define VECTORBACKENDNANOVGPROFILED_HPP
+
+#include <Graphics/Vector/VectorBackendNanoVG.hpp>
+
+#include "FrameProfiler.hpp"
+
+/**
+ * NanoVG backend that reports the time spent in the frame begin and end of the OpenGL backend to a
+ * @see FrameProfiler. The frame begin waits for the Vulkan-OpenGL interop semaphore, and the frame end flushes the
+ * tessellated paths to OpenGL and signals the Vulkan side. The GPU time of the OpenGL commands is measured with
+ * timestamp queries around both. It uses the ID of the base class, so backend selection is unaffected.
+ */
+class VectorBackendNanoVGProfiled : public sgl::VectorBackendNanoVG {
+public:
+    using sgl::VectorBackendNanoVG::VectorBackendNanoVG;
+    inline void setFrameProfiler(FrameProfiler* _frameProfiler) {
+        frameProfiler = _frameProfiler;
+        gpuTimerGl.setFrameProfiler(_frameProfiler);
+    }
+    void destroy() override;
+    void renderStart() override;
+    void renderEnd() override;
+
+private:
+    FrameProfiler* frameProfiler = nullptr;
+    GpuTimerGl gpuTimerGl{nullptr};
+};
+
+#endif //VECTORBACKENDNANOVGPROFILED_HPP
@@ -0,0 +1,130 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <Utils/AppSettings.hpp>
+#include <Graphics/Vulkan/Utils/Device.hpp>
+#include <Graphics/Vulkan/Utils/SyncObjects.hpp>
+#include <Graphics/Vulkan/Buffers/Buffer.hpp>
+#include <Graphics/Vulkan/Image/Image.hpp>
+#include <Graphics/Vulkan/Render/Renderer.hpp>
+
+#include "VectorBackendRasterCpu.hpp"
+
+bool VectorBackendRasterCpu::checkIsSupported() {
+    // Vulkan is only used for copying the rasterized image.
+    return sgl::AppSettings::get()->getPrimaryDevice() != nullptr;
+}
+
+VectorBackendRasterCpu::VectorBackendRasterCpu(sgl::VectorWidget* vectorWidget) : VectorBackend(vectorWidget) {
+}
+
+VectorBackendRasterCpu::~VectorBackendRasterCpu() {
+    destroy();
+}
+
+void VectorBackendRasterCpu::initialize() {
+    sgl::vk::Device* device = rendererVk->getDevice();
+    uploadTimelineSemaphore = std::make_shared<sgl::vk::Semaphore>(device, 0, VK_SEMAPHORE_TYPE_TIMELINE, 0);
+    nextTimelineValue = 1;
+}
+
+void VectorBackendRasterCpu::destroy() {
+    if (!uploadTimelineSemaphore) {
+        return;
+    }
+    destroyStagingBuffers();
+    uploadTimelineSemaphore = {};
+    renderTargetTextureVk = {};
+}
+
+void VectorBackendRasterCpu::destroyStagingBuffers() {
+    if (!stagingBuffers.front().buffer) {
+        return;
+    }
+    // The buffers may still be read by frames in flight.
+    rendererVk->getDevice()->waitIdle();
+    for (StagingBuffer& stagingBuffer : stagingBuffers) {
+        stagingBuffer.buffer->unmapMemory();
+        stagingBuffer = {};
+    }
+}
+
+void VectorBackendRasterCpu::onResize() {
+    destroyStagingBuffers();
+    sgl::vk::Device* device = rendererVk->getDevice();
+    sgl::vk::ImageSettings imageSettings;
+    imageSettings.width = uint32_t(fboWidthInternal);
+    imageSettings.height = uint32_t(fboHeightInternal);
+    imageSettings.format = VK_FORMAT_R8G8B8A8_UNORM;
+    imageSettings.usage =
+            VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    renderTargetTextureVk = std::make_shared<sgl::vk::Texture>(device, imageSettings);
+
+    size_t imageSizeInBytes = size_t(fboWidthInternal) * size_t(fboHeightInternal) * 4;
+    for (StagingBuffer& stagingBuffer : stagingBuffers) {
+        stagingBuffer.buffer = std::make_shared<sgl::vk::Buffer>(
+                device, imageSizeInBytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+        stagingBuffer.mappedData = stagingBuffer.buffer->mapMemory();
+        stagingBuffer.uploadTimelineValue = 0;
+    }
+    currentStagingBufferIdx = 0;
+}
+
+void VectorBackendRasterCpu::renderStart() {
+}
+
+void VectorBackendRasterCpu::renderEnd() {
+}
+
+RasterizerCpu& VectorBackendRasterCpu::beginFrame(float windowWidth) {
+    float scale = windowWidth > 0.0f ? float(fboWidthInternal) / windowWidth : 1.0f;
+    rasterizer.beginFrame(fboWidthInternal, fboHeightInternal, scale);
+    return rasterizer;
+}
+
+void VectorBackendRasterCpu::endFrame() {
+    StagingBuffer& stagingBuffer = stagingBuffers.at(currentStagingBufferIdx);
+    currentStagingBufferIdx = (currentStagingBufferIdx + 1) % NUM_STAGING_BUFFERS;
+    {
+        FrameProfilerScope profilerScope(frameProfiler, FrameStage::RASTERIZE_TILES_CPU);
+        if (stagingBuffer.uploadTimelineValue != 0) {
+            uploadTimelineSemaphore->waitSemaphoreVk(stagingBuffer.uploadTimelineValue);
+        }
+        rasterizer.render(static_cast<uint8_t*>(stagingBuffer.mappedData));
+    }
+
+    sgl::vk::ImagePtr image = renderTargetTextureVk->getImage();
+    VkCommandBuffer commandBuffer = rendererVk->getVkCommandBuffer();
+    image->transitionImageLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, commandBuffer);
+    image->copyFromBuffer(stagingBuffer.buffer, commandBuffer);
+    image->transitionImageLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, commandBuffer);
+
+    stagingBuffer.uploadTimelineValue = nextTimelineValue++;
+    uploadTimelineSemaphore->setSignalSemaphoreValue(stagingBuffer.uploadTimelineValue);
+    rendererVk->getCommandBuffer()->pushSignalSemaphore(uploadTimelineSemaphore);
+}
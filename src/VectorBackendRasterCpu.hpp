@@ -0,0 +1,100 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VECTORBACKENDRASTERCPU_HPP
+#define VECTORBACKENDRASTERCPU_HPP
+
+#include <array>
+#include <memory>
+
+#include <Graphics/Vector/VectorBackend.hpp>
+
+#include "FrameProfiler.hpp"
+#include "RasterizerCpu.hpp"
+
+namespace sgl {
+namespace vk {
+class Buffer;
+typedef std::shared_ptr<Buffer> BufferPtr;
+class Semaphore;
+typedef std::shared_ptr<Semaphore> SemaphorePtr;
+}
+}
+
+/**
+ * Vector widget backend that rasterizes the chord diagram on the CPU with @see RasterizerCpu, e.g., for machines
+ * without a GPU, where Vulkan runs on a software implementation anyway. The tiles are rasterized directly into a
+ * host-visible staging buffer, which is then copied to the render target by the current Vulkan frame. Like
+ * @see VectorBackendCurvesVk, the backend only supports the chord diagram; the widget's render function records the
+ * primitives between @see beginFrame and @see endFrame.
+ *
+ * The staging buffers are used round-robin; a Vulkan timeline semaphore signaled by the frame that copies from a
+ * staging buffer guards it against being overwritten while the copy is in flight.
+ */
+class VectorBackendRasterCpu : public sgl::VectorBackend {
+public:
+    static constexpr const char* RENDER_BACKEND_ID = "Tiled Raster (CPU)";
+    static const char* getClassID() { return RENDER_BACKEND_ID; }
+    [[nodiscard]] const char* getID() const override { return RENDER_BACKEND_ID; }
+    static bool checkIsSupported();
+
+    explicit VectorBackendRasterCpu(sgl::VectorWidget* vectorWidget);
+    ~VectorBackendRasterCpu() override;
+    void initialize() override;
+    void destroy() override;
+    void onResize() override;
+    void renderStart() override;
+    void renderEnd() override;
+
+    /// Starts recording; the coordinates of the primitives are in the widget's coordinate system of the passed width.
+    RasterizerCpu& beginFrame(float windowWidth);
+    /// Rasterizes the recorded primitives and records the upload to the render target.
+    void endFrame();
+    [[nodiscard]] inline int getRenderTargetWidth() const { return fboWidthInternal; }
+    [[nodiscard]] inline int getRenderTargetHeight() const { return fboHeightInternal; }
+    inline void setFrameProfiler(FrameProfiler* _frameProfiler) { frameProfiler = _frameProfiler; }
+
+private:
+    void destroyStagingBuffers();
+
+    struct StagingBuffer {
+        sgl::vk::BufferPtr buffer;
+        void* mappedData = nullptr;
+        uint64_t uploadTimelineValue = 0; //< Signaled by the frame copying from the buffer; 0 if never used.
+    };
+    static constexpr size_t NUM_STAGING_BUFFERS = 2;
+    std::array<StagingBuffer, NUM_STAGING_BUFFERS> stagingBuffers;
+    size_t currentStagingBufferIdx = 0;
+    sgl::vk::SemaphorePtr uploadTimelineSemaphore;
+    uint64_t nextTimelineValue = 1;
+
+    RasterizerCpu rasterizer;
+    FrameProfiler* frameProfiler = nullptr;
+};
+
+#endif //VECTORBACKENDRASTERCPU_HPP
@@ -0,0 +1,706 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ChordDiagramModel.hpp"
+#include "DiagramSpatialIndex.hpp"
+#include "GraphFile.hpp"
+#include "RasterizerCpu.hpp"
+
+/*
+ * Regression tests of the geometry code shared by the app, the benchmark and the export tool. Each test is run by
+ * passing its name, e.g., "DiagramTests edge_records"; ctest runs all of them. Failed checks are printed and make the
+ * test return 1; tests that cannot run on this CPU return 77 (skipped).
+ */
+
+static const int TEST_SKIPPED = 77;
+static int numFailedChecks = 0;
+
+static void checkCondition(bool condition, const char* expression, int line) {
+    if (!condition) {
+        std::cerr << "Check failed in line " << line << ": " << expression << std::endl;
+        numFailedChecks++;
+    }
+}
+#define CHECK(condition) checkCondition((condition), #condition, __LINE__)
+
+static void buildRandomEdges(
+        int numLeaves, size_t numEdges, uint32_t seed,
+        std::vector<std::pair<uint32_t, uint32_t>>& edgeList, std::vector<float>& weights) {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<uint32_t> leafDistribution(0, uint32_t(numLeaves - 1));
+    std::uniform_real_distribution<float> weightDistribution(0.0f, 1.0f);
+    edgeList.resize(numEdges);
+    weights.resize(numEdges);
+    for (size_t edgeIdx = 0; edgeIdx < numEdges; edgeIdx++) {
+        edgeList[edgeIdx] = { leafDistribution(generator), leafDistribution(generator) };
+        weights[edgeIdx] = weightDistribution(generator);
+    }
+    // The boundaries of the clamped range.
+    weights.front() = 0.0f;
+    weights.back() = 1.0f;
+}
+
+template<class T>
+static bool getIsBitIdentical(const std::vector<T>& data0, const std::vector<T>& data1) {
+    return data0.size() == data1.size() && (data0.empty()
+            || std::memcmp(data0.data(), data1.data(), sizeof(T) * data0.size()) == 0);
+}
+
+/// setEdgesFromRecords must produce exactly the same model as setEdges, including the tessellated curves.
+static int testEdgeRecords() {
+    const int numLeaves = 97;
+    std::vector<std::pair<uint32_t, uint32_t>> edgeList;
+    std::vector<float> weights;
+    // More edges than one chunk of records, so the edges are scattered by several tasks.
+    buildRandomEdges(numLeaves, 150000, 3, edgeList, weights);
+
+    // A stride larger than the record tests additional per-edge attributes.
+    struct PaddedEdgeRecord {
+        GraphFileEdge edge;
+        uint32_t attribute;
+    };
+    std::vector<PaddedEdgeRecord> edgeRecords(edgeList.size());
+    for (size_t edgeIdx = 0; edgeIdx < edgeList.size(); edgeIdx++) {
+        edgeRecords[edgeIdx].edge = { edgeList[edgeIdx].first, edgeList[edgeIdx].second, weights[edgeIdx] };
+        edgeRecords[edgeIdx].attribute = 0xFFFFFFFFu;
+    }
+
+    ChordDiagramModel modelEdges, modelRecords;
+    for (ChordDiagramModel* model : { &modelEdges, &modelRecords }) {
+        model->buildRadialHierarchy(numLeaves, 4);
+    }
+    modelEdges.setEdges(edgeList, weights);
+    modelRecords.setEdgesFromRecords(
+            reinterpret_cast<const uint8_t*>(edgeRecords.data()), edgeRecords.size(), sizeof(PaddedEdgeRecord));
+    CHECK(modelEdges.getNumLines() == modelRecords.getNumLines());
+    CHECK(getIsBitIdentical(modelEdges.getEdges(), modelRecords.getEdges()));
+
+    for (bool useAdaptiveSubdivision : { true, false }) {
+        for (ChordDiagramModel* model : { &modelEdges, &modelRecords }) {
+            model->setUseAdaptiveSubdivision(useAdaptiveSubdivision);
+            model->tessellate(400.0f);
+        }
+        CHECK(getIsBitIdentical(modelEdges.getCurveOffsets(), modelRecords.getCurveOffsets()));
+        CHECK(getIsBitIdentical(modelEdges.getCurvePoints(), modelRecords.getCurvePoints()));
+    }
+
+    // Invalid edges are rejected before the model is changed.
+    edgeRecords[100].edge.nodeIdx1 = uint32_t(numLeaves);
+    bool hasThrown = false;
+    try {
+        modelRecords.setEdgesFromRecords(
+                reinterpret_cast<const uint8_t*>(edgeRecords.data()), edgeRecords.size(), sizeof(PaddedEdgeRecord));
+    } catch (const std::runtime_error&) {
+        hasThrown = true;
+    }
+    CHECK(hasThrown);
+    CHECK(getIsBitIdentical(modelEdges.getEdges(), modelRecords.getEdges()));
+    hasThrown = false;
+    try {
+        modelRecords.addEdges({ { 0u, 1u }, { 2u, uint32_t(numLeaves) } });
+    } catch (const std::runtime_error&) {
+        hasThrown = true;
+    }
+    CHECK(hasThrown);
+    hasThrown = false;
+    try {
+        modelRecords.removeEdges({ 0, -1 });
+    } catch (const std::runtime_error&) {
+        hasThrown = true;
+    }
+    CHECK(hasThrown);
+    CHECK(getIsBitIdentical(modelEdges.getEdges(), modelRecords.getEdges()));
+    return 0;
+}
+
+/**
+ * Returns the number of lines of model that have no line with the same end points, edge record and curve points (up to
+ * maxError per coordinate) in reference.
+ */
+static int countMismatchingLines(const ChordDiagramModel& model, const ChordDiagramModel& reference, float maxError) {
+    // Lines with the same end points are matched in order of occurrence.
+    std::map<std::pair<uint32_t, uint32_t>, std::vector<int>> referenceLines;
+    for (int lineIdx = reference.getNumLines() - 1; lineIdx >= 0; lineIdx--) {
+        const HEBEdge& edge = reference.getEdges()[lineIdx];
+        referenceLines[{ edge.pointIdx0, edge.pointIdx1 }].push_back(lineIdx);
+    }
+    int numMismatches = 0;
+    const std::vector<uint32_t>& curveOffsets = model.getCurveOffsets();
+    const std::vector<uint32_t>& referenceCurveOffsets = reference.getCurveOffsets();
+    for (int lineIdx = 0; lineIdx < model.getNumLines(); lineIdx++) {
+        const HEBEdge& edge = model.getEdges()[lineIdx];
+        auto it = referenceLines.find({ edge.pointIdx0, edge.pointIdx1 });
+        if (it == referenceLines.end() || it->second.empty()) {
+            numMismatches++;
+            continue;
+        }
+        const int referenceLineIdx = it->second.back();
+        it->second.pop_back();
+        const HEBEdge& referenceEdge = reference.getEdges()[referenceLineIdx];
+        uint32_t numPoints = curveOffsets[lineIdx + 1] - curveOffsets[lineIdx];
+        bool isEqual = edge.weight == referenceEdge.weight && edge.lcaIdx == referenceEdge.lcaIdx
+                && edge.numControlPoints == referenceEdge.numControlPoints
+                && numPoints == referenceCurveOffsets[referenceLineIdx + 1] - referenceCurveOffsets[referenceLineIdx];
+        for (uint32_t pointIdx = 0; isEqual && pointIdx < numPoints; pointIdx++) {
+            glm::vec2 diff = model.getCurvePoints()[curveOffsets[lineIdx] + pointIdx]
+                    - reference.getCurvePoints()[referenceCurveOffsets[referenceLineIdx] + pointIdx];
+            isEqual = std::abs(diff.x) <= maxError && std::abs(diff.y) <= maxError;
+        }
+        numMismatches += isEqual ? 0 : 1;
+    }
+    return numMismatches;
+}
+
+/**
+ * Incremental updates (beta blending, added, removed and re-weighted edges, moved nodes) must produce the same curves
+ * as building the final state from scratch. setEdges sorts the lines, so they are matched by their end points. The
+ * scalar code is bit-exact; the SIMD kernels evaluate groups of lines and may differ from single patched lines by
+ * rounding.
+ */
+static int testIncrementalUpdates() {
+    const int numLeaves = 60;
+    const float radiusPx = 300.0f;
+    std::mt19937 generator(19);
+    std::uniform_int_distribution<uint32_t> leafDistribution(0, uint32_t(numLeaves - 1));
+    std::map<std::pair<uint32_t, uint32_t>, float> edgeWeights; //< All edges ever added, with unique end points.
+    auto generateEdges = [&](size_t numEdges, std::vector<std::pair<uint32_t, uint32_t>>& edgeList,
+            std::vector<float>& weights) {
+        while (edgeList.size() < numEdges) {
+            std::pair<uint32_t, uint32_t> edge(leafDistribution(generator), leafDistribution(generator));
+            if (edge.first != edge.second && edgeWeights.count(edge) == 0) {
+                edgeWeights[edge] = float(edgeList.size() % 10) / 9.0f;
+                edgeList.push_back(edge);
+                weights.push_back(edgeWeights[edge]);
+            }
+        }
+    };
+    std::vector<std::pair<uint32_t, uint32_t>> initialEdges, addedEdges;
+    std::vector<float> initialWeights, addedWeights;
+    generateEdges(800, initialEdges, initialWeights);
+    generateEdges(200, addedEdges, addedWeights);
+
+    ChordDiagramModel modelNodes;
+    modelNodes.buildRadialHierarchy(numLeaves, 4);
+    const uint32_t leafIdxOffset = modelNodes.getLeafIdxOffset();
+    const std::vector<uint32_t> movedNodeIndices = { 1u, leafIdxOffset + 3u, leafIdxOffset + 20u };
+    const std::vector<glm::vec2> movedNodePositions = {
+            glm::vec2(0.1f, 0.3f), glm::vec2(0.0f, 1.0f), glm::vec2(-0.6f, -0.8f) };
+    auto getNewWeight = [](const std::pair<uint32_t, uint32_t>& edge) {
+        return float((edge.first * 7u + edge.second) % 13u) / 12.0f;
+    };
+
+    std::vector<SimdLevel> simdLevels = { SimdLevel::SCALAR };
+    if (getBestSupportedSimdLevel() != SimdLevel::SCALAR) {
+        simdLevels.push_back(getBestSupportedSimdLevel());
+    }
+    for (SimdLevel simdLevel : simdLevels) {
+        const float maxError = simdLevel == SimdLevel::SCALAR ? 0.0f : 1e-5f;
+        for (bool useBetaBlendCache : { false, true }) {
+            for (bool useAdaptiveSubdivision : { false, true }) {
+                ChordDiagramModel model;
+                model.buildRadialHierarchy(numLeaves, 4);
+                model.setSimdLevel(simdLevel);
+                model.setUseBetaBlendCache(useBetaBlendCache);
+                model.setUseAdaptiveSubdivision(useAdaptiveSubdivision);
+                model.setEdges(initialEdges, initialWeights);
+                model.tessellate(radiusPx);
+
+                model.setBeta(0.4f);
+                model.addEdges(addedEdges, addedWeights);
+                std::vector<int> removedLines;
+                std::map<std::pair<uint32_t, uint32_t>, float> finalEdgeWeights;
+                for (int lineIdx = 0; lineIdx < model.getNumLines(); lineIdx++) {
+                    const HEBEdge& edge = model.getEdges()[lineIdx];
+                    std::pair<uint32_t, uint32_t> endPoints(edge.pointIdx0, edge.pointIdx1);
+                    if ((endPoints.first + endPoints.second) % 5u == 0u) {
+                        removedLines.push_back(lineIdx);
+                    } else {
+                        finalEdgeWeights[endPoints] = getNewWeight(endPoints);
+                    }
+                }
+                model.removeEdges(removedLines);
+                std::vector<float> newWeights;
+                for (const HEBEdge& edge : model.getEdges()) {
+                    newWeights.push_back(getNewWeight({ edge.pointIdx0, edge.pointIdx1 }));
+                }
+                model.setEdgeWeights(newWeights);
+                model.setNodePositions(movedNodeIndices, movedNodePositions);
+                model.setBeta(0.9f);
+
+                ChordDiagramModel modelReference;
+                modelReference.buildRadialHierarchy(numLeaves, 4);
+                modelReference.setNodePositions(movedNodeIndices, movedNodePositions);
+                modelReference.setUseBetaBlendCache(useBetaBlendCache);
+                modelReference.setUseAdaptiveSubdivision(useAdaptiveSubdivision);
+                modelReference.setBeta(0.9f);
+                modelReference.setSimdLevel(simdLevel);
+                std::vector<std::pair<uint32_t, uint32_t>> finalEdges;
+                std::vector<float> finalWeights;
+                for (const auto& [endPoints, weight] : finalEdgeWeights) {
+                    finalEdges.push_back(endPoints);
+                    finalWeights.push_back(weight);
+                }
+                modelReference.setEdges(finalEdges, finalWeights);
+                modelReference.tessellate(radiusPx);
+
+                CHECK(model.getNumLines() == modelReference.getNumLines());
+                CHECK(model.getCurvePoints().size() == modelReference.getCurvePoints().size());
+                int numMismatches = countMismatchingLines(model, modelReference, maxError);
+                if (numMismatches != 0) {
+                    std::cerr << SIMD_LEVEL_NAMES[int(simdLevel)] << ", blend cache " << useBetaBlendCache
+                              << ", adaptive " << useAdaptiveSubdivision << ": " << numMismatches << " lines differ."
+                              << std::endl;
+                }
+                CHECK(numMismatches == 0);
+            }
+        }
+    }
+    return 0;
+}
+
+/// Reference for @see DiagramSpatialIndex::findNearestCurve: the first segment in point order with minimal distance.
+static int findNearestCurveLinear(const ChordDiagramModel& model, const glm::vec2& pos, float maxDist) {
+    const std::vector<glm::vec2>& curvePoints = model.getCurvePoints();
+    const std::vector<uint32_t>& curveOffsets = model.getCurveOffsets();
+    int closestLineIdx = -1;
+    float closestDistSq = maxDist * maxDist;
+    for (int lineIdx = 0; lineIdx < model.getNumLines(); lineIdx++) {
+        for (uint32_t pointIdx = curveOffsets[lineIdx]; pointIdx + 1 < curveOffsets[lineIdx + 1]; pointIdx++) {
+            // Same arithmetic as the index, so ties are exact.
+            const glm::vec2& p0 = curvePoints[pointIdx];
+            glm::vec2 d = curvePoints[pointIdx + 1] - p0;
+            glm::vec2 q = pos - p0;
+            float lengthSq = d.x * d.x + d.y * d.y;
+            float t = lengthSq > 0.0f ? std::clamp((q.x * d.x + q.y * d.y) / lengthSq, 0.0f, 1.0f) : 0.0f;
+            glm::vec2 diff = q - t * d;
+            float distSq = diff.x * diff.x + diff.y * diff.y;
+            if (distSq < closestDistSq || (distSq == closestDistSq && closestLineIdx < 0)) {
+                closestDistSq = distSq;
+                closestLineIdx = lineIdx;
+            }
+        }
+    }
+    return closestLineIdx;
+}
+
+/**
+ * The spatial index must return the same line as a linear search, also for ties, i.e., for duplicate edges and for
+ * queries on the shared points of consecutive segments. Checked after a rebuild and after an incremental update.
+ */
+static int testSpatialIndexTies() {
+    const int numLeaves = 48;
+    std::vector<std::pair<uint32_t, uint32_t>> edgeList;
+    std::vector<float> weights;
+    buildRandomEdges(numLeaves, 600, 7, edgeList, weights);
+    // Every edge is added twice, so each curve has an identical twin.
+    edgeList.insert(edgeList.end(), edgeList.begin(), edgeList.end());
+    auto buildModel = [&](const std::vector<std::pair<uint32_t, uint32_t>>& modelEdgeList) {
+        auto model = std::make_unique<ChordDiagramModel>();
+        model->buildRadialHierarchy(numLeaves, 4);
+        model->setEdges(modelEdgeList);
+        // Fixed sample counts, so moved nodes can be patched in place and the index is updated incrementally.
+        model->setUseAdaptiveSubdivision(false);
+        model->tessellate(300.0f);
+        return model;
+    };
+
+    const float maxDist = 0.02f;
+    std::mt19937 generator(13);
+    std::uniform_real_distribution<float> positionDistribution(-1.05f, 1.05f);
+    auto checkQueries = [&](const DiagramSpatialIndex& spatialIndex, const ChordDiagramModel& model) {
+        const std::vector<glm::vec2>& curvePoints = model.getCurvePoints();
+        std::uniform_int_distribution<size_t> pointDistribution(0, curvePoints.size() - 1);
+        int numMismatches = 0, numHits = 0;
+        for (int queryIdx = 0; queryIdx < 1000; queryIdx++) {
+            glm::vec2 pos = queryIdx % 2 == 0
+                    ? curvePoints[pointDistribution(generator)]
+                    : glm::vec2(positionDistribution(generator), positionDistribution(generator));
+            int lineIdxIndexed = spatialIndex.findNearestCurve(model, pos, maxDist);
+            int lineIdxLinear = findNearestCurveLinear(model, pos, maxDist);
+            numMismatches += lineIdxIndexed != lineIdxLinear ? 1 : 0;
+            numHits += lineIdxLinear >= 0 ? 1 : 0;
+        }
+        CHECK(numMismatches == 0);
+        CHECK(numHits >= 500);
+    };
+
+    std::unique_ptr<ChordDiagramModel> model = buildModel(edgeList);
+    DiagramSpatialIndex spatialIndex;
+    spatialIndex.update(*model);
+    model->resetCurvesDirty();
+    checkQueries(spatialIndex, *model);
+
+    // Moving a few nodes re-tessellates some curves, which the index picks up in its overlay grid.
+    const uint32_t leafIdxOffset = model->getLeafIdxOffset();
+    std::vector<uint32_t> nodeIndices = { leafIdxOffset + 3u, leafIdxOffset + 17u };
+    std::vector<glm::vec2> positions = { glm::vec2(0.0f, 1.0f), glm::vec2(-0.6f, -0.8f) };
+    model->setNodePositions(nodeIndices, positions);
+    spatialIndex.update(*model);
+    CHECK(spatialIndex.getNumStaleSegments() > 0);
+    checkQueries(spatialIndex, *model);
+    spatialIndex.rebuild(*model);
+    checkQueries(spatialIndex, *model);
+
+    // A new model built the same way has the same versions and may reuse the address of the destroyed one; the index
+    // must still be rebuilt for it.
+    model.reset();
+    model = buildModel(edgeList);
+    DiagramSpatialIndex spatialIndexReused;
+    spatialIndexReused.update(*model);
+    model.reset();
+    std::reverse(edgeList.begin(), edgeList.end());
+    model = buildModel(edgeList);
+    spatialIndexReused.update(*model);
+    checkQueries(spatialIndexReused, *model);
+    return 0;
+}
+
+/**
+ * The SIMD B-spline kernels selected with @see ChordDiagramModel::setSimdLevel must produce the same curves as the
+ * scalar code up to rounding for all spline orders, with uniform and adaptive subdivision.
+ */
+static int testBSplineSimd() {
+    std::vector<SimdLevel> simdLevels;
+    for (SimdLevel simdLevel : { SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512, SimdLevel::NEON }) {
+        if (getIsSimdLevelSupported(simdLevel)) {
+            simdLevels.push_back(simdLevel);
+        }
+    }
+    if (simdLevels.empty()) {
+        std::cerr << "No SIMD B-spline kernel is supported by this build and CPU." << std::endl;
+        return TEST_SKIPPED;
+    }
+
+    const int numLeaves = 60;
+    const float radiusPx = 300.0f;
+    std::vector<std::pair<uint32_t, uint32_t>> edgeList;
+    std::vector<float> weights;
+    buildRandomEdges(numLeaves, 2000, 23, edgeList, weights);
+    auto buildModel = [&](SimdLevel simdLevel, int splineOrder, bool useAdaptiveSubdivision) {
+        auto model = std::make_unique<ChordDiagramModel>();
+        model->buildRadialHierarchy(numLeaves, 4);
+        model->setSimdLevel(simdLevel);
+        model->setSplineOrder(splineOrder);
+        model->setUseAdaptiveSubdivision(useAdaptiveSubdivision);
+        model->setEdges(edgeList, weights);
+        model->tessellate(radiusPx);
+        return model;
+    };
+    for (int splineOrder = 2; splineOrder <= 5; splineOrder++) {
+        for (bool useAdaptiveSubdivision : { false, true }) {
+            auto modelScalar = buildModel(SimdLevel::SCALAR, splineOrder, useAdaptiveSubdivision);
+            for (SimdLevel simdLevel : simdLevels) {
+                auto model = buildModel(simdLevel, splineOrder, useAdaptiveSubdivision);
+                CHECK(model->getCurveOffsets() == modelScalar->getCurveOffsets());
+                int numMismatches = countMismatchingLines(*model, *modelScalar, 1e-5f);
+                if (numMismatches != 0) {
+                    std::cerr << SIMD_LEVEL_NAMES[int(simdLevel)] << ", order " << splineOrder << ", adaptive "
+                              << useAdaptiveSubdivision << ": " << numMismatches << " lines differ." << std::endl;
+                }
+                CHECK(numMismatches == 0);
+            }
+        }
+    }
+    return 0;
+}
+
+/// The SIMD coverage and blend kernels of the CPU rasterizer must produce the same image as the scalar code.
+static int testRasterSimd() {
+    std::vector<SimdLevel> simdLevels;
+    for (SimdLevel simdLevel : { SimdLevel::AVX2, SimdLevel::AVX512, SimdLevel::NEON }) {
+        RasterizerCpu rasterizer;
+        rasterizer.setSimdLevel(simdLevel);
+        if (rasterizer.getSimdLevel() == simdLevel) {
+            simdLevels.push_back(simdLevel);
+        }
+    }
+    if (simdLevels.empty()) {
+        std::cerr << "No SIMD raster kernel is supported by this build and CPU." << std::endl;
+        return TEST_SKIPPED;
+    }
+
+    const int numLeaves = 60;
+    std::vector<std::pair<uint32_t, uint32_t>> edgeList;
+    std::vector<float> weights;
+    buildRandomEdges(numLeaves, 3000, 5, edgeList, weights);
+    ChordDiagramModel model;
+    model.buildRadialHierarchy(numLeaves, 4);
+    model.setEdges(edgeList, weights);
+    model.tessellate(200.0f);
+
+    // Odd sizes, so the image ends inside of tiles and kernel vectors; the coordinates are scaled as for HiDPI.
+    const int width = 517, height = 443;
+    const float scale = 1.25f;
+    const glm::vec2 center(0.5f * float(width) / scale, 0.5f * float(height) / scale);
+    const float radius = 160.0f;
+    const std::vector<glm::vec2>& normalizedPoints = model.getCurvePoints();
+    const std::vector<uint32_t>& curveOffsets = model.getCurveOffsets();
+    std::vector<glm::vec2> points(normalizedPoints.size());
+    for (size_t pointIdx = 0; pointIdx < points.size(); pointIdx++) {
+        points[pointIdx] = center + normalizedPoints[pointIdx] * radius;
+    }
+    auto renderImage = [&](SimdLevel simdLevel) {
+        RasterizerCpu rasterizer;
+        rasterizer.setSimdLevel(simdLevel);
+        rasterizer.beginFrame(width, height, scale, glm::vec4(0.1f, 0.1f, 0.1f, 0.8f));
+        rasterizer.drawRoundedRect(
+                glm::vec2(3.5f), glm::vec2(float(width) / scale - 3.5f, float(height) / scale - 3.5f), 20.0f,
+                glm::vec4(0.2f, 0.2f, 0.25f, 0.9f), glm::vec4(0.8f, 0.8f, 0.8f, 1.0f), 1.5f);
+        for (int lineIdx = 0; lineIdx < model.getNumLines(); lineIdx++) {
+            // Thin strokes reduce the alpha instead of the width, and wide ones cover several pixels per row.
+            float strokeWidth = lineIdx % 7 == 0 ? 2.75f : (lineIdx % 3 == 0 ? 0.4f : 1.0f);
+            rasterizer.strokePolyline(
+                    points.data() + curveOffsets[lineIdx], curveOffsets[lineIdx + 1] - curveOffsets[lineIdx],
+                    strokeWidth, glm::vec4(0.4f, 1.0f, 0.4f, 0.05f + 0.5f * model.getEdges()[lineIdx].weight));
+        }
+        for (int leafIdx = 0; leafIdx < numLeaves; leafIdx++) {
+            float angle = 2.0f * 3.14159265f * float(leafIdx) / float(numLeaves);
+            rasterizer.fillCircle(
+                    center + glm::vec2(std::cos(angle), std::sin(angle)) * radius, 2.3f,
+                    glm::vec4(0.9f, 0.6f, 0.2f, 1.0f));
+        }
+        std::vector<uint8_t> image(size_t(width) * size_t(height) * 4);
+        rasterizer.render(image.data());
+        return image;
+    };
+
+    std::vector<uint8_t> imageScalar = renderImage(SimdLevel::SCALAR);
+    for (SimdLevel simdLevel : simdLevels) {
+        std::vector<uint8_t> imageSimd = renderImage(simdLevel);
+        size_t numDifferentBytes = 0;
+        for (size_t byteIdx = 0; byteIdx < imageScalar.size(); byteIdx++) {
+            numDifferentBytes += imageScalar[byteIdx] != imageSimd[byteIdx] ? 1 : 0;
+        }
+        if (numDifferentBytes != 0) {
+            std::cerr << SIMD_LEVEL_NAMES[int(simdLevel)] << ": " << numDifferentBytes << " bytes differ." << std::endl;
+        }
+        CHECK(numDifferentBytes == 0);
+    }
+    return 0;
+}
+
+/// Invalid hierarchies passed to setNodes are rejected before the model is changed.
+static int testHierarchyValidation() {
+    ChordDiagramModel model;
+    model.buildRadialHierarchy(16, 4);
+    model.setEdges({ { 0u, 5u }, { 3u, 9u } });
+    const std::vector<HEBNode> validNodes = model.getNodes();
+    const uint32_t validLeafIdxOffset = model.getLeafIdxOffset();
+    auto getIsRejected = [&](std::vector<HEBNode> nodes, uint32_t leafIdxOffset) {
+        bool hasThrown = false;
+        try {
+            model.setNodes(std::move(nodes), leafIdxOffset);
+        } catch (const std::runtime_error&) {
+            hasThrown = true;
+        }
+        return hasThrown && model.getNumLines() == 2 && model.getLeafIdxOffset() == validLeafIdxOffset
+                && model.getNodes().size() == validNodes.size();
+    };
+
+    // Two chains of depth chainDepth from the root, whose leaves are connected via the root.
+    auto buildTwoChains = [](uint32_t chainDepth, std::vector<HEBNode>& nodes, uint32_t& leafIdxOffset) {
+        nodes.assign(2 * chainDepth + 1, HEBNode());
+        leafIdxOffset = 2 * chainDepth - 1;
+        for (uint32_t chainIdx = 0; chainIdx < 2; chainIdx++) {
+            uint32_t parentIdx = 0;
+            for (uint32_t depth = 1; depth <= chainDepth; depth++) {
+                uint32_t nodeIdx = depth < chainDepth ? chainIdx * (chainDepth - 1) + depth : leafIdxOffset + chainIdx;
+                nodes[nodeIdx].parentIdx = parentIdx;
+                nodes[nodeIdx].depth = depth;
+                parentIdx = nodeIdx;
+            }
+        }
+    };
+    std::vector<HEBNode> deepNodes;
+    uint32_t deepLeafIdxOffset = 0;
+    buildTwoChains(40, deepNodes, deepLeafIdxOffset);
+    CHECK(getIsRejected(deepNodes, deepLeafIdxOffset));
+
+    std::vector<HEBNode> nodes = validNodes;
+    nodes.back().parentIdx = uint32_t(nodes.size());
+    CHECK(getIsRejected(nodes, validLeafIdxOffset));
+    nodes = validNodes;
+    nodes[1].parentIdx = 2;
+    CHECK(getIsRejected(nodes, validLeafIdxOffset));
+    nodes = validNodes;
+    nodes.back().depth++;
+    CHECK(getIsRejected(nodes, validLeafIdxOffset));
+    nodes = validNodes;
+    nodes[0].parentIdx = 1;
+    CHECK(getIsRejected(nodes, validLeafIdxOffset));
+    CHECK(getIsRejected(validNodes, uint32_t(validNodes.size() + 1)));
+
+    // The deepest hierarchy whose paths still fit is accepted.
+    const auto maxChainDepth = uint32_t(HEB_MAX_CONTROL_POINTS - 1) / 2;
+    buildTwoChains(maxChainDepth, deepNodes, deepLeafIdxOffset);
+    model.setNodes(deepNodes, deepLeafIdxOffset);
+    model.setEdges({ { 0u, 1u } });
+    model.tessellate(300.0f);
+    CHECK(model.getEdges().front().numControlPoints == uint32_t(HEB_MAX_CONTROL_POINTS) - 1);
+    return 0;
+}
+
+static bool getIsSplitEqual(
+        const std::string& row, char separator, int maxNumFields, const std::vector<std::string>& expectedFields) {
+    std::vector<std::string_view> fields(maxNumFields);
+    int numFields = splitCsvRow(row, separator, fields.data(), maxNumFields);
+    if (numFields != int(expectedFields.size())) {
+        return false;
+    }
+    for (int fieldIdx = 0; fieldIdx < numFields; fieldIdx++) {
+        if (fields[fieldIdx] != expectedFields[fieldIdx]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool getIsWeightParsedAs(const char* field, float expectedWeight) {
+    float weight = -1.0f;
+    return parseCsvWeight(field, weight) && std::memcmp(&weight, &expectedWeight, sizeof(float)) == 0;
+}
+
+static bool getIsWeightRejected(const char* field) {
+    float weight = 0.0f;
+    return !parseCsvWeight(field, weight);
+}
+
+static int testCsvParsing() {
+    CHECK(getIsSplitEqual("a,b,c", ',', 8, { "a", "b", "c" }));
+    CHECK(getIsSplitEqual("  a , b\t,c  ", ',', 8, { "a", "b", "c" }));
+    CHECK(getIsSplitEqual("a,,c,", ',', 8, { "a", "", "c", "" }));
+    CHECK(getIsSplitEqual("", ',', 8, { "" }));
+    CHECK(getIsSplitEqual("a,b,c,d", ',', 2, { "a", "b" }));
+    CHECK(getIsSplitEqual(" \"x, y\" ,z", ',', 8, { "x, y", "z" }));
+    CHECK(getIsSplitEqual("\"\",b", ',', 8, { "", "b" }));
+    std::string_view fields[8];
+    CHECK(splitCsvRow("a,\"unterminated", ',', fields, 8) == -1);
+    // Tabs are not trimmed if they are the separator.
+    CHECK(getIsSplitEqual("a\t\tb c \t", '\t', 8, { "a", "", "b c", "" }));
+    CHECK(getIsSplitEqual("a;b,c", ';', 8, { "a", "b,c" }));
+
+    CHECK(getIsWeightParsedAs("0.25", 0.25f));
+    CHECK(getIsWeightParsedAs("1", 1.0f));
+    CHECK(getIsWeightParsedAs("+2.", 2.0f));
+    CHECK(getIsWeightParsedAs(".5", 0.5f));
+    CHECK(getIsWeightParsedAs("-1.5", -1.5f));
+    CHECK(getIsWeightParsedAs("0.1", 0.1f));
+    CHECK(getIsWeightParsedAs("1e-3", 1e-3f));
+    CHECK(getIsWeightParsedAs("2.5E2", 250.0f));
+    CHECK(getIsWeightParsedAs("12345678901234567890", 12345678901234567890.0f));
+    CHECK(getIsWeightRejected(""));
+    CHECK(getIsWeightRejected("-"));
+    CHECK(getIsWeightRejected("."));
+    CHECK(getIsWeightRejected("abc"));
+    CHECK(getIsWeightRejected("1.2.3"));
+    CHECK(getIsWeightRejected("1,5"));
+    CHECK(getIsWeightRejected("0.5 "));
+    CHECK(getIsWeightRejected("nan"));
+    CHECK(getIsWeightRejected("inf"));
+    CHECK(getIsWeightRejected("1e99"));
+
+    // The fast path for plain decimals must round exactly like strtof.
+    std::mt19937 generator(11);
+    std::uniform_int_distribution<uint64_t> mantissaDistribution(0, 999999999999999ull);
+    std::uniform_int_distribution<int> numDigitsDistribution(1, 15);
+    int numMismatches = 0;
+    for (int sampleIdx = 0; sampleIdx < 200000; sampleIdx++) {
+        std::string field = std::to_string(mantissaDistribution(generator));
+        int numFractionDigits = std::min(numDigitsDistribution(generator), int(field.size()));
+        field.insert(field.size() - size_t(numFractionDigits), ".");
+        float weight = 0.0f;
+        float expectedWeight = std::strtof(field.c_str(), nullptr);
+        if (!parseCsvWeight(field, weight) || std::memcmp(&weight, &expectedWeight, sizeof(float)) != 0) {
+            if (numMismatches++ == 0) {
+                std::cerr << "First mismatch: " << field << std::endl;
+            }
+        }
+    }
+    CHECK(numMismatches == 0);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    struct TestCase {
+        const char* name;
+        int (*function)();
+    };
+    const TestCase testCases[] = {
+            { "edge_records", testEdgeRecords },
+            { "incremental_updates", testIncrementalUpdates },
+            { "bspline_simd", testBSplineSimd },
+            { "raster_simd", testRasterSimd },
+            { "spatial_index_ties", testSpatialIndexTies },
+            { "hierarchy_validation", testHierarchyValidation },
+            { "csv_parsing", testCsvParsing },
+    };
+    int numTestsRun = 0, numTestsFailed = 0;
+    for (const TestCase& testCase : testCases) {
+        if (argc > 1 && std::strcmp(argv[1], testCase.name) != 0) {
+            continue;
+        }
+        numFailedChecks = 0;
+        int result;
+        try {
+            result = testCase.function();
+        } catch (const std::exception& exception) {
+            std::cerr << "Unexpected exception: " << exception.what() << std::endl;
+            result = 1;
+        }
+        if (result == 0 && numFailedChecks > 0) {
+            result = 1;
+        }
+        std::cerr << testCase.name << ": " << (result == 0 ? "passed" : result == TEST_SKIPPED ? "skipped" : "failed")
+                  << std::endl;
+        numTestsRun++;
+        if (result != 0 && result != TEST_SKIPPED) {
+            numTestsFailed++;
+        }
+        if (argc > 1) {
+            return result;
+        }
+    }
+    if (numTestsRun == 0) {
+        std::cerr << "Unknown test: " << argv[1] << std::endl;
+        return 1;
+    }
+    return numTestsFailed == 0 ? 0 : 1;
+}